@@ -1,4 +1,5 @@
 #include "Animation.h"
+#include "JobSystem.h"
 
 void SetAnimationState(SAnimationParameters& AnimationParams,
 	SVector& BitmapSource, SVector& BitmapOffsetLeft, SVector& BitmapOffsetRight)
@@ -53,3 +54,32 @@ void InitAnimationFirstFrame(SAnimationParameters& AnimationParams,
 {
 	UpdateAnimation(AnimationParams, BitmapSource, BitmapOffsetLeft, BitmapOffsetRight, 1);
 }
+
+struct SAnimationBatch
+{
+	SAnimationUpdate* Animations = nullptr;
+	float DeltaTime = 0;
+};
+
+static void UpdateAnimationBatch(void* Context, int Begin, int End)
+{
+	SAnimationBatch* Batch = (SAnimationBatch*)Context;
+	for (int i = Begin; i < End; ++i)
+	{
+		SAnimationUpdate& Animation = Batch->Animations[i];
+		UpdateAnimation(
+			*Animation.AnimationParams,
+			*Animation.BitmapSource,
+			*Animation.BitmapOffsetLeft,
+			*Animation.BitmapOffsetRight,
+			Batch->DeltaTime);
+	}
+}
+
+void UpdateAnimations(SAnimationUpdate* Animations, int NumAnimations, float DeltaTime)
+{
+	SAnimationBatch Batch;
+	Batch.Animations = Animations;
+	Batch.DeltaTime = DeltaTime;
+	ParallelFor(NumAnimations, ANIMATION_UPDATE_BATCHSIZE, UpdateAnimationBatch, &Batch);
+}
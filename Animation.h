@@ -3,6 +3,9 @@
 #include "VoodooEngineDLLExport.h"
 #include "SVector.h"
 
+// Animation of a single bitmap updated by game code
+// (see "SpriteAnimator.h" for animation clips loaded from data and updated by the engine)
+
 // Contains animation info such as frame size/total frames and animation speed/state info 
 struct SAnimationParameters
 {
@@ -30,6 +33,20 @@ extern "C" VOODOOENGINE_API void UpdateAnimation(
 	SVector& BitmapOffsetRight,
 	float DeltaTime);
 
+// Animation and bitmap source of one animated bitmap (used to update many animations at once)
+struct SAnimationUpdate
+{
+	SAnimationParameters* AnimationParams = nullptr;
+	SVector* BitmapSource = nullptr;
+	SVector* BitmapOffsetLeft = nullptr;
+	SVector* BitmapOffsetRight = nullptr;
+};
+
+// Update many animations at once, split in batches of "ANIMATION_UPDATE_BATCHSIZE" run on the job system
+// (every animation only writes its own parameters, so the result is the same as updating them one by one)
+#define ANIMATION_UPDATE_BATCHSIZE 256
+extern "C" VOODOOENGINE_API void UpdateAnimations(SAnimationUpdate* Animations, int NumAnimations, float DeltaTime);
+
 // Setup the first frame of animation, 
 // to use it, call this function inside "OnGameObjectSetupCompleted" virtual function in any gameobject 
 // (used for when an object is created before activation of update component, 
@@ -1,105 +1,26 @@
 #include "BitmapComponent.h"
-#include <wincodec.h>
+#include "Profiler.h"
+#include "Metrics.h"
 
-// Create a converter from WIC bitmap to Direct2D bitmap,
-// will determine here if bitmap should be flipped or not
-IWICFormatConverter* SetupWicConverter(
-	IWICFormatConverter* WicConverter,
-	IWICImagingFactory* WicFactory, 
-	IWICBitmapFrameDecode* DecoderFrame,
-	bool FlipBitmap)
+PlatformTexture* SetupBitmap(
+	PlatformTexture* BitmapToSetup, const wchar_t* FileName, PlatformRenderTarget* Renderer)
 {
-	WicFactory->CreateFormatConverter(&WicConverter);
-	IWICBitmapSource* Source = nullptr;
-	if (!FlipBitmap)
-	{
-		Source = DecoderFrame;
-	}
-	IWICBitmapFlipRotator* ImageFlip = nullptr;
-	if (FlipBitmap)
-	{
-		WicFactory->CreateBitmapFlipRotator(&ImageFlip);
-		ImageFlip->Initialize(DecoderFrame, WICBitmapTransformFlipHorizontal);
-		Source = ImageFlip;
-	}
+	VOODOO_PROFILE_SCOPE("LoadAsset");
 
-	WicConverter->Initialize(
-		Source,
-		GUID_WICPixelFormat32bppPBGRA,
-		WICBitmapDitherTypeNone,
-		nullptr,
-		0,
-		WICBitmapPaletteTypeCustom);
-
-	if (ImageFlip)
-	{
-		ImageFlip->Release();
-	}
-
-	return WicConverter;
-}
-
-ID2D1Bitmap* SetupBitmap(
-	ID2D1Bitmap* BitmapToSetup, const wchar_t* FileName, ID2D1HwndRenderTarget* Renderer, bool FlipBitmap)
-{
 	// If bitmap is already created, 
 	// then release previous bitmap to avoid memory leak before making it nullptr
 	if (BitmapToSetup)
 	{
-		BitmapToSetup->Release();
+		ReleasePlatformTexture(BitmapToSetup);
 		BitmapToSetup = nullptr;
+		AddMetricGauge(GetEngineMetrics()->TexturesResident, -1);
 	}
 
-	HRESULT Result;
-
-	// Create Wic factory
-	IWICImagingFactory* WicFactory = nullptr;
-	Result = CoCreateInstance(
-		CLSID_WICImagingFactory,
-		nullptr,
-		CLSCTX_INPROC_SERVER,
-		IID_PPV_ARGS(&WicFactory));
-
-	// Create decoder
-	IWICBitmapDecoder* Decoder = nullptr;
-	Result = WicFactory->CreateDecoderFromFilename(
-		FileName,
-		nullptr,
-		GENERIC_READ,
-		WICDecodeMetadataCacheOnDemand,
-		&Decoder);
-
-	// Failed to find file 
-	if (!Decoder)
-	{
-		return nullptr;
-	}
-
-	// Create decoder frame
-	IWICBitmapFrameDecode* DecoderFrame = nullptr;
-	Result = Decoder->GetFrame(0, &DecoderFrame);
- 
-	IWICFormatConverter* WicConverter = nullptr;
-	WicConverter = SetupWicConverter(WicConverter, WicFactory, DecoderFrame, FlipBitmap);
-
-	// The final bitmap will be returned
-	Renderer->CreateBitmapFromWicBitmap(WicConverter, nullptr, &BitmapToSetup);
-
-	if (WicFactory)
-	{
-		WicFactory->Release();
-	}
-	if (Decoder)
-	{
-		Decoder->Release();
-	}
-	if (DecoderFrame)
-	{
-		DecoderFrame->Release();
-	}
-	if (WicConverter)
+	// Returns nullptr if there is no renderer (headless mode) or if the file is not found
+	BitmapToSetup = LoadPlatformTexture(FileName, Renderer);
+	if (BitmapToSetup)
 	{
-		WicConverter->Release();
+		AddMetricGauge(GetEngineMetrics()->TexturesResident, 1);
 	}
 
 	return BitmapToSetup;
@@ -107,21 +28,19 @@ ID2D1Bitmap* SetupBitmap(
 
 void SetupBitmapComponent(
 	BitmapComponent* BitmapComponentToSetup,
-	ID2D1Bitmap* TextureAtlasBitmap,
+	PlatformTexture* TextureAtlasBitmap,
 	SVector TextureAtlasWidthHeight,
 	int TextureAtlasOffsetMultiplierHeight,
 	bool UseEntireTextureAtlasAsBitmapSource)
 {
 	BitmapComponentToSetup->Bitmap = TextureAtlasBitmap;
 
-	if (UseEntireTextureAtlasAsBitmapSource)
+	if (UseEntireTextureAtlasAsBitmapSource &&
+		TextureAtlasBitmap)
 	{
 		// Set the bitmap source the same size as the entire texture altas
 		// (this is used for when there is a single texture instead of multiple "slots" in the texture atlas)
-		BitmapComponentToSetup->BitmapParams.BitmapSource.X =
-			TextureAtlasBitmap->GetSize().width;
-		BitmapComponentToSetup->BitmapParams.BitmapSource.Y =
-			TextureAtlasBitmap->GetSize().height;
+		BitmapComponentToSetup->BitmapParams.BitmapSource = GetPlatformTextureSize(TextureAtlasBitmap);
 
 		// Since computer graphics start from left to right
 		// "BitmapOffsetLeft" is not set since default is at "0"
@@ -130,7 +49,7 @@ void SetupBitmapComponent(
 		BitmapComponentToSetup->BitmapParams.BitmapOffsetRight.Y =
 			BitmapComponentToSetup->BitmapParams.BitmapSource.Y;
 	}
-	else
+	else if (!UseEntireTextureAtlasAsBitmapSource)
 	{
 		// Set the bitmap source the same size as the desired texture atlas "slot" width and height
 		BitmapComponentToSetup->BitmapParams.BitmapSource.X = TextureAtlasWidthHeight.X;
@@ -1,33 +1,43 @@
 #pragma once
 
 #include "VoodooEngineDLLExport.h"
+#include "Platform.h"
+#include "EnableMasks.h"
 #include "TransformComponent.h"
 #include <string>
-#include <d2d1.h>
 
 struct SBitmapParameters
 {
 	int RenderLayer = 0;
 	float Opacity = 1;
 	bool BitmapSetToNotRender = false;
+	// Not rendered while its render layer/level is disabled (see "EnableMasks.h")
+	SEnableGroup EnableGroup;
 	SVector BitmapOffsetLeft;
 	SVector BitmapOffsetRight;
 	SVector BitmapSource;
+	// Applied when drawing, around the center of the bitmap (the texture itself is never changed)
+	bool FlipX = false;
+	bool FlipY = false;
+	// Degrees clockwise
+	float Rotation = 0;
+	SVector Scale = { 1, 1 };
 };
 
 class BitmapComponent : public TransformComponent
 {
 public:
-	ID2D1Bitmap* Bitmap = nullptr;
+	PlatformTexture* Bitmap = nullptr;
 	SBitmapParameters BitmapParams = {};
 };
 
-extern "C" VOODOOENGINE_API ID2D1Bitmap* SetupBitmap(
-	ID2D1Bitmap* BitmapToSetup, const wchar_t* FileName, ID2D1HwndRenderTarget* Renderer, bool FlipBitmap = false);
+// Flipped/rotated versions of a bitmap are drawn from the same texture (see "SBitmapParameters")
+extern "C" VOODOOENGINE_API PlatformTexture* SetupBitmap(
+	PlatformTexture* BitmapToSetup, const wchar_t* FileName, PlatformRenderTarget* Renderer);
 
 extern "C" VOODOOENGINE_API void SetupBitmapComponent(
 	BitmapComponent* BitmapComponentToSetup,
-	ID2D1Bitmap* TextureAtlasBitmap,
+	PlatformTexture* TextureAtlasBitmap,
 	SVector TextureAtlasWidthHeight = {},
 	int TextureAtlasOffsetMultiplierHeight = 1,
 	bool UseEntireTextureAtlasAsBitmapSource = true);
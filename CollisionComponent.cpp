@@ -1,4 +1,5 @@
 #include "CollisionComponent.h"
+#include "Metrics.h"
 
 bool IsCollisionDetected(CollisionComponent* Sender, CollisionComponent* Target)
 {
@@ -9,6 +10,13 @@ bool IsCollisionDetected(CollisionComponent* Sender, CollisionComponent* Target)
 		return false;
 	}
 
+	const SEnableMasks* EnableMasks = GetEnableMasks();
+	if (!IsEnableGroupEnabled(Sender->EnableGroup, EnableMasks) ||
+		!IsEnableGroupEnabled(Target->EnableGroup, EnableMasks))
+	{
+		return false;
+	}
+
 	for (int i = 0; i < Sender->CollisionTagsToIgnore.size(); ++i)
 	{
 		if (Sender->CollisionTagsToIgnore[i] == Target->CollisionTag)
@@ -46,9 +54,18 @@ void BroadcastCollision(Object* CallbackOwner, CollisionComponent* Sender, Colli
 	{
 		return;
 	}
+	const SEnableMasks* EnableMasks = GetEnableMasks();
+	if (!IsEnableGroupEnabled(Sender->EnableGroup, EnableMasks) ||
+		!IsEnableGroupEnabled(Target->EnableGroup, EnableMasks))
+	{
+		return;
+	}
 	bool Ignore = false;
+	AddMetricCounter(GetEngineMetrics()->CollidersTested);
+	AddMetricCounter(GetEngineMetrics()->AABBTests);
 	if (IsCollisionDetected(Sender, Target))
 	{
+		AddMetricCounter(GetEngineMetrics()->AABBHits);
 		for (int i = 0; i < Sender->CollisionTagsToIgnore.size(); ++i)
 		{
 			if (Target->CollisionTag == Sender->CollisionTagsToIgnore[i])
@@ -3,6 +3,7 @@
 #include "VoodooEngineDLLExport.h"
 #include "TransformComponent.h"
 #include "Object.h"
+#include "EnableMasks.h"
 #include "SColor.h"
 #include <vector>
 
@@ -23,6 +24,8 @@ class CollisionComponent : public TransformComponent
 public:
 	ECollisionType CollisionType = ECollisionType::Collision_Block;
 	bool NoCollision = false;
+	// No collision while its render layer/level is disabled (see "EnableMasks.h")
+	SEnableGroup EnableGroup;
 	bool IsOverlapped = false;
 	bool RenderCollisionRect = false;
 	bool DrawFilledRectangle = false;
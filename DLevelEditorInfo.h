@@ -18,6 +18,8 @@
 #define BUTTON_LOC_Y_OPENLEVEL 20
 #define BUTTON_LOC_X_SAVELEVEL 180
 #define BUTTON_LOC_Y_SAVELEVEL 20
+#define TEXT_LOC_X_LEVELSAVE_STATUS 340
+#define TEXT_LOC_Y_LEVELSAVE_STATUS 30
 #define BUTTON_LOC_X_PLAYLEVEL 890
 #define BUTTON_LOC_Y_PLAYLEVEL 20
 #define BUTTON_LOC_X_PREVIOUS 1615
@@ -0,0 +1,203 @@
+#include "EditorPicking.h"
+#include "VoodooEngine.h"
+#include <algorithm>
+#include <cmath>
+
+static int GetPickingCell(float Coordinate)
+{
+	return (int)std::floor(Coordinate / EDITORPICKING_CELL_SIZE);
+}
+
+static uint64_t GetPickingCellKey(int CellX, int CellY)
+{
+	return ((uint64_t)(uint32_t)CellX << 32) | (uint32_t)CellY;
+}
+
+static void AddEntryToCells(SEditorPicking* Picking, int EntryIndex)
+{
+	SEditorPickingEntry& Entry = Picking->Entries[EntryIndex];
+	CollisionComponent* Collision = Entry.Object->DefaultGameObjectCollision;
+
+	SVector Location = GetTransformWorldLocation(Collision);
+	Entry.MinCellX = GetPickingCell(Location.X);
+	Entry.MinCellY = GetPickingCell(Location.Y);
+	Entry.MaxCellX = GetPickingCell(Location.X + Collision->CollisionRect.X);
+	Entry.MaxCellY = GetPickingCell(Location.Y + Collision->CollisionRect.Y);
+
+	for (int CellY = Entry.MinCellY; CellY <= Entry.MaxCellY; ++CellY)
+	{
+		for (int CellX = Entry.MinCellX; CellX <= Entry.MaxCellX; ++CellX)
+		{
+			Picking->Cells[GetPickingCellKey(CellX, CellY)].push_back(EntryIndex);
+		}
+	}
+}
+
+static void RemoveEntryFromCells(SEditorPicking* Picking, int EntryIndex)
+{
+	SEditorPickingEntry& Entry = Picking->Entries[EntryIndex];
+	for (int CellY = Entry.MinCellY; CellY <= Entry.MaxCellY; ++CellY)
+	{
+		for (int CellX = Entry.MinCellX; CellX <= Entry.MaxCellX; ++CellX)
+		{
+			auto Iterator = Picking->Cells.find(GetPickingCellKey(CellX, CellY));
+			if (Iterator == Picking->Cells.end())
+			{
+				continue;
+			}
+
+			std::vector<int>& Cell = Iterator->second;
+			Cell.erase(std::remove(Cell.begin(), Cell.end(), EntryIndex), Cell.end());
+		}
+	}
+}
+
+static void RebuildEditorPicking(SEditorPicking* Picking, const std::vector<GameObject*>& GameObjects)
+{
+	VOODOO_PROFILE_SCOPE("RebuildEditorPicking");
+
+	Picking->Entries.clear();
+	Picking->EntryIndices.clear();
+	// Cell lists are cleared instead of removed so their memory is reused
+	for (auto& Cell : Picking->Cells)
+	{
+		Cell.second.clear();
+	}
+
+	for (int i = 0; i < GameObjects.size(); ++i)
+	{
+		// Only game objects with collision can be picked
+		if (!GameObjects[i]->DefaultGameObjectCollision)
+		{
+			continue;
+		}
+
+		SEditorPickingEntry Entry;
+		Entry.Object = GameObjects[i];
+		Entry.RenderLayer = GameObjects[i]->GameObjectBitmap.BitmapParams.RenderLayer;
+		Entry.DrawOrder = i;
+		Entry.LastQuery = Picking->QueryCounter;
+
+		Picking->EntryIndices[GameObjects[i]] = (int)Picking->Entries.size();
+		Picking->Entries.push_back(Entry);
+		AddEntryToCells(Picking, (int)Picking->Entries.size() - 1);
+	}
+
+	Picking->Dirty = false;
+	Picking->HoverCached = false;
+}
+
+void MarkEditorPickingDirty(SEditorPicking* Picking)
+{
+	Picking->Dirty = true;
+	Picking->HoverCached = false;
+}
+
+void MoveEditorPickingObject(SEditorPicking* Picking, GameObject* MovedObject)
+{
+	Picking->HoverCached = false;
+	if (Picking->Dirty)
+	{
+		return;
+	}
+
+	auto Iterator = Picking->EntryIndices.find(MovedObject);
+	if (Iterator == Picking->EntryIndices.end())
+	{
+		return;
+	}
+
+	RemoveEntryFromCells(Picking, Iterator->second);
+	AddEntryToCells(Picking, Iterator->second);
+}
+
+void QueryEditorPickingObjects(SEditorPicking* Picking,
+	const std::vector<GameObject*>& GameObjects, CollisionComponent* Sender, FrameVector<GameObject*>& FoundObjects)
+{
+	FoundObjects.clear();
+
+	// Collision of game objects moved this frame are tested at their new location
+	UpdateTransforms();
+
+	if (Picking->Dirty)
+	{
+		RebuildEditorPicking(Picking, GameObjects);
+	}
+
+	Picking->QueryCounter++;
+
+	FrameVector<int> FoundEntries;
+	int MinCellX = GetPickingCell(Sender->ComponentLocation.X);
+	int MinCellY = GetPickingCell(Sender->ComponentLocation.Y);
+	int MaxCellX = GetPickingCell(Sender->ComponentLocation.X + Sender->CollisionRect.X);
+	int MaxCellY = GetPickingCell(Sender->ComponentLocation.Y + Sender->CollisionRect.Y);
+	for (int CellY = MinCellY; CellY <= MaxCellY; ++CellY)
+	{
+		for (int CellX = MinCellX; CellX <= MaxCellX; ++CellX)
+		{
+			auto Iterator = Picking->Cells.find(GetPickingCellKey(CellX, CellY));
+			if (Iterator == Picking->Cells.end())
+			{
+				continue;
+			}
+
+			const std::vector<int>& Cell = Iterator->second;
+			for (int i = 0; i < Cell.size(); ++i)
+			{
+				SEditorPickingEntry& Entry = Picking->Entries[Cell[i]];
+				if (Entry.LastQuery == Picking->QueryCounter)
+				{
+					continue;
+				}
+				Entry.LastQuery = Picking->QueryCounter;
+
+				if (IsCollisionDetected(Sender, Entry.Object->DefaultGameObjectCollision))
+				{
+					FoundEntries.push_back(Cell[i]);
+				}
+			}
+		}
+	}
+
+	std::sort(FoundEntries.begin(), FoundEntries.end(), [Picking](int A, int B)
+	{
+		const SEditorPickingEntry& EntryA = Picking->Entries[A];
+		const SEditorPickingEntry& EntryB = Picking->Entries[B];
+		if (EntryA.RenderLayer != EntryB.RenderLayer)
+		{
+			return EntryA.RenderLayer > EntryB.RenderLayer;
+		}
+
+		return EntryA.DrawOrder > EntryB.DrawOrder;
+	});
+
+	FoundObjects.reserve(FoundEntries.size());
+	for (int i = 0; i < FoundEntries.size(); ++i)
+	{
+		FoundObjects.push_back(Picking->Entries[FoundEntries[i]].Object);
+	}
+}
+
+GameObject* PickEditorObject(SEditorPicking* Picking,
+	const std::vector<GameObject*>& GameObjects, CollisionComponent* Sender)
+{
+	if (Picking->HoverCached &&
+		!Picking->Dirty &&
+		Picking->HoverLocation.X == Sender->ComponentLocation.X &&
+		Picking->HoverLocation.Y == Sender->ComponentLocation.Y &&
+		Picking->HoverRect.X == Sender->CollisionRect.X &&
+		Picking->HoverRect.Y == Sender->CollisionRect.Y)
+	{
+		return Picking->HoverObject;
+	}
+
+	FrameVector<GameObject*> FoundObjects;
+	QueryEditorPickingObjects(Picking, GameObjects, Sender, FoundObjects);
+
+	Picking->HoverCached = true;
+	Picking->HoverLocation = Sender->ComponentLocation;
+	Picking->HoverRect = Sender->CollisionRect;
+	Picking->HoverObject = FoundObjects.empty() ? nullptr : FoundObjects[0];
+
+	return Picking->HoverObject;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "CollisionComponent.h"
+#include "FrameAllocator.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Editor picking
+//---------------------
+// Spatial index of the default collision of all game objects, used by the level editor to find the objects
+// under the mouse (or within a selection rect) without testing every game object.
+// Game objects are stored in a uniform grid, a query only tests the objects of the cells it overlaps
+// (same test as "IsCollisionDetected"), found objects are sorted top most first
+// (highest render layer first, then the object drawn last within the render layer).
+//
+// The index is rebuilt by the next query after it has been marked dirty (game objects created/deleted etc.),
+// a game object moved in the editor is updated on its own with "MoveEditorPickingObject".
+// The top most object under the mouse is cached until the mouse collider moves or the index changes
+//---------------------
+
+#define EDITORPICKING_CELL_SIZE 256
+
+class GameObject;
+
+struct SEditorPickingEntry
+{
+	GameObject* Object = nullptr;
+	int RenderLayer = 0;
+	// Index in the stored game objects (objects stored later are drawn on top within the same render layer)
+	int DrawOrder = 0;
+	// Cells the entry is stored in (min/max inclusive)
+	int MinCellX = 0;
+	int MinCellY = 0;
+	int MaxCellX = 0;
+	int MaxCellY = 0;
+	// Last query that tested the entry (an entry stored in multiple cells is only tested once per query)
+	uint32_t LastQuery = 0;
+};
+
+struct SEditorPicking
+{
+	bool Dirty = true;
+	std::vector<SEditorPickingEntry> Entries;
+	std::unordered_map<GameObject*, int> EntryIndices;
+	// Entry indices of every cell (key is the cell X/Y packed in 64 bits)
+	std::unordered_map<uint64_t, std::vector<int>> Cells;
+	uint32_t QueryCounter = 0;
+
+	// Top most object under the mouse collider the last time it was picked
+	bool HoverCached = false;
+	SVector HoverLocation;
+	SVector HoverRect;
+	GameObject* HoverObject = nullptr;
+};
+
+// Rebuild the index by the next query (call when game objects are created/deleted or their collision changes)
+extern "C" VOODOOENGINE_API void MarkEditorPickingDirty(SEditorPicking* Picking);
+// Update the cells of a single game object after it has been moved
+extern "C" VOODOOENGINE_API void MoveEditorPickingObject(SEditorPicking* Picking, GameObject* MovedObject);
+
+// Find all game objects colliding with "Sender" (e.g. mouse collider or a selection rect), top most first
+extern "C" VOODOOENGINE_API void QueryEditorPickingObjects(SEditorPicking* Picking,
+	const std::vector<GameObject*>& GameObjects, CollisionComponent* Sender, FrameVector<GameObject*>& FoundObjects);
+// Get the top most game object colliding with "Sender", nullptr if none (cached until the sender moves)
+extern "C" VOODOOENGINE_API GameObject* PickEditorObject(SEditorPicking* Picking,
+	const std::vector<GameObject*>& GameObjects, CollisionComponent* Sender);
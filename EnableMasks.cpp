@@ -0,0 +1,60 @@
+#include "EnableMasks.h"
+
+static SEnableMasks EnableMasks;
+
+SEnableMasks* GetEnableMasks()
+{
+	return &EnableMasks;
+}
+
+void SetRenderLayerEnabled(int RenderLayer, bool Enable)
+{
+	if (RenderLayer < 0 ||
+		RenderLayer >= ENABLEMASKS_MAXNUM_RENDER_LAYERS)
+	{
+		return;
+	}
+
+	if (Enable)
+	{
+		EnableMasks.EnabledRenderLayers |= 1u << RenderLayer;
+	}
+	else
+	{
+		EnableMasks.EnabledRenderLayers &= ~(1u << RenderLayer);
+	}
+}
+
+bool IsRenderLayerEnabled(int RenderLayer)
+{
+	if (RenderLayer < 0 ||
+		RenderLayer >= ENABLEMASKS_MAXNUM_RENDER_LAYERS)
+	{
+		return true;
+	}
+
+	return (EnableMasks.EnabledRenderLayers >> RenderLayer) & 1;
+}
+
+void SetLevelSlotEnabled(int LevelSlot, bool Enable)
+{
+	if (LevelSlot <= 0 ||
+		LevelSlot >= ENABLEMASKS_MAXNUM_LEVEL_SLOTS)
+	{
+		return;
+	}
+
+	if (Enable)
+	{
+		EnableMasks.EnabledLevelSlots |= 1ull << LevelSlot;
+	}
+	else
+	{
+		EnableMasks.EnabledLevelSlots &= ~(1ull << LevelSlot);
+	}
+}
+
+void SetEditorOnlyEnabled(bool Enable)
+{
+	EnableMasks.EditorOnlyEnabled = Enable;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <cstdint>
+
+// Enable masks
+//---------------------
+// Groups of bitmaps/collision components that are enabled or disabled together without touching the components:
+// by render layer (e.g. a render layer hidden in the level editor), by level (cached levels that are not active,
+// see "LevelManager.h") and collision only used while editing (game objects without collision in game,
+// still clickable in the level editor).
+//
+// Every bitmap/collision component has an enable group, it is only rendered/collidable while every group it is part of
+// is enabled in the enable masks (checked when rendering and testing collision), so enabling/disabling a group
+// is a single bit and costs the same for any number of game objects.
+// Enable masks are combined with the own state of a component ("BitmapSetToNotRender", "NoCollision")
+//---------------------
+
+// Number of levels that can have an enable bit (level slot 0 is never disabled, used by anything not part of a level)
+#define ENABLEMASKS_MAXNUM_LEVEL_SLOTS 64
+// Render layers an enable group can be part of (one bit each)
+#define ENABLEMASKS_MAXNUM_RENDER_LAYERS 32
+
+struct SEnableGroup
+{
+	// Render layer the component is enabled/disabled with (-1 if not part of a render layer group e.g. user interface)
+	int8_t RenderLayer = -1;
+	// Level the component belongs to (0 if not part of a level)
+	uint8_t LevelSlot = 0;
+	// Only enabled while the game is not running (e.g. collision only used to click a game object in the level editor)
+	bool EditorOnly = false;
+};
+
+struct SEnableMasks
+{
+	uint32_t EnabledRenderLayers = 0xFFFFFFFF;
+	uint64_t EnabledLevelSlots = 1;
+	bool EditorOnlyEnabled = true;
+};
+
+extern "C" VOODOOENGINE_API SEnableMasks* GetEnableMasks();
+
+extern "C" VOODOOENGINE_API void SetRenderLayerEnabled(int RenderLayer, bool Enable);
+extern "C" VOODOOENGINE_API bool IsRenderLayerEnabled(int RenderLayer);
+// Level slots are given out by the level manager, level slot 0 can not be disabled
+extern "C" VOODOOENGINE_API void SetLevelSlotEnabled(int LevelSlot, bool Enable);
+// Disabled by the engine while the game is running
+extern "C" VOODOOENGINE_API void SetEditorOnlyEnabled(bool Enable);
+
+inline bool IsEnableGroupEnabled(const SEnableGroup& Group, const SEnableMasks* Masks)
+{
+	return (Group.RenderLayer < 0 || (Masks->EnabledRenderLayers >> Group.RenderLayer) & 1) &&
+		((Masks->EnabledLevelSlots >> Group.LevelSlot) & 1) &&
+		(!Group.EditorOnly || Masks->EditorOnlyEnabled);
+}
@@ -0,0 +1,282 @@
+#include "EntityStorage.h"
+
+static SEntityRecord* GetEntityRecord(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	if (Entity.Index >= Storage->Entities.size())
+	{
+		return nullptr;
+	}
+
+	SEntityRecord* Record = &Storage->Entities[Entity.Index];
+	if (Record->Generation != Entity.Generation ||
+		Record->Archetype < 0)
+	{
+		return nullptr;
+	}
+
+	return Record;
+}
+
+// Add a default initialized row to an archetype table, returns the row index
+static uint32_t AddArchetypeRow(SEntityArchetype* Archetype, SEntityHandle Entity)
+{
+	uint32_t Row = (uint32_t)Archetype->Handles.size();
+	Archetype->Handles.push_back(Entity);
+	Archetype->Transforms.emplace_back();
+	if (Archetype->ComponentMask & EntityComponent_Sprite)
+	{
+		Archetype->Sprites.emplace_back();
+	}
+	if (Archetype->ComponentMask & EntityComponent_Collider)
+	{
+		Archetype->Colliders.emplace_back();
+	}
+
+	return Row;
+}
+
+// Remove a row by moving the last row into it (the record of the moved entity is updated)
+static void RemoveArchetypeRow(SEntityStorage* Storage, SEntityArchetype* Archetype, uint32_t Row)
+{
+	uint32_t LastRow = (uint32_t)Archetype->Handles.size() - 1;
+	if (Row != LastRow)
+	{
+		Archetype->Handles[Row] = Archetype->Handles[LastRow];
+		Archetype->Transforms[Row] = Archetype->Transforms[LastRow];
+		if (Archetype->ComponentMask & EntityComponent_Sprite)
+		{
+			Archetype->Sprites[Row] = Archetype->Sprites[LastRow];
+		}
+		if (Archetype->ComponentMask & EntityComponent_Collider)
+		{
+			Archetype->Colliders[Row] = Archetype->Colliders[LastRow];
+		}
+		Storage->Entities[Archetype->Handles[Row].Index].Row = Row;
+	}
+
+	Archetype->Handles.pop_back();
+	Archetype->Transforms.pop_back();
+	if (Archetype->ComponentMask & EntityComponent_Sprite)
+	{
+		Archetype->Sprites.pop_back();
+	}
+	if (Archetype->ComponentMask & EntityComponent_Collider)
+	{
+		Archetype->Colliders.pop_back();
+	}
+}
+
+SEntityHandle CreateEntity(SEntityStorage* Storage, int ComponentMask, SVector Location)
+{
+	ComponentMask &= (EntityComponent_NumArchetypes - 1);
+
+	uint32_t EntityIndex = 0;
+	if (!Storage->FreeEntities.empty())
+	{
+		EntityIndex = Storage->FreeEntities.back();
+		Storage->FreeEntities.pop_back();
+	}
+	else
+	{
+		EntityIndex = (uint32_t)Storage->Entities.size();
+		Storage->Entities.emplace_back();
+	}
+
+	SEntityHandle Entity;
+	Entity.Index = EntityIndex;
+	Entity.Generation = Storage->Entities[EntityIndex].Generation;
+
+	SEntityArchetype* Archetype = &Storage->Archetypes[ComponentMask];
+	uint32_t Row = AddArchetypeRow(Archetype, Entity);
+	Archetype->Transforms[Row].Location = Location;
+
+	Storage->Entities[EntityIndex].Archetype = ComponentMask;
+	Storage->Entities[EntityIndex].Row = Row;
+	Storage->NumEntities++;
+
+	return Entity;
+}
+
+bool DestroyEntity(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	SEntityRecord* Record = GetEntityRecord(Storage, Entity);
+	if (!Record)
+	{
+		return false;
+	}
+
+	RemoveArchetypeRow(Storage, &Storage->Archetypes[Record->Archetype], Record->Row);
+	Record->Generation++;
+	Record->Archetype = -1;
+	Storage->FreeEntities.push_back(Entity.Index);
+	Storage->NumEntities--;
+
+	return true;
+}
+
+bool IsEntityValid(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	return GetEntityRecord(Storage, Entity) != nullptr;
+}
+
+void DestroyAllEntities(SEntityStorage* Storage)
+{
+	for (int i = 0; i < EntityComponent_NumArchetypes; ++i)
+	{
+		SEntityArchetype& Archetype = Storage->Archetypes[i];
+		for (int Row = 0; Row < Archetype.Handles.size(); ++Row)
+		{
+			SEntityRecord& Record = Storage->Entities[Archetype.Handles[Row].Index];
+			Record.Generation++;
+			Record.Archetype = -1;
+			Storage->FreeEntities.push_back(Archetype.Handles[Row].Index);
+		}
+
+		Archetype.Handles.clear();
+		Archetype.Transforms.clear();
+		Archetype.Sprites.clear();
+		Archetype.Colliders.clear();
+	}
+
+	Storage->NumEntities = 0;
+}
+
+bool SetEntityComponents(SEntityStorage* Storage, SEntityHandle Entity, int ComponentMask)
+{
+	SEntityRecord* Record = GetEntityRecord(Storage, Entity);
+	if (!Record)
+	{
+		return false;
+	}
+
+	ComponentMask &= (EntityComponent_NumArchetypes - 1);
+	if (Record->Archetype == ComponentMask)
+	{
+		return true;
+	}
+
+	SEntityArchetype* OldArchetype = &Storage->Archetypes[Record->Archetype];
+	SEntityArchetype* NewArchetype = &Storage->Archetypes[ComponentMask];
+	uint32_t OldRow = Record->Row;
+	uint32_t NewRow = AddArchetypeRow(NewArchetype, Entity);
+
+	NewArchetype->Transforms[NewRow] = OldArchetype->Transforms[OldRow];
+	if (OldArchetype->ComponentMask & NewArchetype->ComponentMask & EntityComponent_Sprite)
+	{
+		NewArchetype->Sprites[NewRow] = OldArchetype->Sprites[OldRow];
+	}
+	if (OldArchetype->ComponentMask & NewArchetype->ComponentMask & EntityComponent_Collider)
+	{
+		NewArchetype->Colliders[NewRow] = OldArchetype->Colliders[OldRow];
+	}
+
+	RemoveArchetypeRow(Storage, OldArchetype, OldRow);
+	Record->Archetype = ComponentMask;
+	Record->Row = NewRow;
+
+	return true;
+}
+
+int GetEntityComponents(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	SEntityRecord* Record = GetEntityRecord(Storage, Entity);
+	if (!Record)
+	{
+		return -1;
+	}
+
+	return Record->Archetype;
+}
+
+SEntityTransform* GetEntityTransform(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	SEntityRecord* Record = GetEntityRecord(Storage, Entity);
+	if (!Record)
+	{
+		return nullptr;
+	}
+
+	return &Storage->Archetypes[Record->Archetype].Transforms[Record->Row];
+}
+
+SEntitySprite* GetEntitySprite(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	SEntityRecord* Record = GetEntityRecord(Storage, Entity);
+	if (!Record ||
+		!(Record->Archetype & EntityComponent_Sprite))
+	{
+		return nullptr;
+	}
+
+	return &Storage->Archetypes[Record->Archetype].Sprites[Record->Row];
+}
+
+SEntityCollider* GetEntityCollider(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	SEntityRecord* Record = GetEntityRecord(Storage, Entity);
+	if (!Record ||
+		!(Record->Archetype & EntityComponent_Collider))
+	{
+		return nullptr;
+	}
+
+	return &Storage->Archetypes[Record->Archetype].Colliders[Record->Row];
+}
+
+void SetEntityLocation(SEntityStorage* Storage, SEntityHandle Entity, SVector NewLocation)
+{
+	SEntityTransform* Transform = GetEntityTransform(Storage, Entity);
+	if (Transform)
+	{
+		Transform->Location = NewLocation;
+	}
+}
+
+SVector GetEntityLocation(SEntityStorage* Storage, SEntityHandle Entity)
+{
+	SEntityTransform* Transform = GetEntityTransform(Storage, Entity);
+	if (!Transform)
+	{
+		return {};
+	}
+
+	return Transform->Location;
+}
+
+bool IsEntityCollisionDetected(
+	CollisionComponent* Sender, SEntityTransform* TargetTransform, SEntityCollider* TargetCollider)
+{
+	if (Sender->NoCollision ||
+		TargetCollider->NoCollision)
+	{
+		return false;
+	}
+
+	const SEnableMasks* EnableMasks = GetEnableMasks();
+	if (!IsEnableGroupEnabled(Sender->EnableGroup, EnableMasks) ||
+		!IsEnableGroupEnabled(TargetCollider->EnableGroup, EnableMasks))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < Sender->CollisionTagsToIgnore.size(); ++i)
+	{
+		if (Sender->CollisionTagsToIgnore[i] == TargetCollider->CollisionTag)
+		{
+			return false;
+		}
+	}
+
+	SVector TargetLocation = 
+		{ TargetTransform->Location.X + TargetCollider->Offset.X, 
+		TargetTransform->Location.Y + TargetCollider->Offset.Y };
+	if (Sender->ComponentLocation.X < TargetLocation.X + TargetCollider->CollisionRect.X &&
+		TargetLocation.X < Sender->ComponentLocation.X + Sender->CollisionRect.X &&
+		Sender->ComponentLocation.Y < TargetLocation.Y + TargetCollider->CollisionRect.Y &&
+		TargetLocation.Y < Sender->ComponentLocation.Y + Sender->CollisionRect.Y)
+	{
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "BitmapComponent.h"
+#include "CollisionComponent.h"
+#include <cstdint>
+#include <vector>
+
+// Entity storage
+//---------------------
+// Archetype storage for entities made of a transform and optionally a sprite and/or a collider.
+// Every combination of components (archetype) has its own table where each component type is stored
+// in a contiguous array, so systems iterate tightly packed data instead of chasing pointers to
+// components embedded in game objects (e.g. rendering only touches transforms + sprites).
+//
+// An entity is referenced by a handle (index + generation), rows within a table are moved when
+// an entity is destroyed or its components change (swap with last row), the handle stays valid.
+// Sprite/collider locations are offsets from the entity transform, so moving an entity is a single write.
+//
+// NOTE: Component pointers returned by "GetEntity..." are only valid until the next time an entity
+// is created/destroyed or has its components changed
+//---------------------
+
+#define ENTITYSTORAGE_INVALID_INDEX 0xFFFFFFFF
+
+// Components an entity can have in addition to its transform (combined as a bitmask)
+enum EEntityComponent
+{
+	EntityComponent_None = 0,
+	EntityComponent_Sprite = 1 << 0,
+	EntityComponent_Collider = 1 << 1,
+	// Number of possible archetypes (every combination of the components above)
+	EntityComponent_NumArchetypes = 1 << 2
+};
+
+// Stays safe to use after the entity has been destroyed (the generation no longer matches)
+struct SEntityHandle
+{
+	uint32_t Index = ENTITYSTORAGE_INVALID_INDEX;
+	uint32_t Generation = 0;
+};
+
+struct SEntityTransform
+{
+	SVector Location;
+};
+
+struct SEntitySprite
+{
+	PlatformTexture* Bitmap = nullptr;
+	SBitmapParameters BitmapParams = {};
+	// Location relative to the entity transform
+	SVector Offset;
+};
+
+// Colliders stored here only block movement (see "AddMovementInput"),
+// overlap events are only sent between collision components
+struct SEntityCollider
+{
+	ECollisionType CollisionType = ECollisionType::Collision_Block;
+	bool NoCollision = false;
+	SEnableGroup EnableGroup;
+	int CollisionTag = -1;
+	SVector CollisionRect;
+	// Location relative to the entity transform
+	SVector Offset;
+	Object* Owner = nullptr;
+};
+
+// Table of all entities of the same archetype, row "i" of every array belongs to the same entity
+// (arrays of components the archetype does not have are always empty)
+struct SEntityArchetype
+{
+	int ComponentMask = EntityComponent_None;
+	std::vector<SEntityHandle> Handles;
+	std::vector<SEntityTransform> Transforms;
+	std::vector<SEntitySprite> Sprites;
+	std::vector<SEntityCollider> Colliders;
+};
+
+struct SEntityRecord
+{
+	uint32_t Generation = 1;
+	// Archetype the entity is stored in (-1 if the entity is not in use)
+	int Archetype = -1;
+	uint32_t Row = 0;
+};
+
+struct SEntityStorage
+{
+	// Archetype index is the component mask
+	SEntityArchetype Archetypes[EntityComponent_NumArchetypes];
+	// All entities ever created, unused entities are reused through "FreeEntities"
+	std::vector<SEntityRecord> Entities;
+	std::vector<uint32_t> FreeEntities;
+	int NumEntities = 0;
+
+	SEntityStorage()
+	{
+		for (int i = 0; i < EntityComponent_NumArchetypes; ++i)
+		{
+			Archetypes[i].ComponentMask = i;
+		}
+	}
+};
+
+// Create an entity with a transform and the components of "ComponentMask" (see "EEntityComponent")
+extern "C" VOODOOENGINE_API SEntityHandle CreateEntity(
+	SEntityStorage* Storage, int ComponentMask, SVector Location = {});
+// Returns false if the entity is already destroyed
+extern "C" VOODOOENGINE_API bool DestroyEntity(SEntityStorage* Storage, SEntityHandle Entity);
+extern "C" VOODOOENGINE_API bool IsEntityValid(SEntityStorage* Storage, SEntityHandle Entity);
+extern "C" VOODOOENGINE_API void DestroyAllEntities(SEntityStorage* Storage);
+
+// Move the entity to the archetype of "ComponentMask",
+// components the entity keeps are copied, new components are default initialized
+extern "C" VOODOOENGINE_API bool SetEntityComponents(SEntityStorage* Storage, SEntityHandle Entity, int ComponentMask);
+// Returns -1 if the entity is not valid
+extern "C" VOODOOENGINE_API int GetEntityComponents(SEntityStorage* Storage, SEntityHandle Entity);
+
+// Returns nullptr if the entity is not valid or does not have the component
+extern "C" VOODOOENGINE_API SEntityTransform* GetEntityTransform(SEntityStorage* Storage, SEntityHandle Entity);
+extern "C" VOODOOENGINE_API SEntitySprite* GetEntitySprite(SEntityStorage* Storage, SEntityHandle Entity);
+extern "C" VOODOOENGINE_API SEntityCollider* GetEntityCollider(SEntityStorage* Storage, SEntityHandle Entity);
+
+// Set/get the entity location (the location of its sprite and collider follow the transform)
+extern "C" VOODOOENGINE_API void SetEntityLocation(SEntityStorage* Storage, SEntityHandle Entity, SVector NewLocation);
+extern "C" VOODOOENGINE_API SVector GetEntityLocation(SEntityStorage* Storage, SEntityHandle Entity);
+
+// Same test as "IsCollisionDetected" against a collider of the entity storage
+extern "C" VOODOOENGINE_API bool IsEntityCollisionDetected(
+	CollisionComponent* Sender, SEntityTransform* TargetTransform, SEntityCollider* TargetCollider);
@@ -0,0 +1,284 @@
+#include "FrameAllocator.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+struct SFrameArena
+{
+	char* Memory = nullptr;
+	size_t Capacity = 0;
+	std::atomic<size_t> Used = { 0 };
+	// Memory taken from the heap when the arena was full (freed at reset)
+	std::mutex OverflowMutex;
+	std::vector<void*> OverflowBlocks;
+	size_t OverflowSize = 0;
+};
+static SFrameArena FrameArena;
+
+static std::atomic<int64_t> NumHeapAllocations = { 0 };
+static std::atomic<int64_t> NumHeapAllocationsAtFrameStart = { 0 };
+static std::atomic<HeapAllocationHook> AllocationHook = { nullptr };
+
+static size_t AlignSize(size_t Size, size_t Alignment)
+{
+	return (Size + Alignment - 1) & ~(Alignment - 1);
+}
+
+static void* AllocateFrameOverflow(size_t Size, size_t Alignment)
+{
+	// Over allocate so the returned memory can be aligned
+	void* Block = std::malloc(Size + Alignment);
+	if (!Block)
+	{
+		throw std::bad_alloc();
+	}
+
+	std::lock_guard<std::mutex> Lock(FrameArena.OverflowMutex);
+	FrameArena.OverflowBlocks.push_back(Block);
+	FrameArena.OverflowSize += Size + Alignment;
+
+	return (void*)AlignSize((size_t)Block, Alignment);
+}
+
+void* AllocateFrameMemory(size_t Size, size_t Alignment)
+{
+	if (Alignment < 1)
+	{
+		Alignment = 1;
+	}
+	if (Size < 1)
+	{
+		Size = 1;
+	}
+
+	// Alignment is applied to the offset, arena memory is allocated with the max alignment any type needs
+	size_t Offset = FrameArena.Used.load();
+	size_t AlignedOffset = 0;
+	do
+	{
+		AlignedOffset = AlignSize(Offset, Alignment);
+		if (!FrameArena.Memory || AlignedOffset + Size > FrameArena.Capacity)
+		{
+			return AllocateFrameOverflow(Size, Alignment);
+		}
+	}
+	while (!FrameArena.Used.compare_exchange_weak(Offset, AlignedOffset + Size));
+
+	return FrameArena.Memory + AlignedOffset;
+}
+
+void ResetFrameArena()
+{
+	// Grow the arena to fit everything allocated this frame (done once, not every frame)
+	if (!FrameArena.Memory || FrameArena.OverflowSize > 0)
+	{
+		size_t NewCapacity = FrameArena.Capacity + FrameArena.OverflowSize;
+		if (NewCapacity < FRAMEARENA_DEFAULT_SIZE)
+		{
+			NewCapacity = FRAMEARENA_DEFAULT_SIZE;
+		}
+
+		std::free(FrameArena.Memory);
+		FrameArena.Memory = (char*)std::malloc(NewCapacity);
+		FrameArena.Capacity = FrameArena.Memory ? NewCapacity : 0;
+
+		for (int i = 0; i < FrameArena.OverflowBlocks.size(); ++i)
+		{
+			std::free(FrameArena.OverflowBlocks[i]);
+		}
+		FrameArena.OverflowBlocks.clear();
+		FrameArena.OverflowSize = 0;
+	}
+
+	FrameArena.Used = 0;
+	NumHeapAllocationsAtFrameStart = NumHeapAllocations.load();
+}
+
+size_t GetFrameArenaUsedSize()
+{
+	// Overflow is written by any thread allocating frame memory
+	std::lock_guard<std::mutex> Lock(FrameArena.OverflowMutex);
+	return FrameArena.Used.load() + FrameArena.OverflowSize;
+}
+
+size_t GetFrameArenaCapacity()
+{
+	return FrameArena.Capacity;
+}
+
+int64_t GetNumHeapAllocations()
+{
+	return NumHeapAllocations.load();
+}
+
+int64_t GetNumFrameHeapAllocations()
+{
+	return NumHeapAllocations.load() - NumHeapAllocationsAtFrameStart.load();
+}
+
+void SetHeapAllocationHook(HeapAllocationHook Hook)
+{
+	AllocationHook = Hook;
+}
+
+#ifdef VOODOOENGINE_COUNT_ALLOCATIONS
+// Set while the hook is called, so allocations made by the hook itself are not sent to the hook again
+static thread_local bool InsideAllocationHook = false;
+
+static void CountAllocation(size_t Size)
+{
+	NumHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	HeapAllocationHook Hook = AllocationHook.load(std::memory_order_relaxed);
+	if (Hook && !InsideAllocationHook)
+	{
+		InsideAllocationHook = true;
+		Hook(Size);
+		InsideAllocationHook = false;
+	}
+}
+
+// Returns nullptr if out of memory
+static void* CountedAllocate(size_t Size)
+{
+	CountAllocation(Size);
+	return std::malloc(Size ? Size : 1);
+}
+
+// Returns nullptr if out of memory, freed with "FreeAligned"
+static void* CountedAllocateAligned(size_t Size, std::align_val_t Alignment)
+{
+	CountAllocation(Size);
+	size_t AlignmentSize = (size_t)Alignment;
+	// Size must be a multiple of the alignment
+	size_t AlignedSize = AlignSize(Size ? Size : 1, AlignmentSize);
+#ifdef _WIN32
+	return _aligned_malloc(AlignedSize, AlignmentSize);
+#else
+	return std::aligned_alloc(AlignmentSize, AlignedSize);
+#endif
+}
+
+static void FreeAligned(void* Memory)
+{
+#ifdef _WIN32
+	_aligned_free(Memory);
+#else
+	std::free(Memory);
+#endif
+}
+
+static void* ThrowIfNull(void* Memory)
+{
+	if (!Memory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return Memory;
+}
+
+void* operator new(size_t Size)
+{
+	return ThrowIfNull(CountedAllocate(Size));
+}
+
+void* operator new[](size_t Size)
+{
+	return ThrowIfNull(CountedAllocate(Size));
+}
+
+void* operator new(size_t Size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(Size);
+}
+
+void* operator new[](size_t Size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(Size);
+}
+
+void* operator new(size_t Size, std::align_val_t Alignment)
+{
+	return ThrowIfNull(CountedAllocateAligned(Size, Alignment));
+}
+
+void* operator new[](size_t Size, std::align_val_t Alignment)
+{
+	return ThrowIfNull(CountedAllocateAligned(Size, Alignment));
+}
+
+void* operator new(size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAllocateAligned(Size, Alignment);
+}
+
+void* operator new[](size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAllocateAligned(Size, Alignment);
+}
+
+void operator delete(void* Memory) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete(void* Memory, size_t Size) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory, size_t Size) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete(void* Memory, const std::nothrow_t&) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory, const std::nothrow_t&) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete(void* Memory, std::align_val_t Alignment) noexcept
+{
+	FreeAligned(Memory);
+}
+
+void operator delete[](void* Memory, std::align_val_t Alignment) noexcept
+{
+	FreeAligned(Memory);
+}
+
+void operator delete(void* Memory, size_t Size, std::align_val_t Alignment) noexcept
+{
+	FreeAligned(Memory);
+}
+
+void operator delete[](void* Memory, size_t Size, std::align_val_t Alignment) noexcept
+{
+	FreeAligned(Memory);
+}
+
+void operator delete(void* Memory, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+	FreeAligned(Memory);
+}
+
+void operator delete[](void* Memory, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+	FreeAligned(Memory);
+}
+#endif
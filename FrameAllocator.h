@@ -0,0 +1,76 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Frame allocator
+//---------------------
+// Linear (bump) allocator for temporary data that only lives within a frame, e.g. lists of objects found
+// during a query. Allocating is a pointer increase and nothing is freed until the whole arena is reset
+// by the engine at the end of every frame.
+// If the arena runs out of memory within a frame, the extra memory is taken from the heap and the arena is
+// grown to fit it at the next reset, so a frame that does the same work as the last one never touches the heap.
+//
+// Use "FrameVector" for temporary lists (reserve the size up front when known,
+// memory released by a growing vector is not reused until the arena is reset).
+// Memory can be allocated from any thread, but never keep frame memory beyond the frame it was allocated in
+//
+// Allocation counting (opt in, only when the engine is built with "VOODOOENGINE_COUNT_ALLOCATIONS",
+// e.g. the "VOODOOENGINE_COUNT_ALLOCATIONS" CMake option): every form of global operator new/delete
+// (plain, array, sized, aligned and nothrow) is replaced to count every heap allocation of the program
+// (counted per frame in the "voodoo_heap_allocations" metric), an optional hook is called for every allocation
+//---------------------
+
+#define FRAMEARENA_DEFAULT_SIZE (256 * 1024)
+
+// Allocate memory valid until the end of the frame, never returns nullptr
+// (alignment up to "alignof(std::max_align_t)" within the arena)
+extern "C" VOODOOENGINE_API void* AllocateFrameMemory(size_t Size, size_t Alignment = alignof(std::max_align_t));
+// Called by the engine at the end of every frame, all frame memory is released
+extern "C" VOODOOENGINE_API void ResetFrameArena();
+// Number of bytes allocated from the frame arena this frame, and the size of the arena
+extern "C" VOODOOENGINE_API size_t GetFrameArenaUsedSize();
+extern "C" VOODOOENGINE_API size_t GetFrameArenaCapacity();
+
+// STL allocator using the frame arena (deallocate does nothing)
+template<class T>
+struct SFrameAllocator
+{
+	typedef T value_type;
+
+	SFrameAllocator(){};
+	template<class U>
+	SFrameAllocator(const SFrameAllocator<U>& Other){};
+
+	T* allocate(size_t Num)
+	{
+		return (T*)AllocateFrameMemory(Num * sizeof(T), alignof(T));
+	}
+	void deallocate(T* Memory, size_t Num){};
+};
+
+template<class T, class U>
+inline bool operator==(const SFrameAllocator<T>&, const SFrameAllocator<U>&)
+{
+	return true;
+}
+template<class T, class U>
+inline bool operator!=(const SFrameAllocator<T>&, const SFrameAllocator<U>&)
+{
+	return false;
+}
+
+template<class T>
+using FrameVector = std::vector<T, SFrameAllocator<T>>;
+
+// Called for every heap allocation while allocation counting is enabled
+// (not called again for allocations made from within the hook)
+typedef void(*HeapAllocationHook)(size_t Size);
+
+// Returns 0 if allocation counting is not enabled
+extern "C" VOODOOENGINE_API int64_t GetNumHeapAllocations();
+// Heap allocations since the last time the frame arena was reset
+extern "C" VOODOOENGINE_API int64_t GetNumFrameHeapAllocations();
+extern "C" VOODOOENGINE_API void SetHeapAllocationHook(HeapAllocationHook Hook);
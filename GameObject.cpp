@@ -0,0 +1,54 @@
+#include "VoodooEngine.h"
+#include <mutex>
+
+// Number of cold data blocks allocated at once when the pool is empty
+#define GAMEOBJECT_COLD_DATA_CHUNK_SIZE 1024
+
+struct SGameObjectColdDataPool
+{
+	std::mutex Mutex;
+	std::vector<SGameObjectColdData*> FreeColdData;
+};
+
+// Allocated once and never deleted (chunks are never freed either),
+// game objects can still be deleted while static objects are destroyed (e.g. an engine declared static)
+static SGameObjectColdDataPool* GetGameObjectColdDataPool()
+{
+	static SGameObjectColdDataPool* Pool = new SGameObjectColdDataPool;
+	return Pool;
+}
+
+SGameObjectColdData* AllocateGameObjectColdData()
+{
+	SGameObjectColdDataPool* Pool = GetGameObjectColdDataPool();
+	std::lock_guard<std::mutex> Lock(Pool->Mutex);
+
+	if (Pool->FreeColdData.empty())
+	{
+		SGameObjectColdData* Chunk = new SGameObjectColdData[GAMEOBJECT_COLD_DATA_CHUNK_SIZE];
+		// Room for every block of the new chunk, so freeing a block never allocates
+		Pool->FreeColdData.reserve(Pool->FreeColdData.capacity() + GAMEOBJECT_COLD_DATA_CHUNK_SIZE);
+		// Blocks are handed out in address order
+		for (int i = GAMEOBJECT_COLD_DATA_CHUNK_SIZE - 1; i >= 0; --i)
+		{
+			Pool->FreeColdData.push_back(&Chunk[i]);
+		}
+	}
+
+	SGameObjectColdData* ColdData = Pool->FreeColdData.back();
+	Pool->FreeColdData.pop_back();
+	*ColdData = SGameObjectColdData();
+	return ColdData;
+}
+
+void FreeGameObjectColdData(SGameObjectColdData* ColdData)
+{
+	if (!ColdData)
+	{
+		return;
+	}
+
+	SGameObjectColdDataPool* Pool = GetGameObjectColdDataPool();
+	std::lock_guard<std::mutex> Lock(Pool->Mutex);
+	Pool->FreeColdData.push_back(ColdData);
+}
@@ -1,24 +1,145 @@
 #pragma once
 
+#include "VoodooEngineDLLExport.h"
+
+struct SCachedLevel;
+
+// Max size of the game object base class (64-bit), a level is made of many game objects (e.g. a level of 100k tiles)
+// so every byte added to the base class is paid by every game object.
+// Set to the current size, a member added to the base class has to go to "SGameObjectColdData" or out of line
+// (or raise the budget on purpose)
+#define GAMEOBJECT_SIZE_BUDGET 224
+
+// Members of a game object only used when loading/editing/caching levels or by entity stored game objects
+// (never by the update/render/collision of regular game objects), kept out of the game object
+// so more game objects fit in the cache when walked every frame
+struct SGameObjectColdData
+{
+	// Size of the class of the game object, set by "CreateGameObject" (see "GameObjectMemory.h")
+	uint32_t GameObjectClassSize = 0;
+	// Persistent ID in the level file of the level opened in the level editor, 0 if none (see "LevelEditJournal.h")
+	uint32_t LevelObjectID = 0;
+	// Level of the level manager cache the game object belongs to, nullptr if none (see "LevelManager.h")
+	SCachedLevel* CachedLevel = nullptr;
+	SEntityStorage* EntityStorage = nullptr;
+	SEntityHandle EntityHandle;
+};
+
+// Cold data is allocated from a pool in chunks (blocks of deleted game objects are reused),
+// so creating the game objects of a level doesn't allocate per game object
+extern "C" VOODOOENGINE_API SGameObjectColdData* AllocateGameObjectColdData();
+extern "C" VOODOOENGINE_API void FreeGameObjectColdData(SGameObjectColdData* ColdData);
+
 // Game object 
 //---------------------
 // This class is used as a base class for all objects placed in levels, 
 // if a game object needs custom stuff e.g. an object with more than a single bitmap/collision etc. 
 // then that object would be derived as a child from this class)
+//
+// Only the members used every frame (bitmap, location, ID, flags) live in the game object,
+// the members only used when loading/editing/caching levels are in "SGameObjectColdData" (created when first set).
+// Default collision is created out of line only for game objects that have collision
+// (game objects without collision in game, e.g. tiles, have no collision outside of the level editor)
 //---------------------
 class GameObject : public Object
 {
 public:
+	GameObject()
+	{
+		AttachTransform(&ObjectTransform, &GameObjectBitmap);
+	}
+	virtual ~GameObject()
+	{
+		delete DefaultGameObjectCollision;
+		FreeGameObjectColdData(ColdData);
+	}
+	// Components are attached to the transform of the game object, so a game object is never copied
+	GameObject(const GameObject&) = delete;
+	GameObject& operator=(const GameObject&) = delete;
+
 	BitmapComponent GameObjectBitmap;
 	SVector GameObjectDimensions = { 0, 0 };
-	bool GameObjectBitmapHiddenInGame = false;
 
 	// Never account for negative value as game object ID as that is the default value
 	int GameObjectID = -1;
-
-	// Optional, can be set to not be created
-	CollisionComponent DefaultGameObjectCollision;
+	bool GameObjectBitmapHiddenInGame = false;
 	bool CreateDefaultGameObjectCollisionInGame = false;
+	// Optional, set in the constructor of a derived class to store the transform/bitmap/default collision
+	// in the engine entity storage instead of "GameObjectBitmap"/"DefaultGameObjectCollision"
+	// (e.g. many static props, ignored in editor mode), default collision of an entity only blocks movement
+	bool StoreAsEntity = false;
+
+	// Optional, nullptr if not created (see "CreateDefaultGameObjectCollision"), deleted with the game object
+	CollisionComponent* DefaultGameObjectCollision = nullptr;
+
+	// Optional, nullptr until a cold member is set (see "GetColdData"), freed with the game object
+	SGameObjectColdData* ColdData = nullptr;
+
+	// Create the cold data if not created yet (use to set a cold member)
+	SGameObjectColdData* GetColdData()
+	{
+		if (!ColdData)
+		{
+			ColdData = AllocateGameObjectColdData();
+		}
+
+		return ColdData;
+	}
+
+	// Cold members are read without creating the cold data (default value if not created)
+	uint32_t GetGameObjectClassSize()
+	{
+		return ColdData ? ColdData->GameObjectClassSize : 0;
+	}
+	uint32_t GetLevelObjectID()
+	{
+		return ColdData ? ColdData->LevelObjectID : 0;
+	}
+	SCachedLevel* GetCachedLevel()
+	{
+		return ColdData ? ColdData->CachedLevel : nullptr;
+	}
+	void SetCachedLevel(SCachedLevel* Level)
+	{
+		if (Level || ColdData)
+		{
+			GetColdData()->CachedLevel = Level;
+		}
+	}
+
+	// Create the default collision if not created yet (attached to the game object transform),
+	// it is in the same render layer/level enable group as the bitmap (see "EnableMasks.h")
+	CollisionComponent* CreateDefaultGameObjectCollision()
+	{
+		if (!DefaultGameObjectCollision)
+		{
+			DefaultGameObjectCollision = new CollisionComponent;
+			DefaultGameObjectCollision->Owner = this;
+			DefaultGameObjectCollision->EnableGroup.RenderLayer = GameObjectBitmap.BitmapParams.EnableGroup.RenderLayer;
+			DefaultGameObjectCollision->EnableGroup.LevelSlot = GameObjectBitmap.BitmapParams.EnableGroup.LevelSlot;
+			AttachTransform(&ObjectTransform, DefaultGameObjectCollision);
+		}
+
+		return DefaultGameObjectCollision;
+	}
+
+	bool IsStoredAsEntity()
+	{
+		return ColdData && ColdData->EntityStorage && IsEntityValid(ColdData->EntityStorage, ColdData->EntityHandle);
+	}
+
+	// Handle-backed accessors, returns nullptr if not stored as entity 
+	// (or if stored without bitmap/default collision)
+	SEntitySprite* GetEntitySprite()
+	{
+		return ColdData && ColdData->EntityStorage ?
+			::GetEntitySprite(ColdData->EntityStorage, ColdData->EntityHandle) : nullptr;
+	}
+	SEntityCollider* GetEntityCollider()
+	{
+		return ColdData && ColdData->EntityStorage ?
+			::GetEntityCollider(ColdData->EntityStorage, ColdData->EntityHandle) : nullptr;
+	}
 
 	// Optional custom constructor, called after everything has been initialized for the game object
 	virtual void OnGameObjectCreated(SVector SpawnLocation){};
@@ -32,6 +153,21 @@ public:
 	// Enable/disable bitmap rendering/default object collision
 	virtual void SetGameObjectState(bool Enable = false)
 	{
+		if (IsStoredAsEntity())
+		{
+			SEntitySprite* Sprite = GetEntitySprite();
+			if (Sprite)
+			{
+				Sprite->BitmapParams.BitmapSetToNotRender = !Enable || GameObjectBitmapHiddenInGame;
+			}
+			SEntityCollider* Collider = GetEntityCollider();
+			if (Collider)
+			{
+				Collider->NoCollision = !Enable || !CreateDefaultGameObjectCollisionInGame;
+			}
+			return;
+		}
+
 		if (Enable)
 		{
 			if (!GameObjectBitmapHiddenInGame)
@@ -39,17 +175,44 @@ public:
 				GameObjectBitmap.BitmapParams.BitmapSetToNotRender = false;
 			}
 
-			// Set no collision as default, and if set to have collision enable it
-			DefaultGameObjectCollision.NoCollision = true;
-			if (CreateDefaultGameObjectCollisionInGame)
+			// Collision of game objects without collision in game is only enabled while the game is not running
+			// (enable group is editor only, see "EnableMasks.h")
+			if (DefaultGameObjectCollision)
 			{
-				DefaultGameObjectCollision.NoCollision = false;
+				DefaultGameObjectCollision->NoCollision = false;
 			}
 		}
 		else if (!Enable)
 		{
 			GameObjectBitmap.BitmapParams.BitmapSetToNotRender = true;
-			DefaultGameObjectCollision.NoCollision = true;
+			if (DefaultGameObjectCollision)
+			{
+				DefaultGameObjectCollision->NoCollision = true;
+			}
+		}
+	}
+
+	// Level the bitmap/default collision is enabled/disabled with (see "EnableMasks.h"), set by the level manager
+	void SetGameObjectLevelSlot(int LevelSlot)
+	{
+		GameObjectBitmap.BitmapParams.EnableGroup.LevelSlot = (uint8_t)LevelSlot;
+		if (DefaultGameObjectCollision)
+		{
+			DefaultGameObjectCollision->EnableGroup.LevelSlot = (uint8_t)LevelSlot;
+		}
+
+		if (IsStoredAsEntity())
+		{
+			SEntitySprite* Sprite = GetEntitySprite();
+			if (Sprite)
+			{
+				Sprite->BitmapParams.EnableGroup.LevelSlot = (uint8_t)LevelSlot;
+			}
+			SEntityCollider* Collider = GetEntityCollider();
+			if (Collider)
+			{
+				Collider->EnableGroup.LevelSlot = (uint8_t)LevelSlot;
+			}
 		}
 	}
 
@@ -57,3 +220,6 @@ public:
 	virtual void OnBeginOverlap(int SenderCollisionTag, int TargetCollisionTag, Object* Target = nullptr){};
 	virtual void OnEndOverlap(int SenderCollisionTag, int TargetCollisionTag){};
 };
+
+static_assert(sizeof(GameObject) <= GAMEOBJECT_SIZE_BUDGET,
+	"GameObject is over its size budget, move the added members out of line or into a derived class");
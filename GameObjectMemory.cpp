@@ -0,0 +1,111 @@
+#include "GameObjectMemory.h"
+#include "VoodooEngine.h"
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+
+static size_t GetGameObjectComponentBytes(GameObject* Object)
+{
+	size_t ComponentBytes = 0;
+	if (Object->ColdData)
+	{
+		ComponentBytes += sizeof(SGameObjectColdData);
+	}
+	if (Object->DefaultGameObjectCollision)
+	{
+		ComponentBytes += sizeof(CollisionComponent);
+	}
+
+	if (Object->IsStoredAsEntity())
+	{
+		ComponentBytes += sizeof(SEntityRecord) + sizeof(SEntityHandle) + sizeof(SEntityTransform);
+		if (Object->GetEntitySprite())
+		{
+			ComponentBytes += sizeof(SEntitySprite);
+		}
+		if (Object->GetEntityCollider())
+		{
+			ComponentBytes += sizeof(SEntityCollider);
+		}
+	}
+
+	// Tiles of a tilemap are counted as its components
+	if (Object->GameObjectID == TILEMAP_GAMEOBJECT_ID)
+	{
+		ComponentBytes += GetTilemapMemoryUsage(&((TilemapGameObject*)Object)->Tilemap);
+	}
+
+	return ComponentBytes;
+}
+
+void GetGameObjectMemoryReport(VoodooEngine* Engine, std::vector<SGameObjectTypeMemory>& OutReport)
+{
+	OutReport.clear();
+
+	std::unordered_map<int, int> ReportIndices;
+	for (int i = 0; i < Engine->StoredGameObjects.size(); ++i)
+	{
+		GameObject* Object = Engine->StoredGameObjects[i];
+
+		auto Iterator = ReportIndices.find(Object->GameObjectID);
+		if (Iterator == ReportIndices.end())
+		{
+			Iterator = ReportIndices.emplace(Object->GameObjectID, (int)OutReport.size()).first;
+			OutReport.emplace_back();
+			OutReport.back().GameObjectID = Object->GameObjectID;
+		}
+
+		// Game objects not created by "CreateGameObject" only count the base class
+		size_t ClassSize = Object->GetGameObjectClassSize() > 0 ? Object->GetGameObjectClassSize() : sizeof(GameObject);
+
+		SGameObjectTypeMemory& TypeMemory = OutReport[Iterator->second];
+		TypeMemory.NumGameObjects++;
+		TypeMemory.NumStoredAsEntity += Object->IsStoredAsEntity() ? 1 : 0;
+		TypeMemory.GameObjectClassSize = std::max(TypeMemory.GameObjectClassSize, ClassSize);
+		TypeMemory.GameObjectBytes += ClassSize;
+		TypeMemory.ComponentBytes += GetGameObjectComponentBytes(Object);
+	}
+
+	std::sort(OutReport.begin(), OutReport.end(),
+		[](const SGameObjectTypeMemory& A, const SGameObjectTypeMemory& B)
+		{
+			return A.GameObjectBytes + A.ComponentBytes > B.GameObjectBytes + B.ComponentBytes;
+		});
+}
+
+bool DumpGameObjectMemoryReport(VoodooEngine* Engine, const char* FileName)
+{
+	std::ofstream File(FileName);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	std::vector<SGameObjectTypeMemory> Report;
+	GetGameObjectMemoryReport(Engine, Report);
+
+	size_t TotalBytes = 0;
+	int TotalGameObjects = 0;
+	File << "GameObjectID Count Entities ClassSize GameObjectBytes ComponentBytes TotalBytes BytesPerGameObject\n";
+	for (int i = 0; i < Report.size(); ++i)
+	{
+		SGameObjectTypeMemory& TypeMemory = Report[i];
+		size_t TypeBytes = TypeMemory.GameObjectBytes + TypeMemory.ComponentBytes;
+		File << TypeMemory.GameObjectID << " "
+			<< TypeMemory.NumGameObjects << " "
+			<< TypeMemory.NumStoredAsEntity << " "
+			<< TypeMemory.GameObjectClassSize << " "
+			<< TypeMemory.GameObjectBytes << " "
+			<< TypeMemory.ComponentBytes << " "
+			<< TypeBytes << " "
+			<< TypeBytes / TypeMemory.NumGameObjects << "\n";
+
+		TotalBytes += TypeBytes;
+		TotalGameObjects += TypeMemory.NumGameObjects;
+	}
+	File << "Total " << TotalGameObjects << " game objects " << TotalBytes << " bytes\n";
+
+	File.close();
+
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <cstddef>
+#include <vector>
+
+// Game object memory
+//---------------------
+// Bytes used by the game objects of every game object ID (e.g. every tile type of a level),
+// used to see which types of game objects a level pays for and to check a level against its memory budget.
+// Game object bytes are the size of the class of the game object (derived members included),
+// component bytes are the cold data ("SGameObjectColdData") and the components created out of line ("DefaultGameObjectCollision"),
+// the entity storage rows of game objects stored as entities (record, handle and transform, plus sprite/collider if used)
+// and the tile storage of tilemap game objects. Textures are shared between game objects and are not counted
+//---------------------
+
+class VoodooEngine;
+
+struct SGameObjectTypeMemory
+{
+	int GameObjectID = 0;
+	int NumGameObjects = 0;
+	int NumStoredAsEntity = 0;
+	// Size of the class of a single game object of this ID
+	size_t GameObjectClassSize = 0;
+	size_t GameObjectBytes = 0;
+	size_t ComponentBytes = 0;
+};
+
+// Fills "OutReport" with a row per game object ID of the stored game objects, largest total bytes first
+extern "C" VOODOOENGINE_API void GetGameObjectMemoryReport(
+	VoodooEngine* Engine, std::vector<SGameObjectTypeMemory>& OutReport);
+// Write the game object memory report as a table to a file (e.g. "GameObjectMemory.txt"),
+// returns false if the file could not be opened
+extern "C" VOODOOENGINE_API bool DumpGameObjectMemoryReport(VoodooEngine* Engine, const char* FileName);
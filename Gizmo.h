@@ -3,6 +3,18 @@
 #include "DLevelEditorInfo.h"
 #include "DDefaultRenderLayers.h"
 #include "VoodooEngine.h"
+#include <cmath>
+#include <unordered_set>
+
+// Box selection smaller than this (in pixels) is treated as a click on empty space
+#define GIZMO_MIN_SELECTION_BOX_SIZE 4
+
+// Game object moved by a gizmo drag and its location when the drag started
+struct SGizmoDragStart
+{
+	GameObject* DraggedGameObject = nullptr;
+	SVector StartLocation;
+};
 
 class Gizmo : public Object, public UpdateComponent, public IInput
 {
@@ -10,9 +22,13 @@ public:
 	BitmapComponent GizmoBitmap;
 	CollisionComponent GizmoCollision;
 
-	// Will send event whenever a game object is moved by the gizmo
+	// Will send event once a drag that moved the selected game objects has ended
 	std::vector<IEventNoParameters*> MoveGameObjectEventListeners;
 
+	// All selected game objects are moved together by the gizmo,
+	// "SelectedGameObject" is the one the gizmo is placed on
+	std::vector<GameObject*> SelectedGameObjects;
+	std::unordered_set<GameObject*> SelectedGameObjectSet;
 	GameObject* SelectedGameObject = nullptr;
 	GameObject* CurrentClickedGameObject = nullptr;
 	bool GameObjectMouseHover = false;
@@ -21,6 +37,19 @@ public:
 	SVector MouseClickLocationOffset;
 	float GizmoCollisionRectSize = 70;
 	bool RenderGizmoCollisionRect = false;
+	// Set when the selected game objects have been moved during the current drag
+	bool GameObjectsMovedDuringDrag = false;
+	// Every selected game object and its location when the drag started (recorded for undo once the drag ends),
+	// any selection change ends the drag first so this always matches the objects moved by the drag
+	std::vector<SGizmoDragStart> DragStartLocations;
+
+	// Box selection (drag on empty space, hold shift to add to the current selection)
+	CollisionComponent SelectionBoxCollision;
+	bool BoxSelecting = false;
+	SVector BoxSelectionStartLocation;
+	bool AddToSelectionHeld = false;
+	// Cleared while the level editor uses the mouse for something else (e.g. painting tiles)
+	bool SelectionEnabled = true;
 
 	void SetupGizmoCollisionTag()
 	{
@@ -43,12 +72,22 @@ public:
 		RenderGizmoCollisionRect = EnginePointer->DebugMode;
 		SetupGizmoCollisionTag();
 		SetupGizmoCollisionRect();
+		SetupSelectionBoxCollision();
 		EnginePointer->StoredEditorUpdateComponents.push_back(this);
 		EnginePointer->StoredEditorBitmapComponents.push_back(&GizmoBitmap);
 		EnginePointer->StoredEditorCollisionComponents.push_back(&GizmoCollision);
+		EnginePointer->StoredEditorCollisionComponents.push_back(&SelectionBoxCollision);
 		EnginePointer->InterfaceObjects_Input.push_back(this);
 	};
 
+	void SetupSelectionBoxCollision()
+	{
+		SelectionBoxCollision.CollisionTag = TAG_LEVEL_EDITOR_GIZMO;
+		SelectionBoxCollision.CollisionRectColor = { 1, 1, 1 };
+		SelectionBoxCollision.Opacity = 0.5;
+		SelectionBoxCollision.RenderCollisionRect = false;
+	};
+
 	void InitGizmoLocation(SVector NewLocation)
 	{
 		Location = NewLocation;
@@ -100,6 +139,18 @@ public:
 		GizmoCollision.ComponentLocation.Y = Location.Y;
 	};
 
+	// Move all selected game objects by the same offset in one pass
+	void TranslateSelectedGameObjects(SVector Offset)
+	{
+		for (int i = 0; i < SelectedGameObjects.size(); ++i)
+		{
+			GameObject* SelectedObject = SelectedGameObjects[i];
+			SetGameObjectLocation(SelectedObject,
+				{ SelectedObject->Location.X + Offset.X, SelectedObject->Location.Y + Offset.Y });
+			MoveEditorPickingObject(&EnginePointer->EditorPicking, SelectedObject);
+		}
+	};
+
 	void UpdateSelectedGameObjectDragLocation()
 	{
 		if (CanDragGizmo &&
@@ -110,176 +161,187 @@ public:
 			{ Location.X - GetGizmoOffsetLocation().X,
 			Location.Y - GetGizmoOffsetLocation().Y };
 
-			SelectedGameObject->Location = NewLocation;
-			SelectedGameObject->GameObjectBitmap.ComponentLocation = NewLocation;
-			SelectedGameObject->DefaultGameObjectCollision.ComponentLocation = NewLocation;
+			SVector Offset =
+			{ NewLocation.X - SelectedGameObject->Location.X,
+			NewLocation.Y - SelectedGameObject->Location.Y };
 
-			for (int i = 0; i < MoveGameObjectEventListeners.size(); ++i)
+			// Gizmo is snapped, so most drag frames don't move the selection at all
+			if (Offset.X == 0 &&
+				Offset.Y == 0)
 			{
-				MoveGameObjectEventListeners[i]->InterfaceEvent_NoParams();
+				return;
 			}
+
+			TranslateSelectedGameObjects(Offset);
+			GameObjectsMovedDuringDrag = true;
 		}
 	};
 
-	bool IsMouseHoveringGizmo()
+	void BeginGizmoDrag()
 	{
-		if (IsCollisionDetected(&GizmoCollision, &EnginePointer->Mouse.MouseCollider))
+		CanDragGizmo = true;
+		DragStartLocations.clear();
+		for (int i = 0; i < SelectedGameObjects.size(); ++i)
 		{
-			return true;
+			DragStartLocations.push_back({ SelectedGameObjects[i], SelectedGameObjects[i]->Location });
 		}
-
-		return false;
 	};
 
-	bool IsMouseHoveringGameObject()
+	// Whole drag is recorded as a single edit and listeners are notified once per drag instead of every drag frame
+	void EndGizmoDrag()
 	{
-		bool CollisionDetected = false;
-		for (int GameObjectIndex = 0; GameObjectIndex < EnginePointer->StoredGameObjects.size(); ++GameObjectIndex)
+		CanDragGizmo = false;
+		if (!GameObjectsMovedDuringDrag)
 		{
-			if (IsCollisionDetected(&EnginePointer->Mouse.MouseCollider,
-				&EnginePointer->StoredGameObjects[GameObjectIndex]->DefaultGameObjectCollision))
-			{
-				CollisionDetected = true;
-			}
+			DragStartLocations.clear();
+			return;
+		}
+
+		GameObjectsMovedDuringDrag = false;
+		BeginLevelEdit(&EnginePointer->LevelEditJournal);
+		for (int i = 0; i < DragStartLocations.size(); ++i)
+		{
+			RecordLevelObjectMoved(&EnginePointer->LevelEditJournal,
+				DragStartLocations[i].DraggedGameObject, DragStartLocations[i].StartLocation);
+		}
+		EndLevelEdit(&EnginePointer->LevelEditJournal);
+		DragStartLocations.clear();
+
+		for (int i = 0; i < MoveGameObjectEventListeners.size(); ++i)
+		{
+			MoveGameObjectEventListeners[i]->InterfaceEvent_NoParams();
 		}
+	};
 
-		return CollisionDetected;
+	bool IsGameObjectSelected(GameObject* GameObjectToCheck)
+	{
+		return SelectedGameObjectSet.find(GameObjectToCheck) != SelectedGameObjectSet.end();
 	};
 
-	int SetCurrentRenderLayerPrioritization(std::vector<GameObject*> CurrentGameObjectsFound)
+	void AddGameObjectToSelection(GameObject* GameObjectToAdd)
 	{
-		std::vector<int> StoredRenderLayerIDs;
-		for (int i = 0; i < CurrentGameObjectsFound.size(); ++i)
+		EndGizmoDrag();
+		if (SelectedGameObjectSet.insert(GameObjectToAdd).second)
 		{
-			switch (CurrentGameObjectsFound[i]->GameObjectBitmap.BitmapParams.RenderLayer)
-			{
-			case RENDERLAYER_0:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_0);
-				break;
-			case RENDERLAYER_1:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_1);
-				break;
-			case RENDERLAYER_2:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_2);
-				break;
-			case RENDERLAYER_3:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_3);
-				break;
-			case RENDERLAYER_4:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_4);
-				break;
-			case RENDERLAYER_5:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_5);
-				break;
-			case RENDERLAYER_6:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_6);
-				break;
-			case RENDERLAYER_7:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_7);
-				break;
-			case RENDERLAYER_8:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_8);
-				break;
-			case RENDERLAYER_9:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_9);
-				break;
-			case RENDERLAYER_10:
-				StoredRenderLayerIDs.push_back(RENDERLAYER_10);
-				break;
-			}
+			SelectedGameObjects.push_back(GameObjectToAdd);
 		}
+	};
 
-		int CurrentRenderLayerPrio = 0;
-		for (int IDIndex = 0; IDIndex < StoredRenderLayerIDs.size(); ++IDIndex)
+	void RemoveGameObjectFromSelection(GameObject* GameObjectToRemove)
+	{
+		EndGizmoDrag();
+		if (SelectedGameObjectSet.erase(GameObjectToRemove) == 0)
 		{
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_0)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_1)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_2)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_3)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_4)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_5)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_6)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_7)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_8)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_9)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
-			if (StoredRenderLayerIDs[IDIndex] > RENDERLAYER_10)
-			{
-				CurrentRenderLayerPrio = StoredRenderLayerIDs[IDIndex];
-			}
+			return;
 		}
 
-		return CurrentRenderLayerPrio;
+		SelectedGameObjects.erase(std::remove(
+			SelectedGameObjects.begin(), SelectedGameObjects.end(), GameObjectToRemove), SelectedGameObjects.end());
 	};
 
-	GameObject* AssignSelectedGameObjectByRenderLayer(
-		std::vector<GameObject*> GameObjectsFound, int RenderLayerPrioritized)
+	void ClearSelection()
 	{
-		int GameObjectToAssign = 0;
-		for (int GameObjectIndex = 0; GameObjectIndex < GameObjectsFound.size(); ++GameObjectIndex)
+		EndGizmoDrag();
+		SelectedGameObjects.clear();
+		SelectedGameObjectSet.clear();
+		SelectedGameObject = nullptr;
+	};
+
+	// Place the gizmo on the last selected game object (gizmo is hidden if nothing is selected)
+	void UpdateGizmoForSelection()
+	{
+		if (SelectedGameObjects.empty())
 		{
-			// If multiple game objects are colliding, then pick the one with the highest render layer prio
-			if (GameObjectsFound[GameObjectIndex]->GameObjectBitmap.BitmapParams.RenderLayer ==
-				RenderLayerPrioritized)
-			{
-				GameObjectToAssign = GameObjectIndex;
-			}
+			SelectedGameObject = nullptr;
+			SetGizmoState(true);
+			return;
 		}
 
-		return GameObjectsFound[GameObjectToAssign];
-	}
+		SelectedGameObject = SelectedGameObjects.back();
+		SetGizmoState(false);
+		SetGizmoLocationToSelectedGameObject();
+	};
 
-	void AssignMouseClickedGameObject()
+	void UpdateSelectionBox()
 	{
-		EnginePointer->Mouse.MouseHoveredObject = nullptr;
-		std::vector<GameObject*> GameObjectsFound;
-		for (int GameObjectIndex = 0; GameObjectIndex < EnginePointer->StoredGameObjects.size(); ++GameObjectIndex)
+		if (!BoxSelecting)
 		{
-			if (IsCollisionDetected(&EnginePointer->Mouse.MouseCollider,
-				&EnginePointer->StoredGameObjects[GameObjectIndex]->DefaultGameObjectCollision))
-			{
-				GameObjectsFound.push_back(EnginePointer->StoredGameObjects[GameObjectIndex]);
-			}
+			return;
 		}
 
-		if (GameObjectsFound.size() > 1)
+		// Selection box is always stored as top left location and positive size
+		SVector MouseLocation = EnginePointer->Mouse.Location;
+		SelectionBoxCollision.ComponentLocation.X = std::min(BoxSelectionStartLocation.X, MouseLocation.X);
+		SelectionBoxCollision.ComponentLocation.Y = std::min(BoxSelectionStartLocation.Y, MouseLocation.Y);
+		SelectionBoxCollision.CollisionRect.X = std::abs(MouseLocation.X - BoxSelectionStartLocation.X);
+		SelectionBoxCollision.CollisionRect.Y = std::abs(MouseLocation.Y - BoxSelectionStartLocation.Y);
+	};
+
+	void BeginBoxSelection()
+	{
+		BoxSelecting = true;
+		BoxSelectionStartLocation = EnginePointer->Mouse.Location;
+		SelectionBoxCollision.RenderCollisionRect = true;
+		UpdateSelectionBox();
+	};
+
+	// Select all game objects within the selection box (found through the editor picking index)
+	void EndBoxSelection()
+	{
+		BoxSelecting = false;
+		SelectionBoxCollision.RenderCollisionRect = false;
+		UpdateSelectionBox();
+
+		if (SelectionBoxCollision.CollisionRect.X < GIZMO_MIN_SELECTION_BOX_SIZE &&
+			SelectionBoxCollision.CollisionRect.Y < GIZMO_MIN_SELECTION_BOX_SIZE)
 		{
-			EnginePointer->Mouse.MouseHoveredObject = AssignSelectedGameObjectByRenderLayer(
-				GameObjectsFound, SetCurrentRenderLayerPrioritization(GameObjectsFound));
+			return;
 		}
-		else if (!GameObjectsFound.empty())
+
+		if (!AddToSelectionHeld)
 		{
-			EnginePointer->Mouse.MouseHoveredObject = GameObjectsFound.at(0);
+			ClearSelection();
 		}
+
+		FrameVector<GameObject*> FoundObjects;
+		QueryEditorPickingObjects(&EnginePointer->EditorPicking,
+			EnginePointer->StoredGameObjects, &SelectionBoxCollision, FoundObjects);
+
+		// Found objects are top most first, so the top most object gets the gizmo
+		for (int i = (int)FoundObjects.size() - 1; i >= 0; --i)
+		{
+			AddGameObjectToSelection(FoundObjects[i]);
+		}
+
+		UpdateGizmoForSelection();
+	};
+
+	bool IsMouseHoveringGizmo()
+	{
+		if (IsCollisionDetected(&GizmoCollision, &EnginePointer->Mouse.MouseCollider))
+		{
+			return true;
+		}
+
+		return false;
+	};
+
+	// Top most game object under the mouse (cached by the picking index until the mouse or scene changes)
+	GameObject* GetMouseHoveredGameObject()
+	{
+		return PickEditorObject(&EnginePointer->EditorPicking,
+			EnginePointer->StoredGameObjects, &EnginePointer->Mouse.MouseCollider);
+	};
+
+	bool IsMouseHoveringGameObject()
+	{
+		return GetMouseHoveredGameObject() != nullptr;
+	};
+
+	// If multiple game objects are under the mouse, then the one with the highest render layer prio is picked
+	void AssignMouseClickedGameObject()
+	{
+		EnginePointer->Mouse.MouseHoveredObject = GetMouseHoveredGameObject();
 	}
 
 	void Update(float DeltaTime)
@@ -298,13 +360,14 @@ public:
 		UpdateMouseDragSnapLocationGizmo();
 		UpdateGizmoLocation();
 		UpdateSelectedGameObjectDragLocation();
+		UpdateSelectionBox();
 	};
 
 	SVector GetGizmoOffsetLocation()
 	{
 		SVector OffsetLocation =
-		{ (SelectedGameObject->DefaultGameObjectCollision.CollisionRect.X / 2) - 10,
-			(SelectedGameObject->DefaultGameObjectCollision.CollisionRect.Y / 2) -
+		{ (SelectedGameObject->DefaultGameObjectCollision->CollisionRect.X / 2) - 10,
+			(SelectedGameObject->DefaultGameObjectCollision->CollisionRect.Y / 2) -
 			GizmoBitmap.BitmapParams.BitmapSource.Y + 10 };
 
 		return OffsetLocation;
@@ -322,20 +385,40 @@ public:
 		}
 	};
 
+	// Clicked game object replaces the selection, or is toggled in the selection if shift is held
 	void AssignSelectedObject()
 	{
-		if (EnginePointer->Mouse.MouseHoveredObject != nullptr)
+		if (EnginePointer->Mouse.MouseHoveredObject == nullptr)
+		{
+			return;
+		}
+
+		GameObject* ClickedGameObject = (GameObject*)(EnginePointer->Mouse.MouseHoveredObject);
+		if (!AddToSelectionHeld)
+		{
+			ClearSelection();
+			AddGameObjectToSelection(ClickedGameObject);
+		}
+		else if (IsGameObjectSelected(ClickedGameObject))
+		{
+			RemoveGameObjectFromSelection(ClickedGameObject);
+		}
+		else
 		{
-			SelectedGameObject = (GameObject*)(EnginePointer->Mouse.MouseHoveredObject);
+			AddGameObjectToSelection(ClickedGameObject);
 		}
+
+		UpdateGizmoForSelection();
 	};
 
 	void FullGizmoReset()
 	{
-		CanDragGizmo = false;
+		EndGizmoDrag();
+		BoxSelecting = false;
+		SelectionBoxCollision.RenderCollisionRect = false;
 		SetGizmoState(true);
 		EnginePointer->Mouse.MouseHoveredObject = nullptr;
-		SelectedGameObject = nullptr;
+		ClearSelection();
 	};
 
 	void InterfaceEvent_Input(int Input, bool Pressed)
@@ -346,7 +429,28 @@ public:
 			return;
 		}
 
-		if (EnginePointer->Mouse.PrimaryMousePressed)
+		if (Input == INPUT_KEY_SHIFT_LEFT ||
+			Input == INPUT_KEY_SHIFT_RIGHT)
+		{
+			AddToSelectionHeld = Pressed;
+		}
+
+		if (!SelectionEnabled)
+		{
+			return;
+		}
+
+		if (Input == INPUT_MESSAGE_LBUTTONUP)
+		{
+			EndGizmoDrag();
+			if (BoxSelecting)
+			{
+				EndBoxSelection();
+			}
+			return;
+		}
+
+		if (Input == INPUT_MESSAGE_LBUTTONDOWN)
 		{
 			SetMouseClickGizmoLocationOffset();
 
@@ -354,11 +458,15 @@ public:
 			if (!GameObjectMouseHover &&
 				!GizmoMouseHover)
 			{
-				FullGizmoReset();
+				if (!AddToSelectionHeld)
+				{
+					FullGizmoReset();
+				}
+				BeginBoxSelection();
 			}
 			else if (GizmoMouseHover)
 			{
-				CanDragGizmo = true;
+				BeginGizmoDrag();
 			}
 
 			AssignMouseClickedGameObject();
@@ -372,11 +480,9 @@ public:
 
 			if (!GizmoMouseHover &&
 				GameObjectMouseHover &&
-				CurrentClickedGameObject != SelectedGameObject)
+				(AddToSelectionHeld || CurrentClickedGameObject != SelectedGameObject))
 			{
-				SetGizmoState(false);
 				AssignSelectedObject();
-				SetGizmoLocationToSelectedGameObject();
 			}
 		}
 	};
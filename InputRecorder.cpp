@@ -0,0 +1,225 @@
+#include "InputRecorder.h"
+#include "VoodooEngine.h"
+
+static void WriteInputRecordHeader(std::ofstream& File, EInputRecordType Type, uint32_t FrameNumber)
+{
+	File.put((char)Type);
+	File.write((const char*)&FrameNumber, sizeof(FrameNumber));
+}
+
+static uint32_t GetRecordingFrameNumber(VoodooEngine* Engine)
+{
+	return (uint32_t)(Engine->FrameNumber - Engine->InputRecorder.StartFrameNumber);
+}
+
+bool StartInputRecording(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	if (Engine->InputReplay.Replaying)
+	{
+		return false;
+	}
+
+	StopInputRecording(Engine);
+
+	OpenPlatformFile(Engine->InputRecorder.File, FileName, std::ios_base::out | std::ios_base::binary);
+	if (!Engine->InputRecorder.File.is_open())
+	{
+		return false;
+	}
+
+	const char Header[4] = { 'V', 'I', 'R', INPUT_RECORDING_VERSION };
+	Engine->InputRecorder.File.write(Header, sizeof(Header));
+
+	Engine->InputRecorder.Recording = true;
+	Engine->InputRecorder.StartFrameNumber = Engine->FrameNumber;
+	// Always record the cursor location of the first frame
+	Engine->InputRecorder.LastCursorLocation = { -1, -1 };
+	RecordCursorLocation(Engine, Engine->Mouse.Location);
+
+	return true;
+}
+
+void StopInputRecording(VoodooEngine* Engine)
+{
+	if (!Engine->InputRecorder.Recording)
+	{
+		return;
+	}
+
+	Engine->InputRecorder.File.close();
+	Engine->InputRecorder.Recording = false;
+}
+
+bool StartInputReplay(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	StopInputRecording(Engine);
+	StopInputReplay(Engine);
+
+	std::ifstream File;
+	OpenPlatformFile(File, FileName, std::ios_base::in | std::ios_base::binary);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	char Header[4] = {};
+	File.read(Header, sizeof(Header));
+	if (!File ||
+		Header[0] != 'V' ||
+		Header[1] != 'I' ||
+		Header[2] != 'R' ||
+		Header[3] != INPUT_RECORDING_VERSION)
+	{
+		return false;
+	}
+
+	std::vector<SInputRecord>& Records = Engine->InputReplay.Records;
+	while (true)
+	{
+		SInputRecord Record;
+		int Type = File.get();
+		if (Type == EOF)
+		{
+			break;
+		}
+		Record.Type = (EInputRecordType)Type;
+		File.read((char*)&Record.FrameNumber, sizeof(Record.FrameNumber));
+
+		switch (Record.Type)
+		{
+		case InputRecord_FrameDeltaTime:
+			File.read((char*)&Record.DeltaTime, sizeof(Record.DeltaTime));
+			break;
+		case InputRecord_Message:
+			File.read((char*)&Record.Message, sizeof(Record.Message));
+			File.read((char*)&Record.Key, sizeof(Record.Key));
+			break;
+		case InputRecord_CursorLocation:
+			File.read((char*)&Record.CursorLocation.X, sizeof(Record.CursorLocation.X));
+			File.read((char*)&Record.CursorLocation.Y, sizeof(Record.CursorLocation.Y));
+			break;
+		default:
+			// Unknown record type, the rest of the file can't be read
+			Records.clear();
+			return false;
+		}
+
+		// Recording was cut off in the middle of a record (e.g. app was closed while recording)
+		if (!File)
+		{
+			break;
+		}
+
+		Records.push_back(Record);
+	}
+
+	Engine->InputReplay.Replaying = true;
+	Engine->InputReplay.NextRecord = 0;
+	Engine->InputReplay.StartFrameNumber = Engine->FrameNumber;
+
+	return true;
+}
+
+void StopInputReplay(VoodooEngine* Engine)
+{
+	Engine->InputReplay.Replaying = false;
+	Engine->InputReplay.NextRecord = 0;
+	std::vector<SInputRecord>().swap(Engine->InputReplay.Records);
+}
+
+bool IsInputReplayFinished(VoodooEngine* Engine)
+{
+	return !Engine->InputReplay.Replaying ||
+		Engine->InputReplay.NextRecord >= Engine->InputReplay.Records.size();
+}
+
+int RunInputReplay(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	if (!StartInputReplay(Engine, FileName))
+	{
+		return -1;
+	}
+
+	int NumFramesRun = 0;
+	while (Engine->EngineRunning &&
+		!IsInputReplayFinished(Engine))
+	{
+		RunEngine(Engine);
+		NumFramesRun++;
+	}
+
+	StopInputReplay(Engine);
+
+	return NumFramesRun;
+}
+
+void RecordInputMessage(VoodooEngine* Engine, unsigned int Message, uintptr_t Key)
+{
+	if (!Engine->InputRecorder.Recording)
+	{
+		return;
+	}
+
+	uint16_t RecordedMessage = (uint16_t)Message;
+	uint16_t RecordedKey = (uint16_t)Key;
+	WriteInputRecordHeader(Engine->InputRecorder.File, InputRecord_Message, GetRecordingFrameNumber(Engine));
+	Engine->InputRecorder.File.write((const char*)&RecordedMessage, sizeof(RecordedMessage));
+	Engine->InputRecorder.File.write((const char*)&RecordedKey, sizeof(RecordedKey));
+}
+
+void RecordCursorLocation(VoodooEngine* Engine, SVector CursorLocation)
+{
+	// Cursor location is only recorded when it has moved
+	if (!Engine->InputRecorder.Recording ||
+		(CursorLocation.X == Engine->InputRecorder.LastCursorLocation.X &&
+		CursorLocation.Y == Engine->InputRecorder.LastCursorLocation.Y))
+	{
+		return;
+	}
+
+	Engine->InputRecorder.LastCursorLocation = CursorLocation;
+	WriteInputRecordHeader(Engine->InputRecorder.File, InputRecord_CursorLocation, GetRecordingFrameNumber(Engine));
+	Engine->InputRecorder.File.write((const char*)&CursorLocation.X, sizeof(CursorLocation.X));
+	Engine->InputRecorder.File.write((const char*)&CursorLocation.Y, sizeof(CursorLocation.Y));
+}
+
+void UpdateInputRecording(VoodooEngine* Engine)
+{
+	if (Engine->InputRecorder.Recording)
+	{
+		WriteInputRecordHeader(
+			Engine->InputRecorder.File, InputRecord_FrameDeltaTime, GetRecordingFrameNumber(Engine));
+		Engine->InputRecorder.File.write((const char*)&Engine->DeltaTime, sizeof(Engine->DeltaTime));
+	}
+
+	if (!Engine->InputReplay.Replaying)
+	{
+		return;
+	}
+
+	// Send all recorded input of the current frame, in the same order as it was recorded
+	SInputReplay& Replay = Engine->InputReplay;
+	uint64_t ReplayFrameNumber = Engine->FrameNumber - Replay.StartFrameNumber;
+	while (Replay.NextRecord < Replay.Records.size() &&
+		Replay.Records[Replay.NextRecord].FrameNumber <= ReplayFrameNumber)
+	{
+		const SInputRecord& Record = Replay.Records[Replay.NextRecord];
+		Replay.NextRecord++;
+
+		switch (Record.Type)
+		{
+		case InputRecord_FrameDeltaTime:
+			if (Replay.UseRecordedDeltaTime)
+			{
+				Engine->DeltaTime = Record.DeltaTime;
+			}
+			break;
+		case InputRecord_Message:
+			VoodooEngine::HandleInputMessage(Engine, Record.Message, Record.Key);
+			break;
+		case InputRecord_CursorLocation:
+			SetCustomMouseCursorLocation(Engine, Record.CursorLocation);
+			break;
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "SVector.h"
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+class VoodooEngine;
+
+// Input recording/replay
+//---------------------
+// Records all input (key/mouse messages and cursor location) together with the delta time of every frame
+// to a compact binary file, the recording can then be replayed through the same input path as the window
+// (e.g. in headless mode to run a recorded play session as a deterministic benchmark)
+//
+// File layout: "VIR" + version byte, followed by records of
+// [uint8 record type][uint32 frame number][payload]
+// - InputRecord_FrameDeltaTime: float delta time
+// - InputRecord_Message: uint16 input message, uint16 key
+// - InputRecord_CursorLocation: float X, float Y
+//---------------------
+
+#define INPUT_RECORDING_VERSION 1
+
+enum EInputRecordType : uint8_t
+{
+	InputRecord_FrameDeltaTime = 0,
+	InputRecord_Message = 1,
+	InputRecord_CursorLocation = 2
+};
+
+// A single recorded input event
+struct SInputRecord
+{
+	EInputRecordType Type = InputRecord_FrameDeltaTime;
+	uint32_t FrameNumber = 0;
+	uint16_t Message = 0;
+	uint16_t Key = 0;
+	float DeltaTime = 0;
+	SVector CursorLocation;
+};
+
+struct SInputRecorder
+{
+	bool Recording = false;
+	std::ofstream File;
+	SVector LastCursorLocation = { -1, -1 };
+	// Frame number of the engine when the recording started (recorded frame numbers start at 0)
+	uint64_t StartFrameNumber = 0;
+};
+
+struct SInputReplay
+{
+	bool Replaying = false;
+	// If true the recorded delta time of every frame is used instead of the engine clock
+	bool UseRecordedDeltaTime = true;
+	std::vector<SInputRecord> Records;
+	size_t NextRecord = 0;
+	// Frame number of the engine when the replay started (recorded frame numbers start at 0)
+	uint64_t StartFrameNumber = 0;
+};
+
+// Start recording all input to a file, returns false if the file could not be created or a replay is running
+extern "C" VOODOOENGINE_API bool StartInputRecording(VoodooEngine* Engine, const wchar_t* FileName);
+extern "C" VOODOOENGINE_API void StopInputRecording(VoodooEngine* Engine);
+
+// Start replaying a recording from file, returns false if the file is not found or is not a valid recording
+extern "C" VOODOOENGINE_API bool StartInputReplay(VoodooEngine* Engine, const wchar_t* FileName);
+extern "C" VOODOOENGINE_API void StopInputReplay(VoodooEngine* Engine);
+extern "C" VOODOOENGINE_API bool IsInputReplayFinished(VoodooEngine* Engine);
+
+// Replay driver, runs the engine until the whole recording has been replayed (or the engine stops running),
+// returns the number of frames run or -1 if the recording could not be loaded
+extern "C" VOODOOENGINE_API int RunInputReplay(VoodooEngine* Engine, const wchar_t* FileName);
+
+// Called by the engine whenever an input message is handled or the cursor is moved (only written while recording)
+extern "C" VOODOOENGINE_API void RecordInputMessage(VoodooEngine* Engine, unsigned int Message, uintptr_t Key);
+extern "C" VOODOOENGINE_API void RecordCursorLocation(VoodooEngine* Engine, SVector CursorLocation);
+
+// Called by the engine at the start of every frame (after delta time is set),
+// records the frame delta time or sends all replayed input of the current frame
+extern "C" VOODOOENGINE_API void UpdateInputRecording(VoodooEngine* Engine);
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "GameObject.h"
-#include <d2d1.h>
+#include "Platform.h"
 
 // Used for when certain objects wants to render on top of all other game objects regardless of renderlayer
 class IRender
 {
 public:
-	virtual void InterfaceEvent_Render(ID2D1HwndRenderTarget* Renderer){};
+	virtual void InterfaceEvent_Render(PlatformRenderTarget* Renderer){};
 };
 
 // Generic event interface with the sender as parameter 
@@ -0,0 +1,478 @@
+#include "JobSystem.h"
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <thread>
+
+// A queued job, fields are atomics so a thread stealing the job can read a slot while its owner
+// writes a slot that wrapped around to the same index (the steal then fails and the read job is not used)
+struct SJobSlot
+{
+	std::atomic<JobFunction> Function = { nullptr };
+	std::atomic<void*> Context = { nullptr };
+	std::atomic<int> Begin = { 0 };
+	std::atomic<int> End = { 0 };
+	std::atomic<SJobCounter*> Counter = { nullptr };
+};
+
+// Work stealing deque (Chase-Lev) in a fixed size ring buffer allocated when the job system is started,
+// only the thread owning the queue pushes/takes at the bottom, any thread steals from the top
+struct SJobQueue
+{
+	SJobSlot* Jobs = nullptr;
+	std::atomic<int64_t> Top = { 0 };
+	std::atomic<int64_t> Bottom = { 0 };
+};
+
+struct SJobSystem
+{
+	int NumWorkerThreads = 0;
+	std::vector<std::thread> WorkerThreads;
+	// Queue 0 is used by any thread that is not a worker thread (e.g. the main thread)
+	SJobQueue Queues[JOBSYSTEM_MAXNUM_WORKERS + 1];
+	std::atomic<int> NumQueuedJobs = { 0 };
+	std::atomic<bool> ShuttingDown = { false };
+	// Only used to put idle worker threads to sleep,
+	// a job is only pushed while locked if a worker thread is sleeping
+	std::mutex SleepMutex;
+	std::condition_variable SleepCondition;
+	std::atomic<int> NumSleepingWorkers = { 0 };
+};
+
+// Allocated once and never deleted,
+// worker threads can't be joined safely while the engine DLL is being unloaded
+static SJobSystem* JobSystem = nullptr;
+
+static SJobCounter FrameJobCounters[JOBSYSTEM_MAXNUM_FRAME_COUNTERS];
+static std::atomic<int> NumFrameJobCounters = { 0 };
+
+// Queue index of the current thread (worker threads start at 1)
+static thread_local int CurrentJobQueueIndex = 0;
+
+static void ExecuteJob(const SJob& Job);
+
+static void WriteJobSlot(SJobSlot& Slot, const SJob& Job)
+{
+	Slot.Function.store(Job.Function, std::memory_order_relaxed);
+	Slot.Context.store(Job.Context, std::memory_order_relaxed);
+	Slot.Begin.store(Job.Begin, std::memory_order_relaxed);
+	Slot.End.store(Job.End, std::memory_order_relaxed);
+	Slot.Counter.store(Job.Counter, std::memory_order_relaxed);
+}
+
+static void ReadJobSlot(const SJobSlot& Slot, SJob& Job)
+{
+	Job.Function = Slot.Function.load(std::memory_order_relaxed);
+	Job.Context = Slot.Context.load(std::memory_order_relaxed);
+	Job.Begin = Slot.Begin.load(std::memory_order_relaxed);
+	Job.End = Slot.End.load(std::memory_order_relaxed);
+	Job.Counter = Slot.Counter.load(std::memory_order_relaxed);
+}
+
+// Push to the bottom of the own queue, returns false if the queue is full
+static bool PushOwnJob(SJobQueue& Queue, const SJob& Job)
+{
+	int64_t Bottom = Queue.Bottom.load(std::memory_order_relaxed);
+	int64_t Top = Queue.Top.load(std::memory_order_acquire);
+	if (Bottom - Top >= JOBSYSTEM_QUEUE_CAPACITY)
+	{
+		return false;
+	}
+
+	WriteJobSlot(Queue.Jobs[Bottom & (JOBSYSTEM_QUEUE_CAPACITY - 1)], Job);
+	Queue.Bottom.store(Bottom + 1, std::memory_order_release);
+	return true;
+}
+
+// Take the newest job from the bottom of the own queue
+static bool TakeOwnJob(SJobQueue& Queue, SJob& Job)
+{
+	int64_t Bottom = Queue.Bottom.load(std::memory_order_relaxed) - 1;
+	Queue.Bottom.store(Bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t Top = Queue.Top.load(std::memory_order_relaxed);
+
+	if (Top > Bottom)
+	{
+		Queue.Bottom.store(Bottom + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	ReadJobSlot(Queue.Jobs[Bottom & (JOBSYSTEM_QUEUE_CAPACITY - 1)], Job);
+	if (Top == Bottom)
+	{
+		// Last job, race any thread stealing it
+		bool Taken = Queue.Top.compare_exchange_strong(
+			Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		Queue.Bottom.store(Bottom + 1, std::memory_order_relaxed);
+		return Taken;
+	}
+
+	return true;
+}
+
+// Steal the oldest job from the top of another queue
+static bool StealJob(SJobQueue& Queue, SJob& Job)
+{
+	int64_t Top = Queue.Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t Bottom = Queue.Bottom.load(std::memory_order_acquire);
+	if (Top >= Bottom)
+	{
+		return false;
+	}
+
+	ReadJobSlot(Queue.Jobs[Top & (JOBSYSTEM_QUEUE_CAPACITY - 1)], Job);
+	return Queue.Top.compare_exchange_strong(
+		Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+static void PushJob(const SJob& Job)
+{
+	// Counted before the job can be taken, so the number of queued jobs is never below zero
+	JobSystem->NumQueuedJobs.fetch_add(1);
+	if (!PushOwnJob(JobSystem->Queues[CurrentJobQueueIndex], Job))
+	{
+		// Queue full, run the job directly instead of growing the queue
+		JobSystem->NumQueuedJobs.fetch_sub(1);
+		ExecuteJob(Job);
+		return;
+	}
+
+	if (JobSystem->NumSleepingWorkers.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(JobSystem->SleepMutex);
+		}
+		JobSystem->SleepCondition.notify_one();
+	}
+}
+
+// Take the newest job from the own queue, or steal the oldest job from any other queue
+static bool PopJob(SJob& Job)
+{
+	if (JobSystem->NumQueuedJobs.load() <= 0)
+	{
+		return false;
+	}
+
+	if (TakeOwnJob(JobSystem->Queues[CurrentJobQueueIndex], Job))
+	{
+		JobSystem->NumQueuedJobs.fetch_sub(1);
+		return true;
+	}
+
+	int NumQueues = JobSystem->NumWorkerThreads + 1;
+	for (int i = 1; i < NumQueues; ++i)
+	{
+		if (StealJob(JobSystem->Queues[(CurrentJobQueueIndex + i) % NumQueues], Job))
+		{
+			JobSystem->NumQueuedJobs.fetch_sub(1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Count a job as done, all jobs waiting for the counter are queued when it reaches zero.
+// Decreased while locked, so a thread waiting for the counter can't destroy it while it is still used here
+// (see "WaitForJobCounter")
+static void FinishJob(SJobCounter* Counter)
+{
+	std::vector<SJob> ReleasedJobs;
+	{
+		std::lock_guard<std::mutex> Lock(Counter->WaitingJobsMutex);
+		if (Counter->NumJobsLeft.fetch_sub(1) == 1)
+		{
+			ReleasedJobs.swap(Counter->WaitingJobs);
+		}
+	}
+
+	for (int i = 0; i < ReleasedJobs.size(); ++i)
+	{
+		PushJob(ReleasedJobs[i]);
+	}
+}
+
+static void ExecuteJob(const SJob& Job)
+{
+	Job.Function(Job.Context, Job.Begin, Job.End);
+
+	if (Job.Counter)
+	{
+		FinishJob(Job.Counter);
+	}
+}
+
+static void RunWorkerThread(int QueueIndex)
+{
+	CurrentJobQueueIndex = QueueIndex;
+
+	while (true)
+	{
+		SJob Job;
+		if (PopJob(Job))
+		{
+			ExecuteJob(Job);
+			continue;
+		}
+
+		// Counted as sleeping before the queued jobs are checked,
+		// so a job pushed after the check always notifies this thread
+		std::unique_lock<std::mutex> Lock(JobSystem->SleepMutex);
+		JobSystem->NumSleepingWorkers.fetch_add(1);
+		JobSystem->SleepCondition.wait(Lock, []
+		{
+			return JobSystem->NumQueuedJobs.load() > 0 || JobSystem->ShuttingDown.load();
+		});
+		JobSystem->NumSleepingWorkers.fetch_sub(1);
+
+		if (JobSystem->ShuttingDown.load() && JobSystem->NumQueuedJobs.load() <= 0)
+		{
+			return;
+		}
+	}
+}
+
+void InitJobSystem(int NumWorkerThreads)
+{
+	if (!JobSystem)
+	{
+		JobSystem = new SJobSystem;
+	}
+	if (!JobSystem->WorkerThreads.empty())
+	{
+		return;
+	}
+
+	if (NumWorkerThreads < 0)
+	{
+		NumWorkerThreads = (int)std::thread::hardware_concurrency() - 1;
+	}
+	if (NumWorkerThreads < 0)
+	{
+		NumWorkerThreads = 0;
+	}
+	if (NumWorkerThreads > JOBSYSTEM_MAXNUM_WORKERS)
+	{
+		NumWorkerThreads = JOBSYSTEM_MAXNUM_WORKERS;
+	}
+
+	// Queues are only allocated once, so pushing a job never allocates
+	for (int i = 0; i <= NumWorkerThreads; ++i)
+	{
+		if (!JobSystem->Queues[i].Jobs)
+		{
+			JobSystem->Queues[i].Jobs = new SJobSlot[JOBSYSTEM_QUEUE_CAPACITY];
+		}
+	}
+
+	JobSystem->ShuttingDown = false;
+	JobSystem->NumWorkerThreads = NumWorkerThreads;
+	for (int i = 0; i < NumWorkerThreads; ++i)
+	{
+		JobSystem->WorkerThreads.push_back(std::thread(RunWorkerThread, i + 1));
+	}
+}
+
+void ShutdownJobSystem()
+{
+	if (!JobSystem)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(JobSystem->SleepMutex);
+		JobSystem->ShuttingDown = true;
+	}
+	JobSystem->SleepCondition.notify_all();
+
+	for (int i = 0; i < JobSystem->WorkerThreads.size(); ++i)
+	{
+		JobSystem->WorkerThreads[i].join();
+	}
+	JobSystem->WorkerThreads.clear();
+	JobSystem->NumWorkerThreads = 0;
+
+	// Anything still queued (e.g. no worker threads) is run on the calling thread
+	SJob Job;
+	while (PopJob(Job))
+	{
+		ExecuteJob(Job);
+	}
+}
+
+int GetNumJobThreads()
+{
+	if (!JobSystem)
+	{
+		return 1;
+	}
+
+	return JobSystem->NumWorkerThreads + 1;
+}
+
+int GetJobThreadIndex()
+{
+	return CurrentJobQueueIndex;
+}
+
+void RunJob(
+	JobFunction Function, void* Context, int Begin, int End,
+	SJobCounter* Counter, SJobCounter* Dependency)
+{
+	// Job system not started, run directly (dependencies are always done since nothing is ever queued)
+	if (!JobSystem)
+	{
+		Function(Context, Begin, End);
+		return;
+	}
+
+	SJob Job;
+	Job.Function = Function;
+	Job.Context = Context;
+	Job.Begin = Begin;
+	Job.End = End;
+	Job.Counter = Counter;
+
+	if (Counter)
+	{
+		Counter->NumJobsLeft.fetch_add(1);
+	}
+
+	if (Dependency)
+	{
+		// Checked while locked so the job is either stored before the dependency is released,
+		// or queued directly if the dependency is already done
+		std::lock_guard<std::mutex> Lock(Dependency->WaitingJobsMutex);
+		if (Dependency->NumJobsLeft.load() > 0)
+		{
+			Dependency->WaitingJobs.push_back(Job);
+			return;
+		}
+	}
+
+	PushJob(Job);
+}
+
+void WaitForJobCounter(SJobCounter* Counter)
+{
+	if (!Counter || !JobSystem)
+	{
+		return;
+	}
+
+	while (Counter->NumJobsLeft.load() > 0)
+	{
+		SJob Job;
+		if (PopJob(Job))
+		{
+			ExecuteJob(Job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// Wait until the thread that finished the last job is done with the counter
+	std::lock_guard<std::mutex> Lock(Counter->WaitingJobsMutex);
+}
+
+bool IsJobCounterDone(SJobCounter* Counter)
+{
+	return !Counter || Counter->NumJobsLeft.load() <= 0;
+}
+
+SJobCounter* AllocateFrameJobCounter()
+{
+	int CounterIndex = NumFrameJobCounters.fetch_add(1);
+	if (CounterIndex >= JOBSYSTEM_MAXNUM_FRAME_COUNTERS)
+	{
+		return nullptr;
+	}
+
+	return &FrameJobCounters[CounterIndex];
+}
+
+void EndJobSystemFrame()
+{
+	int NumCounters = NumFrameJobCounters.load();
+	if (NumCounters > JOBSYSTEM_MAXNUM_FRAME_COUNTERS)
+	{
+		NumCounters = JOBSYSTEM_MAXNUM_FRAME_COUNTERS;
+	}
+
+	// A frame counter with jobs left is a job that was never waited for (or never finished),
+	// it would still be counted when the counter is allocated again next frame
+	for (int i = 0; i < NumCounters; ++i)
+	{
+		assert(FrameJobCounters[i].NumJobsLeft.load() == 0 && "Frame job counter has unfinished jobs at the end of the frame");
+		assert(FrameJobCounters[i].WaitingJobs.empty() && "Frame job counter has jobs waiting for it at the end of the frame");
+	}
+	NumFrameJobCounters = 0;
+}
+
+// Batch size only depends on the range size, so the batches are the same for any number of threads
+static int GetParallelForBatchSize(int Count, int MinBatchSize)
+{
+	if (MinBatchSize < 1)
+	{
+		MinBatchSize = 1;
+	}
+
+	int BatchSize = (Count + JOBSYSTEM_MAXNUM_PARALLELFOR_BATCHES - 1) / JOBSYSTEM_MAXNUM_PARALLELFOR_BATCHES;
+	if (BatchSize < MinBatchSize)
+	{
+		BatchSize = MinBatchSize;
+	}
+
+	return BatchSize;
+}
+
+void ParallelForAsync(
+	int Count, int MinBatchSize, JobFunction Function, void* Context,
+	SJobCounter* Counter, SJobCounter* Dependency)
+{
+	int BatchSize = GetParallelForBatchSize(Count, MinBatchSize);
+	for (int Begin = 0; Begin < Count; Begin += BatchSize)
+	{
+		int End = Begin + BatchSize;
+		if (End > Count)
+		{
+			End = Count;
+		}
+		RunJob(Function, Context, Begin, End, Counter, Dependency);
+	}
+}
+
+void ParallelFor(int Count, int MinBatchSize, JobFunction Function, void* Context)
+{
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	// No worker threads, run the same batches directly on the calling thread
+	if (!JobSystem || JobSystem->NumWorkerThreads == 0)
+	{
+		int BatchSize = GetParallelForBatchSize(Count, MinBatchSize);
+		for (int Begin = 0; Begin < Count; Begin += BatchSize)
+		{
+			Function(Context, Begin, (Begin + BatchSize < Count) ? Begin + BatchSize : Count);
+		}
+		return;
+	}
+
+	if (Count <= GetParallelForBatchSize(Count, MinBatchSize))
+	{
+		Function(Context, 0, Count);
+		return;
+	}
+
+	SJobCounter Counter;
+	ParallelForAsync(Count, MinBatchSize, Function, Context, &Counter);
+	WaitForJobCounter(&Counter);
+}
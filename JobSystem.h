@@ -0,0 +1,87 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Job system
+//---------------------
+// Thread pool where every worker thread has its own job queue,
+// a worker takes the newest job from its own queue and steals the oldest job from another queue when empty.
+// Queues are lock free ring buffers of "JOBSYSTEM_QUEUE_CAPACITY" jobs allocated when the job system is started
+// (a job pushed to a full queue is run directly), only one thread that is not a worker thread may queue jobs
+// (the main thread).
+// The thread that waits for a job counter (e.g. the main thread in "ParallelFor") runs jobs while waiting.
+//
+// Jobs are counted by a job counter, a job can depend on a counter so it is not run until all jobs of
+// that counter are done (used to build dependency graphs of jobs).
+// Counters that are only used within a frame can be taken from "AllocateFrameJobCounter" (reset every frame).
+//
+// "ParallelFor" splits a range in batches that only depend on the range size (never on the number of threads),
+// so as long as every index only writes its own result, the result is the same regardless of thread count
+//---------------------
+
+#define JOBSYSTEM_MAXNUM_WORKERS 64
+// Max number of jobs queued per thread (power of two)
+#define JOBSYSTEM_QUEUE_CAPACITY 1024
+#define JOBSYSTEM_MAXNUM_FRAME_COUNTERS 256
+// Max number of batches a "ParallelFor" range is split into
+#define JOBSYSTEM_MAXNUM_PARALLELFOR_BATCHES 64
+
+// Job function called for a range of indices [Begin, End)
+typedef void(*JobFunction)(void* Context, int Begin, int End);
+
+struct SJob
+{
+	JobFunction Function = nullptr;
+	void* Context = nullptr;
+	int Begin = 0;
+	int End = 0;
+	struct SJobCounter* Counter = nullptr;
+};
+
+struct SJobCounter
+{
+	std::atomic<int> NumJobsLeft = { 0 };
+	// Jobs waiting for this counter to reach zero
+	std::mutex WaitingJobsMutex;
+	std::vector<SJob> WaitingJobs;
+};
+
+// Start the worker threads, "NumWorkerThreads" -1 uses one thread less than the number of cores
+// (the calling thread is also used), 0 runs all jobs on the calling thread
+extern "C" VOODOOENGINE_API void InitJobSystem(int NumWorkerThreads = -1);
+// Wait for all queued jobs and stop the worker threads
+extern "C" VOODOOENGINE_API void ShutdownJobSystem();
+// Number of threads running jobs (worker threads + the calling thread)
+extern "C" VOODOOENGINE_API int GetNumJobThreads();
+// Index of the calling thread, 1 to "JOBSYSTEM_MAXNUM_WORKERS" for worker threads, 0 for any other thread
+// (used to give every thread running jobs its own data, e.g. "STransformDirtyList")
+extern "C" VOODOOENGINE_API int GetJobThreadIndex();
+
+// Queue a job, the counter (optional) is increased now and decreased when the job is done,
+// if "Dependency" is set the job is not run until the dependency counter reaches zero
+// (queue the jobs of the dependency first, a dependency counter that is already zero is done)
+extern "C" VOODOOENGINE_API void RunJob(
+	JobFunction Function, void* Context, int Begin, int End,
+	SJobCounter* Counter, SJobCounter* Dependency = nullptr);
+// Run jobs on the calling thread until the counter reaches zero
+// (always wait with this before a counter is destroyed)
+extern "C" VOODOOENGINE_API void WaitForJobCounter(SJobCounter* Counter);
+extern "C" VOODOOENGINE_API bool IsJobCounterDone(SJobCounter* Counter);
+
+// Get a counter that is valid until the end of the frame,
+// returns nullptr if max number of frame counters is reached
+extern "C" VOODOOENGINE_API SJobCounter* AllocateFrameJobCounter();
+// Called by the engine at the end of every frame (all frame counters must be done, asserted)
+extern "C" VOODOOENGINE_API void EndJobSystemFrame();
+
+// Run "Function" for the range [0, Count) split in batches of at least "MinBatchSize",
+// queued as jobs counted by "Counter" (can depend on another counter), use "WaitForJobCounter" to wait
+extern "C" VOODOOENGINE_API void ParallelForAsync(
+	int Count, int MinBatchSize, JobFunction Function, void* Context,
+	SJobCounter* Counter, SJobCounter* Dependency = nullptr);
+// Same as "ParallelForAsync" but waits until the whole range is done,
+// batches are run directly on the calling thread if there is a single batch or no worker threads
+extern "C" VOODOOENGINE_API void ParallelFor(int Count, int MinBatchSize, JobFunction Function, void* Context);
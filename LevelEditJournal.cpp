@@ -0,0 +1,494 @@
+#include "LevelEditJournal.h"
+#include "VoodooEngine.h"
+#include "Tilemap.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static void ApplyJournalOperationToLevelObjects(const std::string& Type, std::stringstream& Stream,
+	std::vector<SLevelFileObject>& LevelObjects, std::unordered_map<uint32_t, int>& LevelObjectIndices, STilemap* Tilemap)
+{
+	if (Type == "tile")
+	{
+		int RenderLayer = 0;
+		float TileSize = 0;
+		int Column = 0;
+		int Row = 0;
+		int TileID = 0;
+		if (Tilemap &&
+			Stream >> RenderLayer >> TileSize >> Column >> Row >> TileID)
+		{
+			SetTile(Tilemap, RenderLayer, TileSize, Column, Row, TileID);
+		}
+		return;
+	}
+
+	uint32_t LevelObjectID = 0;
+	if (!(Stream >> LevelObjectID))
+	{
+		return;
+	}
+
+	auto Iterator = LevelObjectIndices.find(LevelObjectID);
+	if (Type == "create")
+	{
+		SLevelFileObject LevelObject;
+		LevelObject.LevelObjectID = LevelObjectID;
+		if (!(Stream >> LevelObject.GameObjectID >> LevelObject.Location.X >> LevelObject.Location.Y))
+		{
+			return;
+		}
+
+		// Operations are applied as "set" so a journal applied twice gives the same level
+		if (Iterator != LevelObjectIndices.end())
+		{
+			LevelObjects[Iterator->second] = LevelObject;
+			return;
+		}
+
+		LevelObjectIndices[LevelObjectID] = (int)LevelObjects.size();
+		LevelObjects.push_back(LevelObject);
+	}
+	else if (Type == "delete")
+	{
+		if (Iterator != LevelObjectIndices.end())
+		{
+			// Removed once the whole journal is applied
+			LevelObjects[Iterator->second].GameObjectID = -1;
+			LevelObjectIndices.erase(Iterator);
+		}
+	}
+	else if (Type == "move")
+	{
+		SVector Location;
+		if (Iterator != LevelObjectIndices.end() &&
+			Stream >> Location.X >> Location.Y)
+		{
+			LevelObjects[Iterator->second].Location = Location;
+		}
+	}
+}
+
+// Parse a level file line without a string stream (levels can have many thousands of lines, e.g. hot reload),
+// returns false if the line is not a game object, "LevelObject.LevelObjectID" is 0 if the line has no level object ID
+static bool ParseLevelFileLine(const char* Line, SLevelFileObject& LevelObject)
+{
+	char* End = nullptr;
+	LevelObject.GameObjectID = (int)std::strtol(Line, &End, 10);
+	if (End == Line)
+	{
+		return false;
+	}
+
+	Line = End;
+	LevelObject.Location.X = std::strtof(Line, &End);
+	if (End == Line)
+	{
+		return false;
+	}
+
+	Line = End;
+	LevelObject.Location.Y = std::strtof(Line, &End);
+	if (End == Line)
+	{
+		return false;
+	}
+
+	Line = End;
+	LevelObject.LevelObjectID = (uint32_t)std::strtoul(Line, &End, 10);
+	if (End == Line)
+	{
+		LevelObject.LevelObjectID = 0;
+	}
+
+	return true;
+}
+
+bool ReadLevelFile(const wchar_t* FileName, std::vector<SLevelFileObject>& LevelObjects,
+	SLevelEditJournal* Journal, STilemap* Tilemap)
+{
+	LevelObjects.clear();
+	if (Tilemap)
+	{
+		*Tilemap = STilemap();
+	}
+
+	std::ifstream File;
+	OpenPlatformFile(File, FileName, std::ios_base::in);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	std::unordered_map<uint32_t, int> LevelObjectIndices;
+	bool MissingLevelObjectIDs = false;
+
+	std::string Line;
+	while (getline(File, Line))
+	{
+		SLevelFileObject LevelObject;
+		if (!ParseLevelFileLine(Line.c_str(), LevelObject))
+		{
+			if (Tilemap)
+			{
+				ParseTilemapLine(Line.c_str(), Tilemap);
+			}
+			continue;
+		}
+
+		// Level saved before level object IDs were added
+		if (LevelObject.LevelObjectID == 0)
+		{
+			LevelObject.LevelObjectID = (uint32_t)LevelObjects.size() + 1;
+			MissingLevelObjectIDs = true;
+		}
+
+		LevelObjectIndices[LevelObject.LevelObjectID] = (int)LevelObjects.size();
+		LevelObjects.push_back(LevelObject);
+	}
+	File.close();
+
+	int NumJournalOperations = 0;
+	bool JournalCutOff = false;
+	std::ifstream JournalFile;
+	OpenPlatformFile(JournalFile, GetLevelJournalFileName(FileName).c_str(), std::ios_base::in);
+	if (JournalFile.is_open())
+	{
+		while (getline(JournalFile, Line))
+		{
+			// Every operation ends with a new line, the last operation was cut off while being saved
+			if (JournalFile.eof())
+			{
+				JournalCutOff = true;
+				break;
+			}
+
+			std::stringstream Stream(Line);
+			std::string Type;
+			if (!(Stream >> Type))
+			{
+				continue;
+			}
+
+			ApplyJournalOperationToLevelObjects(Type, Stream, LevelObjects, LevelObjectIndices, Tilemap);
+			NumJournalOperations++;
+		}
+		JournalFile.close();
+	}
+
+	uint32_t MaxLevelObjectID = 0;
+	for (int i = 0; i < LevelObjects.size(); ++i)
+	{
+		MaxLevelObjectID = std::max(MaxLevelObjectID, LevelObjects[i].LevelObjectID);
+	}
+
+	LevelObjects.erase(std::remove_if(LevelObjects.begin(), LevelObjects.end(),
+		[](const SLevelFileObject& LevelObject) { return LevelObject.GameObjectID < 0; }), LevelObjects.end());
+
+	if (Journal)
+	{
+		Journal->LevelFileName = FileName;
+		Journal->NextLevelObjectID = MaxLevelObjectID + 1;
+		Journal->LevelObjects.clear();
+		Journal->UndoEdits.clear();
+		Journal->RedoEdits.clear();
+		Journal->EditDepth = 0;
+		Journal->CurrentEdit.Operations.clear();
+		Journal->UnsavedOperations.clear();
+		Journal->NumJournalOperations = NumJournalOperations;
+		// Operations can't be appended after a cut off operation
+		Journal->CompactOnNextSave = MissingLevelObjectIDs || JournalCutOff;
+	}
+
+	return true;
+}
+
+void AssignLevelObjectID(SLevelEditJournal* Journal, GameObject* LevelObject, uint32_t LevelObjectID)
+{
+	if (LevelObjectID == 0)
+	{
+		LevelObjectID = Journal->NextLevelObjectID;
+	}
+
+	Journal->NextLevelObjectID = std::max(Journal->NextLevelObjectID, LevelObjectID + 1);
+	LevelObject->GetColdData()->LevelObjectID = LevelObjectID;
+	Journal->LevelObjects[LevelObjectID] = LevelObject;
+}
+
+void RemoveLevelObjectID(SLevelEditJournal* Journal, GameObject* LevelObject)
+{
+	auto Iterator = Journal->LevelObjects.find(LevelObject->GetLevelObjectID());
+	if (Iterator != Journal->LevelObjects.end() &&
+		Iterator->second == LevelObject)
+	{
+		Journal->LevelObjects.erase(Iterator);
+	}
+}
+
+GameObject* GetLevelObject(SLevelEditJournal* Journal, uint32_t LevelObjectID)
+{
+	auto Iterator = Journal->LevelObjects.find(LevelObjectID);
+	if (Iterator == Journal->LevelObjects.end())
+	{
+		return nullptr;
+	}
+
+	return Iterator->second;
+}
+
+static void PushUndoEdit(SLevelEditJournal* Journal, SLevelEdit& Edit)
+{
+	if (Journal->UndoEdits.size() >= LEVELJOURNAL_MAXNUM_UNDO_EDITS)
+	{
+		Journal->UndoEdits.erase(Journal->UndoEdits.begin());
+	}
+
+	Journal->UndoEdits.push_back(std::move(Edit));
+}
+
+static void RecordLevelEditOperation(SLevelEditJournal* Journal, const SLevelEditOperation& Operation)
+{
+	Journal->UnsavedOperations.push_back(Operation);
+	// A new edit can't be redone on top of undone edits
+	Journal->RedoEdits.clear();
+
+	if (Journal->EditDepth > 0)
+	{
+		Journal->CurrentEdit.Operations.push_back(Operation);
+		return;
+	}
+
+	SLevelEdit Edit;
+	Edit.Operations.push_back(Operation);
+	PushUndoEdit(Journal, Edit);
+}
+
+void BeginLevelEdit(SLevelEditJournal* Journal)
+{
+	Journal->EditDepth++;
+}
+
+void EndLevelEdit(SLevelEditJournal* Journal)
+{
+	if (Journal->EditDepth == 0 ||
+		--Journal->EditDepth > 0 ||
+		Journal->CurrentEdit.Operations.empty())
+	{
+		return;
+	}
+
+	PushUndoEdit(Journal, Journal->CurrentEdit);
+	Journal->CurrentEdit.Operations.clear();
+}
+
+void RecordLevelObjectCreated(SLevelEditJournal* Journal, GameObject* CreatedObject)
+{
+	if (CreatedObject->GetLevelObjectID() == 0)
+	{
+		AssignLevelObjectID(Journal, CreatedObject);
+	}
+
+	SLevelEditOperation Operation;
+	Operation.Type = LevelEditOperation_Create;
+	Operation.LevelObjectID = CreatedObject->GetLevelObjectID();
+	Operation.GameObjectID = CreatedObject->GameObjectID;
+	Operation.ToLocation = CreatedObject->Location;
+	RecordLevelEditOperation(Journal, Operation);
+}
+
+void RecordLevelObjectDeleted(SLevelEditJournal* Journal, GameObject* DeletedObject)
+{
+	// Game object is not part of the edited level
+	if (DeletedObject->GetLevelObjectID() == 0)
+	{
+		return;
+	}
+
+	SLevelEditOperation Operation;
+	Operation.Type = LevelEditOperation_Delete;
+	Operation.LevelObjectID = DeletedObject->GetLevelObjectID();
+	Operation.GameObjectID = DeletedObject->GameObjectID;
+	Operation.FromLocation = DeletedObject->Location;
+	RecordLevelEditOperation(Journal, Operation);
+}
+
+void RecordLevelObjectMoved(SLevelEditJournal* Journal, GameObject* MovedObject, SVector FromLocation)
+{
+	if (MovedObject->GetLevelObjectID() == 0 ||
+		(MovedObject->Location.X == FromLocation.X &&
+		MovedObject->Location.Y == FromLocation.Y))
+	{
+		return;
+	}
+
+	SLevelEditOperation Operation;
+	Operation.Type = LevelEditOperation_Move;
+	Operation.LevelObjectID = MovedObject->GetLevelObjectID();
+	Operation.GameObjectID = MovedObject->GameObjectID;
+	Operation.FromLocation = FromLocation;
+	Operation.ToLocation = MovedObject->Location;
+	RecordLevelEditOperation(Journal, Operation);
+}
+
+void RecordTilePainted(SLevelEditJournal* Journal,
+	int RenderLayer, float TileSize, int Column, int Row, int FromTileID, int ToTileID)
+{
+	if (FromTileID == ToTileID)
+	{
+		return;
+	}
+
+	SLevelEditOperation Operation;
+	Operation.Type = LevelEditOperation_Tile;
+	Operation.GameObjectID = ToTileID;
+	Operation.RenderLayer = RenderLayer;
+	Operation.TileSize = TileSize;
+	Operation.TileColumn = Column;
+	Operation.TileRow = Row;
+	Operation.FromTileID = FromTileID;
+	RecordLevelEditOperation(Journal, Operation);
+}
+
+static SLevelEditOperation GetInverseLevelEditOperation(const SLevelEditOperation& Operation)
+{
+	SLevelEditOperation InverseOperation = Operation;
+	InverseOperation.FromLocation = Operation.ToLocation;
+	InverseOperation.ToLocation = Operation.FromLocation;
+
+	switch (Operation.Type)
+	{
+	case LevelEditOperation_Create:
+		InverseOperation.Type = LevelEditOperation_Delete;
+		break;
+	case LevelEditOperation_Delete:
+		InverseOperation.Type = LevelEditOperation_Create;
+		break;
+	case LevelEditOperation_Move:
+		break;
+	case LevelEditOperation_Tile:
+		InverseOperation.GameObjectID = Operation.FromTileID;
+		InverseOperation.FromTileID = Operation.GameObjectID;
+		break;
+	}
+
+	return InverseOperation;
+}
+
+// Apply an operation to the stored game objects (undo/redo), the operation is saved by the next save.
+// A deleted game object is only added to "DeletedObjects" (no longer found by its level object ID),
+// all game objects deleted by an edit are deleted in one batch once the whole edit is applied
+static void ApplyLevelEditOperation(
+	VoodooEngine* Engine, const SLevelEditOperation& Operation, std::vector<GameObject*>& DeletedObjects)
+{
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	GameObject* LevelObject = GetLevelObject(Journal, Operation.LevelObjectID);
+
+	switch (Operation.Type)
+	{
+	case LevelEditOperation_Create:
+	{
+		if (LevelObject ||
+			!Engine->FunctionPointer_LoadGameObjects)
+		{
+			return;
+		}
+
+		// Game object is created the same way as from the asset browser
+		size_t NumGameObjects = Engine->StoredGameObjects.size();
+		std::vector<GameObject*> EmptyVector;
+		Engine->FunctionPointer_LoadGameObjects(Operation.GameObjectID, Operation.ToLocation, EmptyVector);
+		if (Engine->StoredGameObjects.size() == NumGameObjects)
+		{
+			return;
+		}
+
+		AssignLevelObjectID(Journal, Engine->StoredGameObjects.back(), Operation.LevelObjectID);
+		break;
+	}
+	case LevelEditOperation_Delete:
+		if (!LevelObject)
+		{
+			return;
+		}
+
+		RemoveLevelObjectID(Journal, LevelObject);
+		DeletedObjects.push_back(LevelObject);
+		break;
+	case LevelEditOperation_Move:
+		if (!LevelObject)
+		{
+			return;
+		}
+
+		SetGameObjectLocation(LevelObject, Operation.ToLocation);
+		MoveEditorPickingObject(&Engine->EditorPicking, LevelObject);
+		break;
+	case LevelEditOperation_Tile:
+		SetTile(&GetEditedTilemap(Engine, true)->Tilemap, Operation.RenderLayer, Operation.TileSize,
+			Operation.TileColumn, Operation.TileRow, Operation.GameObjectID);
+		break;
+	}
+
+	Journal->UnsavedOperations.push_back(Operation);
+}
+
+bool UndoLevelEdit(VoodooEngine* Engine)
+{
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	if (Journal->UndoEdits.empty() ||
+		Journal->EditDepth > 0)
+	{
+		return false;
+	}
+
+	SLevelEdit Edit = std::move(Journal->UndoEdits.back());
+	Journal->UndoEdits.pop_back();
+
+	std::vector<GameObject*> DeletedObjects;
+	for (int i = (int)Edit.Operations.size() - 1; i >= 0; --i)
+	{
+		ApplyLevelEditOperation(Engine, GetInverseLevelEditOperation(Edit.Operations[i]), DeletedObjects);
+	}
+	Engine->DeleteGameObjects(DeletedObjects);
+
+	Journal->RedoEdits.push_back(std::move(Edit));
+	return true;
+}
+
+bool RedoLevelEdit(VoodooEngine* Engine)
+{
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	if (Journal->RedoEdits.empty() ||
+		Journal->EditDepth > 0)
+	{
+		return false;
+	}
+
+	SLevelEdit Edit = std::move(Journal->RedoEdits.back());
+	Journal->RedoEdits.pop_back();
+
+	std::vector<GameObject*> DeletedObjects;
+	for (int i = 0; i < Edit.Operations.size(); ++i)
+	{
+		ApplyLevelEditOperation(Engine, Edit.Operations[i], DeletedObjects);
+	}
+	Engine->DeleteGameObjects(DeletedObjects);
+
+	PushUndoEdit(Journal, Edit);
+	return true;
+}
+
+bool IsLevelFileRewriteNeeded(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	int NumOperations = Journal->NumJournalOperations + (int)Journal->UnsavedOperations.size();
+
+	// The journal only describes the level it was read with,
+	// and game objects created outside of the level editor are only saved by a rewrite
+	// (the tilemap is not a level object, its tiles are journaled as tile operations)
+	return Journal->CompactOnNextSave ||
+		Journal->LevelFileName != FileName ||
+		Journal->LevelObjects.size() != Engine->StoredGameObjects.size() - Engine->StoredTilemaps.size() ||
+		(NumOperations > LEVELJOURNAL_MIN_COMPACT_OPERATIONS &&
+		NumOperations > (int)Journal->LevelObjects.size());
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "SVector.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Level edit journal
+//---------------------
+// Records the edits made in the level editor (game objects created, deleted and moved, tiles painted) for undo/redo,
+// an edit can contain many operations (e.g. moving a box selection) and is undone as a single step.
+// Game objects of the edited level have a persistent "LevelObjectID" (stored in the level file),
+// so operations stay valid after a game object has been deleted and created again by undo/redo.
+//
+// Saving (see "LevelSave.h") appends the operations applied since the last save to a journal file
+// next to the level file ("<LevelFile>.journal") instead of rewriting the whole level, so a save costs as much
+// as the edits made, the level file is rewritten (compacted) and the journal emptied once the journal grows
+// larger than the level.
+// Loading a level applies its journal on top of the level file before any game object is created.
+//
+// Level file format (one game object per line, levels saved without level object IDs get IDs in line order,
+// tile rows of the level tilemap are lines of their own, see "Tilemap.h"):
+//   <GameObjectID> <X> <Y> <LevelObjectID>
+// Journal file format (one operation per line):
+//   create <LevelObjectID> <GameObjectID> <X> <Y>
+//   delete <LevelObjectID>
+//   move <LevelObjectID> <X> <Y>
+//   tile <RenderLayer> <TileSize> <Column> <Row> <TileID>
+//---------------------
+
+// Journal is compacted when it has more operations than this and more operations than game objects in the level
+#define LEVELJOURNAL_MIN_COMPACT_OPERATIONS 4096
+#define LEVELJOURNAL_MAXNUM_UNDO_EDITS 256
+#define LEVELJOURNAL_FILE_EXTENSION L".journal"
+
+class GameObject;
+class VoodooEngine;
+struct STilemap;
+
+inline std::wstring GetLevelJournalFileName(const wchar_t* LevelFileName)
+{
+	return std::wstring(LevelFileName) + LEVELJOURNAL_FILE_EXTENSION;
+}
+
+enum ELevelEditOperationType
+{
+	LevelEditOperation_Create = 0,
+	LevelEditOperation_Delete = 1,
+	LevelEditOperation_Move = 2,
+	LevelEditOperation_Tile = 3
+};
+
+struct SLevelEditOperation
+{
+	ELevelEditOperationType Type = LevelEditOperation_Create;
+	uint32_t LevelObjectID = 0;
+	int GameObjectID = -1;
+	// Location before the operation (delete/move)
+	SVector FromLocation;
+	// Location after the operation (create/move)
+	SVector ToLocation;
+	// Cell of a tile operation, "GameObjectID" is the tile ID after the operation (see "Tilemap.h")
+	int RenderLayer = 0;
+	float TileSize = 0;
+	int TileColumn = 0;
+	int TileRow = 0;
+	int FromTileID = 0;
+};
+
+struct SLevelEdit
+{
+	std::vector<SLevelEditOperation> Operations;
+};
+
+// Game object read from a level file (with its journal applied)
+struct SLevelFileObject
+{
+	int GameObjectID = -1;
+	SVector Location;
+	uint32_t LevelObjectID = 0;
+};
+
+struct SLevelEditJournal
+{
+	// Level file the journal belongs to
+	std::wstring LevelFileName;
+	uint32_t NextLevelObjectID = 1;
+	std::unordered_map<uint32_t, GameObject*> LevelObjects;
+
+	std::vector<SLevelEdit> UndoEdits;
+	std::vector<SLevelEdit> RedoEdits;
+	// Edit recorded between "BeginLevelEdit" and "EndLevelEdit"
+	int EditDepth = 0;
+	SLevelEdit CurrentEdit;
+
+	// Operations applied since the last save (recorded, undone or redone)
+	std::vector<SLevelEditOperation> UnsavedOperations;
+	// Number of operations in the journal file
+	int NumJournalOperations = 0;
+	// Set if the level file has to be rewritten by the next save (e.g. level file without level object IDs)
+	bool CompactOnNextSave = true;
+};
+
+// Read all game objects of a level file with its journal applied, returns false if the level file could not be opened,
+// if "Journal" is passed it is reset for the read level (used when the level is opened for editing),
+// the tiles of the level are read into "Tilemap" if set (emptied first)
+extern "C" VOODOOENGINE_API bool ReadLevelFile(const wchar_t* FileName, std::vector<SLevelFileObject>& LevelObjects,
+	SLevelEditJournal* Journal = nullptr, STilemap* Tilemap = nullptr);
+
+// Register a game object of the edited level, a new ID is assigned if "LevelObjectID" is 0
+extern "C" VOODOOENGINE_API void AssignLevelObjectID(
+	SLevelEditJournal* Journal, GameObject* LevelObject, uint32_t LevelObjectID = 0);
+// Called by the engine when a game object is deleted
+extern "C" VOODOOENGINE_API void RemoveLevelObjectID(SLevelEditJournal* Journal, GameObject* LevelObject);
+// Returns nullptr if no game object has the ID
+extern "C" VOODOOENGINE_API GameObject* GetLevelObject(SLevelEditJournal* Journal, uint32_t LevelObjectID);
+
+// Operations recorded between begin/end are undone as a single edit
+// (an operation recorded outside of begin/end is an edit on its own)
+extern "C" VOODOOENGINE_API void BeginLevelEdit(SLevelEditJournal* Journal);
+extern "C" VOODOOENGINE_API void EndLevelEdit(SLevelEditJournal* Journal);
+// Record a game object created by the level editor (after it has been created)
+extern "C" VOODOOENGINE_API void RecordLevelObjectCreated(SLevelEditJournal* Journal, GameObject* CreatedObject);
+// Record a game object deleted by the level editor (before it is deleted)
+extern "C" VOODOOENGINE_API void RecordLevelObjectDeleted(SLevelEditJournal* Journal, GameObject* DeletedObject);
+// Record a game object moved by the level editor (after it has been moved)
+extern "C" VOODOOENGINE_API void RecordLevelObjectMoved(
+	SLevelEditJournal* Journal, GameObject* MovedObject, SVector FromLocation);
+// Record a tile painted/erased by the level editor (after the tilemap has been changed)
+extern "C" VOODOOENGINE_API void RecordTilePainted(SLevelEditJournal* Journal,
+	int RenderLayer, float TileSize, int Column, int Row, int FromTileID, int ToTileID);
+
+// Undo/redo the last edit, returns false if there is nothing to undo/redo
+// (game objects deleted by undo/redo are deleted right away, so clear any pointer to them first)
+extern "C" VOODOOENGINE_API bool UndoLevelEdit(VoodooEngine* Engine);
+extern "C" VOODOOENGINE_API bool RedoLevelEdit(VoodooEngine* Engine);
+
+// True if saving to "FileName" has to rewrite the whole level file instead of appending to the journal
+// (journal of another level/too large, level file without level object IDs, game objects not in the journal)
+extern "C" VOODOOENGINE_API bool IsLevelFileRewriteNeeded(VoodooEngine* Engine, const wchar_t* FileName);
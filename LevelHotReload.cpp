@@ -0,0 +1,169 @@
+#include "LevelHotReload.h"
+#include "VoodooEngine.h"
+
+void WatchLevelFile(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	Engine->LevelHotReload.FileName = FileName;
+	Engine->LevelHotReload.TimeSinceLastPoll = 0;
+	SyncLevelFileWriteTime(Engine);
+}
+
+void StopWatchingLevelFile(VoodooEngine* Engine)
+{
+	Engine->LevelHotReload.FileName.clear();
+}
+
+void SyncLevelFileWriteTime(VoodooEngine* Engine)
+{
+	SLevelHotReload* HotReload = &Engine->LevelHotReload;
+	if (HotReload->FileName.empty())
+	{
+		return;
+	}
+
+	HotReload->LevelFileWriteTime = GetPlatformFileWriteTime(HotReload->FileName.c_str());
+	HotReload->JournalFileWriteTime = GetPlatformFileWriteTime(GetLevelJournalFileName(HotReload->FileName.c_str()).c_str());
+	HotReload->PolledLevelFileWriteTime = HotReload->LevelFileWriteTime;
+	HotReload->PolledJournalFileWriteTime = HotReload->JournalFileWriteTime;
+}
+
+bool HasLevelFileChanged(VoodooEngine* Engine, float DeltaTime)
+{
+	SLevelHotReload* HotReload = &Engine->LevelHotReload;
+	if (HotReload->FileName.empty())
+	{
+		return false;
+	}
+
+	HotReload->TimeSinceLastPoll += DeltaTime;
+	// Files written by a running save are not a change
+	if (HotReload->TimeSinceLastPoll < LEVELHOTRELOAD_POLL_INTERVAL ||
+		IsLevelSaving(Engine))
+	{
+		return false;
+	}
+	HotReload->TimeSinceLastPoll = 0;
+
+	uint64_t LevelFileWriteTime = GetPlatformFileWriteTime(HotReload->FileName.c_str());
+	uint64_t JournalFileWriteTime = GetPlatformFileWriteTime(GetLevelJournalFileName(HotReload->FileName.c_str()).c_str());
+	if (LevelFileWriteTime == HotReload->LevelFileWriteTime &&
+		JournalFileWriteTime == HotReload->JournalFileWriteTime)
+	{
+		return false;
+	}
+
+	// Still being written (level file removed while being replaced or written since the last poll)
+	if (LevelFileWriteTime == 0 ||
+		LevelFileWriteTime != HotReload->PolledLevelFileWriteTime ||
+		JournalFileWriteTime != HotReload->PolledJournalFileWriteTime)
+	{
+		HotReload->PolledLevelFileWriteTime = LevelFileWriteTime;
+		HotReload->PolledJournalFileWriteTime = JournalFileWriteTime;
+		return false;
+	}
+
+	return true;
+}
+
+bool HotReloadLevel(VoodooEngine* Engine, SLevelReloadResult* Result)
+{
+	SLevelHotReload* HotReload = &Engine->LevelHotReload;
+	if (HotReload->FileName.empty())
+	{
+		return false;
+	}
+
+	VOODOO_PROFILE_SCOPE("HotReloadLevel");
+
+	// A running save would write the level from before the reload
+	WaitForLevelSave(Engine);
+
+	// Write times are taken before reading, so a change made while reading is reloaded by the next poll
+	SyncLevelFileWriteTime(Engine);
+
+	// Game objects in the level before the reload (reading the level resets the journal)
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	std::unordered_map<uint32_t, GameObject*> PreviousLevelObjects;
+	PreviousLevelObjects.swap(Journal->LevelObjects);
+
+	std::vector<SLevelFileObject> LevelObjects;
+	STilemap Tilemap;
+	if (!ReadLevelFile(HotReload->FileName.c_str(), LevelObjects, Journal, &Tilemap))
+	{
+		Journal->LevelObjects.swap(PreviousLevelObjects);
+		return false;
+	}
+
+	SLevelReloadResult Reload;
+
+	// Game objects still in the level are kept (and moved if their location changed),
+	// game objects left in "PreviousLevelObjects" are not in the level anymore
+	std::vector<int> LevelObjectsToCreate;
+	for (int i = 0; i < LevelObjects.size(); ++i)
+	{
+		const SLevelFileObject& LevelObject = LevelObjects[i];
+		auto Iterator = PreviousLevelObjects.find(LevelObject.LevelObjectID);
+		if (Iterator == PreviousLevelObjects.end() ||
+			Iterator->second->GameObjectID != LevelObject.GameObjectID)
+		{
+			LevelObjectsToCreate.push_back(i);
+			continue;
+		}
+
+		GameObject* KeptObject = Iterator->second;
+		PreviousLevelObjects.erase(Iterator);
+		AssignLevelObjectID(Journal, KeptObject, LevelObject.LevelObjectID);
+
+		if (KeptObject->Location.X != LevelObject.Location.X ||
+			KeptObject->Location.Y != LevelObject.Location.Y)
+		{
+			SetGameObjectLocation(KeptObject, LevelObject.Location);
+			MoveEditorPickingObject(&Engine->EditorPicking, KeptObject);
+			Reload.NumMoved++;
+		}
+	}
+
+	// Deleted at once, the stored vectors are walked once instead of once per deleted game object
+	std::vector<GameObject*> GameObjectsToDelete;
+	GameObjectsToDelete.reserve(PreviousLevelObjects.size());
+	for (auto& PreviousLevelObject : PreviousLevelObjects)
+	{
+		GameObjectsToDelete.push_back(PreviousLevelObject.second);
+	}
+	Engine->DeleteGameObjects(GameObjectsToDelete);
+	Reload.NumDeleted = (int)GameObjectsToDelete.size();
+
+	if (Engine->FunctionPointer_LoadGameObjects)
+	{
+		std::vector<GameObject*> EmptyVector;
+		for (int i = 0; i < LevelObjectsToCreate.size(); ++i)
+		{
+			const SLevelFileObject& LevelObject = LevelObjects[LevelObjectsToCreate[i]];
+
+			// Game object is created the same way as when the level is loaded
+			size_t NumGameObjects = Engine->StoredGameObjects.size();
+			Engine->FunctionPointer_LoadGameObjects(LevelObject.GameObjectID, LevelObject.Location, EmptyVector);
+			if (Engine->StoredGameObjects.size() == NumGameObjects)
+			{
+				continue;
+			}
+
+			AssignLevelObjectID(Journal, Engine->StoredGameObjects.back(), LevelObject.LevelObjectID);
+			Reload.NumCreated++;
+		}
+	}
+
+	// Tiles are replaced as a whole (the tilemap is not a level object)
+	TilemapGameObject* EditedTilemap = GetEditedTilemap(Engine, !IsTilemapEmpty(&Tilemap));
+	if (EditedTilemap)
+	{
+		EditedTilemap->Tilemap = std::move(Tilemap);
+	}
+
+	if (Result)
+	{
+		*Result = Reload;
+	}
+
+	return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <cstdint>
+#include <string>
+
+// Level hot reload
+//---------------------
+// Watches the level opened in the level editor (level file and its journal) and reloads it when it is changed
+// outside of the editor (e.g. by a level generator or a text editor).
+// Files are polled for their write time, a change is only reloaded once the files have not been written
+// for one poll (so a file still being written is never read).
+//
+// A reload does not delete and create the whole level, the level read from file is compared with the game objects
+// in the level by their level object IDs (see "LevelEditJournal.h"), and only game objects that were added,
+// removed, moved or given another game object ID are created/deleted/moved.
+// The tiles of the level (see "Tilemap.h") are replaced as a whole.
+// The level file is the truth after a reload, unsaved edits and undo/redo are dropped.
+//---------------------
+
+#define LEVELHOTRELOAD_POLL_INTERVAL 0.25f
+
+class VoodooEngine;
+
+struct SLevelHotReload
+{
+	// Watched level, empty if no level is watched
+	std::wstring FileName;
+	float TimeSinceLastPoll = 0;
+	// Write time of the level/journal file when the level was last read or saved
+	uint64_t LevelFileWriteTime = 0;
+	uint64_t JournalFileWriteTime = 0;
+	// Write times seen by the last poll, a change is reloaded when two polls in a row see the same write times
+	uint64_t PolledLevelFileWriteTime = 0;
+	uint64_t PolledJournalFileWriteTime = 0;
+};
+
+struct SLevelReloadResult
+{
+	int NumCreated = 0;
+	int NumDeleted = 0;
+	int NumMoved = 0;
+};
+
+// Start watching a level file (called by the engine when a level is opened in the level editor)
+extern "C" VOODOOENGINE_API void WatchLevelFile(VoodooEngine* Engine, const wchar_t* FileName);
+extern "C" VOODOOENGINE_API void StopWatchingLevelFile(VoodooEngine* Engine);
+// Take the current files as read (called by the engine when the level has been saved)
+extern "C" VOODOOENGINE_API void SyncLevelFileWriteTime(VoodooEngine* Engine);
+// Poll the watched level (files are only polled every "LEVELHOTRELOAD_POLL_INTERVAL" seconds),
+// returns true if it has been changed outside of the engine and should be reloaded
+extern "C" VOODOOENGINE_API bool HasLevelFileChanged(VoodooEngine* Engine, float DeltaTime);
+// Reload the watched level by only applying what differs from the game objects in the level
+// (game objects deleted by the reload are deleted right away, so clear any pointer to them first),
+// returns false if the level file could not be read
+extern "C" VOODOOENGINE_API bool HotReloadLevel(VoodooEngine* Engine, SLevelReloadResult* Result = nullptr);
@@ -0,0 +1,399 @@
+#include "LevelManager.h"
+#include "VoodooEngine.h"
+#include <algorithm>
+
+static size_t GetCachedLevelMemoryUsage(const SCachedLevel& Level)
+{
+	return Level.GameObjects.size() * LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE +
+		Level.GameObjects.capacity() * sizeof(GameObject*);
+}
+
+static void TouchCachedLevel(SLevelManager* LevelManager, SCachedLevel* Level)
+{
+	Level->LastUsed = ++LevelManager->UseCounter;
+}
+
+static SCachedLevel* FindCachedLevel(SLevelManager* LevelManager, const wchar_t* FileName)
+{
+	auto Iterator = LevelManager->CachedLevels.find(FileName);
+	if (Iterator == LevelManager->CachedLevels.end())
+	{
+		return nullptr;
+	}
+
+	return &Iterator->second;
+}
+
+static void RemoveCachedLevel(VoodooEngine* Engine, SCachedLevel* Level)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+
+	for (int i = 0; i < Level->GameObjects.size(); ++i)
+	{
+		Level->GameObjects[i]->SetCachedLevel(nullptr);
+	}
+	Engine->DeleteGameObjects(Level->GameObjects);
+
+	FreeLevelSlot(LevelManager, Level->LevelSlot);
+	LevelManager->MemoryUsage -= Level->MemoryUsage;
+	std::wstring FileName = Level->FileName;
+	LevelManager->CachedLevels.erase(FileName);
+}
+
+SCachedLevel* PreloadLevel(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+	SCachedLevel* Level = FindCachedLevel(LevelManager, FileName);
+	if (Level)
+	{
+		return Level;
+	}
+
+	// Level is being loaded in the background (see "LevelPreload.h")
+	if (IsLevelPreloading(Engine, FileName))
+	{
+		FinishLevelPreload(Engine);
+		Level = FindCachedLevel(LevelManager, FileName);
+		if (Level)
+		{
+			return Level;
+		}
+	}
+
+	VOODOO_PROFILE_SCOPE("PreloadLevel");
+
+	std::vector<GameObject*> LevelGameObjects;
+	if (!Engine->LoadLevelFromFile(Engine, FileName, LevelGameObjects))
+	{
+		return nullptr;
+	}
+
+	return AddCachedLevel(Engine, FileName, LevelGameObjects);
+}
+
+SCachedLevel* AddCachedLevel(
+	VoodooEngine* Engine, const wchar_t* FileName, std::vector<GameObject*>& GameObjects, int LevelSlot)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+
+	// Already cached (e.g. loaded while it was preloaded), the cached level is kept as it is
+	// (it may be the active level) and the game objects given are a second copy of it
+	SCachedLevel* CachedLevel = FindCachedLevel(LevelManager, FileName);
+	if (CachedLevel)
+	{
+		Engine->DeleteGameObjects(GameObjects);
+		GameObjects.clear();
+		FreeLevelSlot(LevelManager, LevelSlot);
+		TouchCachedLevel(LevelManager, CachedLevel);
+		return CachedLevel;
+	}
+
+	bool NewLevelSlot = LevelSlot == 0;
+	if (NewLevelSlot)
+	{
+		// Given out before the level is added, it may evict a level
+		LevelSlot = AllocateLevelSlot(Engine);
+	}
+
+	SCachedLevel* Level = &LevelManager->CachedLevels[FileName];
+	Level->FileName = FileName;
+	Level->GameObjects.swap(GameObjects);
+	Level->LevelSlot = LevelSlot;
+
+	// Hidden by the disabled level slot until the level is activated
+	for (int i = 0; i < Level->GameObjects.size(); ++i)
+	{
+		Level->GameObjects[i]->SetCachedLevel(Level);
+		if (NewLevelSlot)
+		{
+			Level->GameObjects[i]->SetGameObjectLevelSlot(LevelSlot);
+		}
+	}
+
+	Level->MemoryUsage = GetCachedLevelMemoryUsage(*Level);
+	LevelManager->MemoryUsage += Level->MemoryUsage;
+	TouchCachedLevel(LevelManager, Level);
+	return Level;
+}
+
+int AllocateLevelSlot(VoodooEngine* Engine)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+	while (LevelManager->UsedLevelSlots == ~0ull)
+	{
+		SCachedLevel* LeastRecentlyUsedLevel = nullptr;
+		for (auto& CachedLevel : LevelManager->CachedLevels)
+		{
+			if (&CachedLevel.second != LevelManager->ActiveLevel &&
+				(!LeastRecentlyUsedLevel || CachedLevel.second.LastUsed < LeastRecentlyUsedLevel->LastUsed))
+			{
+				LeastRecentlyUsedLevel = &CachedLevel.second;
+			}
+		}
+
+		// Only the active level is left (a preload is the only other user of a level slot, so not reached)
+		if (!LeastRecentlyUsedLevel)
+		{
+			return 0;
+		}
+
+		RemoveCachedLevel(Engine, LeastRecentlyUsedLevel);
+	}
+
+	int LevelSlot = 1;
+	while ((LevelManager->UsedLevelSlots >> LevelSlot) & 1)
+	{
+		LevelSlot++;
+	}
+
+	LevelManager->UsedLevelSlots |= 1ull << LevelSlot;
+	SetLevelSlotEnabled(LevelSlot, false);
+	return LevelSlot;
+}
+
+void FreeLevelSlot(SLevelManager* LevelManager, int LevelSlot)
+{
+	if (LevelSlot <= 0)
+	{
+		return;
+	}
+
+	LevelManager->UsedLevelSlots &= ~(1ull << LevelSlot);
+	SetLevelSlotEnabled(LevelSlot, false);
+}
+
+// Player start objects are hidden, the search is only done again if the level is activated with other IDs
+static void FindCachedLevelPlayerStarts(SCachedLevel* Level, const int* PlayerStartIDs)
+{
+	bool SameIDs = true;
+	for (int i = 0; i < LEVELMANAGER_NUM_PLAYER_STARTS; ++i)
+	{
+		SameIDs = SameIDs && Level->PlayerStartIDs[i] == PlayerStartIDs[i];
+	}
+	if (SameIDs)
+	{
+		return;
+	}
+
+	for (int i = 0; i < LEVELMANAGER_NUM_PLAYER_STARTS; ++i)
+	{
+		Level->PlayerStartIDs[i] = PlayerStartIDs[i];
+		Level->PlayerStartObjects[i] = nullptr;
+	}
+
+	for (int i = 0; i < Level->GameObjects.size(); ++i)
+	{
+		for (int j = 0; j < LEVELMANAGER_NUM_PLAYER_STARTS; ++j)
+		{
+			if (Level->GameObjects[i]->GameObjectID == PlayerStartIDs[j])
+			{
+				Level->PlayerStartObjects[j] = Level->GameObjects[i];
+				Level->GameObjects[i]->SetGameObjectState(false);
+			}
+		}
+	}
+}
+
+void PreloadNeighbourLevels(VoodooEngine* Engine, const std::vector<std::wstring>& NeighbourFileNames)
+{
+	for (int i = 0; i < NeighbourFileNames.size(); ++i)
+	{
+		PreloadLevel(Engine, NeighbourFileNames[i].c_str());
+	}
+
+	EvictLevelsOverBudget(Engine);
+}
+
+bool ActivateCachedLevel(
+	VoodooEngine* Engine,
+	const wchar_t* FileName,
+	int PlayerID,
+	int PlayerStartLeftID,
+	int PlayerStartRightID,
+	int PlayerStartUpID,
+	int PlayerStartDownID,
+	BitmapComponent* LevelBackground)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+	SCachedLevel* Level = PreloadLevel(Engine, FileName);
+	if (!Level)
+	{
+		return false;
+	}
+
+	VOODOO_PROFILE_SCOPE("ActivateCachedLevel");
+
+	if (LevelBackground)
+	{
+		Engine->CurrentLevelBackground = LevelBackground;
+	}
+
+	if (LevelManager->ActiveLevel)
+	{
+		SetLevelSlotEnabled(LevelManager->ActiveLevel->LevelSlot, false);
+	}
+	else
+	{
+		// Game objects that are not part of a cached level are only disabled by the first activation
+		for (int i = 0; i < Engine->StoredGameObjects.size(); ++i)
+		{
+			if (!Engine->StoredGameObjects[i]->GetCachedLevel() &&
+				Engine->StoredGameObjects[i]->GameObjectID != PlayerID)
+			{
+				Engine->StoredGameObjects[i]->SetGameObjectState(false);
+			}
+		}
+	}
+	SetLevelSlotEnabled(Level->LevelSlot, true);
+
+	int PlayerStartIDs[LEVELMANAGER_NUM_PLAYER_STARTS] =
+		{ PlayerStartLeftID, PlayerStartRightID, PlayerStartUpID, PlayerStartDownID };
+	FindCachedLevelPlayerStarts(Level, PlayerStartIDs);
+	Engine->PlayerStartObjectLeft = Level->PlayerStartObjects[0];
+	Engine->PlayerStartObjectRight = Level->PlayerStartObjects[1];
+	Engine->PlayerStartObjectUp = Level->PlayerStartObjects[2];
+	Engine->PlayerStartObjectDown = Level->PlayerStartObjects[3];
+
+	LevelManager->ActiveLevel = Level;
+	TouchCachedLevel(LevelManager, Level);
+	EvictLevelsOverBudget(Engine);
+
+	for (int i = 0; i < Engine->InterfaceObjects_LevelActivated.size(); ++i)
+	{
+		Engine->InterfaceObjects_LevelActivated[i]->InterfaceEvent_LevelActivated();
+	}
+	return true;
+}
+
+bool EvictLevel(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+	SCachedLevel* Level = FindCachedLevel(LevelManager, FileName);
+	if (!Level ||
+		Level == LevelManager->ActiveLevel)
+	{
+		return false;
+	}
+
+	RemoveCachedLevel(Engine, Level);
+	return true;
+}
+
+void EvictLevelsOverBudget(VoodooEngine* Engine)
+{
+	SLevelManager* LevelManager = &Engine->LevelManager;
+	while (LevelManager->MemoryUsage > LevelManager->MemoryBudget)
+	{
+		SCachedLevel* LeastRecentlyUsedLevel = nullptr;
+		for (auto& CachedLevel : LevelManager->CachedLevels)
+		{
+			if (&CachedLevel.second == LevelManager->ActiveLevel)
+			{
+				continue;
+			}
+
+			if (!LeastRecentlyUsedLevel ||
+				CachedLevel.second.LastUsed < LeastRecentlyUsedLevel->LastUsed)
+			{
+				LeastRecentlyUsedLevel = &CachedLevel.second;
+			}
+		}
+
+		// Only the active level is left
+		if (!LeastRecentlyUsedLevel)
+		{
+			return;
+		}
+
+		VOODOO_PROFILE_SCOPE("EvictLevel");
+		RemoveCachedLevel(Engine, LeastRecentlyUsedLevel);
+	}
+}
+
+void SetLevelCacheMemoryBudget(VoodooEngine* Engine, size_t MemoryBudget)
+{
+	Engine->LevelManager.MemoryBudget = MemoryBudget;
+	EvictLevelsOverBudget(Engine);
+}
+
+void ResetLevelCache(SLevelManager* LevelManager)
+{
+	for (auto& CachedLevel : LevelManager->CachedLevels)
+	{
+		bool ActiveLevel = &CachedLevel.second == LevelManager->ActiveLevel;
+		for (int i = 0; i < CachedLevel.second.GameObjects.size(); ++i)
+		{
+			GameObject* LevelGameObject = CachedLevel.second.GameObjects[i];
+			LevelGameObject->SetCachedLevel(nullptr);
+			LevelGameObject->SetGameObjectLevelSlot(0);
+			if (!ActiveLevel)
+			{
+				LevelGameObject->SetGameObjectState(false);
+			}
+		}
+		FreeLevelSlot(LevelManager, CachedLevel.second.LevelSlot);
+	}
+
+	LevelManager->CachedLevels.clear();
+	LevelManager->ActiveLevel = nullptr;
+	LevelManager->MemoryUsage = 0;
+}
+
+void RemoveCachedLevelObject(SLevelManager* LevelManager, GameObject* DeletedObject)
+{
+	SCachedLevel* Level = DeletedObject->GetCachedLevel();
+	if (!Level)
+	{
+		return;
+	}
+
+	Level->GameObjects.erase(std::remove(Level->GameObjects.begin(), Level->GameObjects.end(), DeletedObject),
+		Level->GameObjects.end());
+	DeletedObject->SetCachedLevel(nullptr);
+	for (int i = 0; i < LEVELMANAGER_NUM_PLAYER_STARTS; ++i)
+	{
+		if (Level->PlayerStartObjects[i] == DeletedObject)
+		{
+			Level->PlayerStartObjects[i] = nullptr;
+		}
+	}
+
+	Level->MemoryUsage -= LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE;
+	LevelManager->MemoryUsage -= LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE;
+}
+
+void RemoveCachedLevelObjects(SLevelManager* LevelManager, const std::unordered_set<GameObject*>& DeletedObjects)
+{
+	// Only the levels the deleted game objects are part of are walked (once each)
+	std::vector<SCachedLevel*> Levels;
+	for (GameObject* DeletedObject : DeletedObjects)
+	{
+		if (DeletedObject->GetCachedLevel() &&
+			std::find(Levels.begin(), Levels.end(), DeletedObject->GetCachedLevel()) == Levels.end())
+		{
+			Levels.push_back(DeletedObject->GetCachedLevel());
+		}
+		DeletedObject->SetCachedLevel(nullptr);
+	}
+
+	for (int LevelIndex = 0; LevelIndex < Levels.size(); ++LevelIndex)
+	{
+		SCachedLevel* Level = Levels[LevelIndex];
+		size_t NumGameObjects = Level->GameObjects.size();
+		Level->GameObjects.erase(std::remove_if(Level->GameObjects.begin(), Level->GameObjects.end(),
+			[&DeletedObjects](GameObject* LevelObject) { return DeletedObjects.count(LevelObject) > 0; }),
+			Level->GameObjects.end());
+		size_t NumRemoved = NumGameObjects - Level->GameObjects.size();
+
+		for (int i = 0; i < LEVELMANAGER_NUM_PLAYER_STARTS; ++i)
+		{
+			if (DeletedObjects.count(Level->PlayerStartObjects[i]) > 0)
+			{
+				Level->PlayerStartObjects[i] = nullptr;
+			}
+		}
+
+		Level->MemoryUsage -= NumRemoved * LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE;
+		LevelManager->MemoryUsage -= NumRemoved * LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE;
+	}
+}
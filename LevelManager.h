@@ -0,0 +1,112 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "EnableMasks.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Level manager
+//---------------------
+// Cache of loaded levels for games made of many levels (e.g. a level per screen),
+// every cached level keeps its own list of game objects and has its own level slot in the enable masks
+// (see "EnableMasks.h"), so activating a level only disables the slot of the previous level and enables its own slot,
+// no game object is touched (instead of every stored game object, see "ActivateLevel").
+// Game objects keep their own state between activations (e.g. a game object disabled by the game stays disabled).
+//
+// Game objects of a cached level stay created (hidden by their level slot) while the level is not active,
+// once the cache uses more memory than its budget the least recently used levels are evicted
+// (their game objects deleted), the active level is never evicted.
+// Levels can be loaded ahead of time ("PreloadLevel", e.g. the neighbours of the current level,
+// or in the background when the player is about to reach them, see "LevelPreload.h")
+// so activating them never loads a level file.
+//
+// Memory usage of a level is estimated from its number of game objects
+// ("LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE", derived game objects and their textures are not counted)
+//---------------------
+
+#define LEVELMANAGER_DEFAULT_MEMORY_BUDGET (64 * 1024 * 1024)
+// Bytes counted per game object of a cached level
+#define LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE 1024
+#define LEVELMANAGER_NUM_PLAYER_STARTS 4
+
+class GameObject;
+class VoodooEngine;
+class BitmapComponent;
+
+struct SCachedLevel
+{
+	std::wstring FileName;
+	// Game objects of the level (filled by "FunctionPointer_LoadGameObjects"),
+	// a game object deleted on its own is removed from the level
+	std::vector<GameObject*> GameObjects;
+	size_t MemoryUsage = 0;
+	// Levels used least recently are evicted first
+	uint64_t LastUsed = 0;
+	int LevelSlot = 0;
+
+	// Player start objects (left, right, up, down) found by the last activation,
+	// only searched for again if the level is activated with other player start IDs
+	int PlayerStartIDs[LEVELMANAGER_NUM_PLAYER_STARTS] = { -1, -1, -1, -1 };
+	GameObject* PlayerStartObjects[LEVELMANAGER_NUM_PLAYER_STARTS] = {};
+};
+
+struct SLevelManager
+{
+	std::unordered_map<std::wstring, SCachedLevel> CachedLevels;
+	SCachedLevel* ActiveLevel = nullptr;
+	size_t MemoryBudget = LEVELMANAGER_DEFAULT_MEMORY_BUDGET;
+	size_t MemoryUsage = 0;
+	uint64_t UseCounter = 0;
+	// Bit per level slot given out (level slot 0 is never given out)
+	uint64_t UsedLevelSlots = 1;
+};
+
+// Load a level into the cache without activating it (game objects are created disabled),
+// returns nullptr if the level file could not be read, returns the cached level if already loaded
+extern "C" VOODOOENGINE_API SCachedLevel* PreloadLevel(VoodooEngine* Engine, const wchar_t* FileName);
+// Add game objects already created as a cached level (e.g. created by a background preload, see "LevelPreload.h"),
+// "GameObjects" is moved into the cached level (left empty), "LevelSlot" is the level slot the game objects
+// were already given (0 to give the level a new level slot).
+// If the level is already cached the cached level is returned as it is, the game objects are deleted
+// and the level slot given is freed
+extern "C" VOODOOENGINE_API SCachedLevel* AddCachedLevel(
+	VoodooEngine* Engine, const wchar_t* FileName, std::vector<GameObject*>& GameObjects, int LevelSlot = 0);
+// Give out a disabled level slot, evicts the least recently used level if every level slot is used
+extern "C" VOODOOENGINE_API int AllocateLevelSlot(VoodooEngine* Engine);
+extern "C" VOODOOENGINE_API void FreeLevelSlot(SLevelManager* LevelManager, int LevelSlot);
+// Preload the levels next to the active level (e.g. the levels a player can walk to),
+// levels over the memory budget are evicted afterwards, least recently used first
+extern "C" VOODOOENGINE_API void PreloadNeighbourLevels(
+	VoodooEngine* Engine, const std::vector<std::wstring>& NeighbourFileNames);
+
+// Activate a level of the cache (loaded first if not cached), the level slot of the previously active level
+// is disabled (the first activation disables every game object not part of a cached level except the player),
+// see "ActivateLevel" for the parameters, returns false if the level could not be loaded
+extern "C" VOODOOENGINE_API bool ActivateCachedLevel(
+	VoodooEngine* Engine,
+	const wchar_t* FileName,
+	int PlayerID = -1,
+	int PlayerStartLeftID = -1,
+	int PlayerStartRightID = -1,
+	int PlayerStartUpID = -1,
+	int PlayerStartDownID = -1,
+	BitmapComponent* LevelBackground = nullptr);
+
+// Delete the game objects of a cached level and remove it from the cache (the active level is not evicted),
+// returns false if the level is not cached or is active
+extern "C" VOODOOENGINE_API bool EvictLevel(VoodooEngine* Engine, const wchar_t* FileName);
+// Evict the least recently used levels until the cache is within its memory budget
+extern "C" VOODOOENGINE_API void EvictLevelsOverBudget(VoodooEngine* Engine);
+extern "C" VOODOOENGINE_API void SetLevelCacheMemoryBudget(VoodooEngine* Engine, size_t MemoryBudget);
+// Forget all cached levels without deleting their game objects, game objects of levels not active are left disabled
+// (called by the engine when all game objects are deleted)
+extern "C" VOODOOENGINE_API void ResetLevelCache(SLevelManager* LevelManager);
+// Called by the engine when a game object is deleted
+extern "C" VOODOOENGINE_API void RemoveCachedLevelObject(SLevelManager* LevelManager, GameObject* DeletedObject);
+// Called by the engine when many game objects are deleted at once, every cached level is walked once
+extern "C" VOODOOENGINE_API void RemoveCachedLevelObjects(
+	SLevelManager* LevelManager, const std::unordered_set<GameObject*>& DeletedObjects);
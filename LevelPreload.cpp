@@ -0,0 +1,285 @@
+#include "LevelPreload.h"
+#include "VoodooEngine.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+
+float PredictTimeToReachRect(SVector Location, SVector Velocity, SVector RectLocation, SVector RectSize)
+{
+	float DistanceX = std::max(std::max(RectLocation.X - Location.X, Location.X - (RectLocation.X + RectSize.X)), 0.f);
+	float DistanceY = std::max(std::max(RectLocation.Y - Location.Y, Location.Y - (RectLocation.Y + RectSize.Y)), 0.f);
+	if (DistanceX * DistanceX + DistanceY * DistanceY <= LEVELPRELOAD_DISTANCE * LEVELPRELOAD_DISTANCE)
+	{
+		return 0;
+	}
+
+	// Time the point enters and leaves the rect on each axis, it is inside the rect when it is inside on both axes
+	float EnterTime = 0;
+	float LeaveTime = FLT_MAX;
+	float Locations[2] = { Location.X, Location.Y };
+	float Velocities[2] = { Velocity.X, Velocity.Y };
+	float RectMins[2] = { RectLocation.X, RectLocation.Y };
+	float RectMaxs[2] = { RectLocation.X + RectSize.X, RectLocation.Y + RectSize.Y };
+	for (int Axis = 0; Axis < 2; ++Axis)
+	{
+		if (Velocities[Axis] == 0)
+		{
+			if (Locations[Axis] < RectMins[Axis] ||
+				Locations[Axis] > RectMaxs[Axis])
+			{
+				return -1;
+			}
+			continue;
+		}
+
+		float AxisEnterTime = (RectMins[Axis] - Locations[Axis]) / Velocities[Axis];
+		float AxisLeaveTime = (RectMaxs[Axis] - Locations[Axis]) / Velocities[Axis];
+		if (AxisEnterTime > AxisLeaveTime)
+		{
+			std::swap(AxisEnterTime, AxisLeaveTime);
+		}
+
+		EnterTime = std::max(EnterTime, AxisEnterTime);
+		LeaveTime = std::min(LeaveTime, AxisLeaveTime);
+	}
+
+	if (EnterTime > LeaveTime ||
+		LeaveTime < 0)
+	{
+		return -1;
+	}
+
+	return EnterTime;
+}
+
+void RequestLevelPreload(VoodooEngine* Engine, const wchar_t* FileName, float TimeToReach)
+{
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	if (Preload->Requested &&
+		Preload->RequestedTimeToReach <= TimeToReach)
+	{
+		return;
+	}
+
+	Preload->Requested = true;
+	Preload->RequestedFileName = FileName;
+	Preload->RequestedTimeToReach = TimeToReach;
+}
+
+// Run on the preload thread, only uses the read
+static void RunLevelPreloadRead(SLevelPreloadRead* Read)
+{
+	Read->Succeeded = ReadLevelFile(Read->FileName.c_str(), Read->LevelObjects, nullptr, &Read->Tilemap);
+	Read->Done.store(true);
+}
+
+static void StartLevelPreload(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	Preload->Read = new SLevelPreloadRead;
+	Preload->Read->FileName = FileName;
+	Preload->Read->ReadThread = std::thread(RunLevelPreloadRead, Preload->Read);
+	Preload->State = LevelPreload_Reading;
+}
+
+static void EndLevelPreload(SLevelPreload* Preload)
+{
+	// Level slot is owned by the cached level once added
+	Preload->LevelSlot = 0;
+	if (Preload->Read)
+	{
+		if (Preload->Read->ReadThread.joinable())
+		{
+			Preload->Read->ReadThread.join();
+		}
+		delete Preload->Read;
+		Preload->Read = nullptr;
+	}
+
+	Preload->SpawnedGameObjects.clear();
+	Preload->NumSpawned = 0;
+	Preload->State = LevelPreload_None;
+}
+
+// A level can be cached some other way while it is spawned over several frames,
+// the cached level is kept and the game objects created by the preload are deleted
+static bool DiscardLevelPreloadIfCached(VoodooEngine* Engine)
+{
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	if (Engine->LevelManager.CachedLevels.find(Preload->Read->FileName) == Engine->LevelManager.CachedLevels.end())
+	{
+		return false;
+	}
+
+	// Taken out of the preload first, deleting them would remove them from the preload one by one
+	std::vector<GameObject*> SpawnedGameObjects;
+	SpawnedGameObjects.swap(Preload->SpawnedGameObjects);
+	Engine->DeleteGameObjects(SpawnedGameObjects);
+	FreeLevelSlot(&Engine->LevelManager, Preload->LevelSlot);
+	EndLevelPreload(Preload);
+	return true;
+}
+
+// Create up to "MaxNumToSpawn" game objects of the read level, the level is added to the level cache once done
+static void SpawnLevelPreload(VoodooEngine* Engine, int MaxNumToSpawn)
+{
+	VOODOO_PROFILE_SCOPE("SpawnLevelPreload");
+
+	if (DiscardLevelPreloadIfCached(Engine))
+	{
+		return;
+	}
+
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	std::vector<SLevelFileObject>& LevelObjects = Preload->Read->LevelObjects;
+	if (Engine->FunctionPointer_LoadGameObjects)
+	{
+		int NumToSpawn = std::min(MaxNumToSpawn, (int)LevelObjects.size() - Preload->NumSpawned);
+		for (int i = 0; i < NumToSpawn; ++i)
+		{
+			const SLevelFileObject& LevelObject = LevelObjects[Preload->NumSpawned++];
+			size_t NumGameObjects = Preload->SpawnedGameObjects.size();
+			Engine->FunctionPointer_LoadGameObjects(
+				LevelObject.GameObjectID, LevelObject.Location, Preload->SpawnedGameObjects);
+
+			// Not shown until the level is activated
+			for (size_t j = NumGameObjects; j < Preload->SpawnedGameObjects.size(); ++j)
+			{
+				Preload->SpawnedGameObjects[j]->SetGameObjectLevelSlot(Preload->LevelSlot);
+			}
+		}
+	}
+	else
+	{
+		Preload->NumSpawned = (int)LevelObjects.size();
+	}
+
+	if (Preload->NumSpawned < LevelObjects.size())
+	{
+		return;
+	}
+
+	if (!IsTilemapEmpty(&Preload->Read->Tilemap))
+	{
+		CreateTilemapGameObject(Engine, &Preload->Read->Tilemap, &Preload->SpawnedGameObjects)->SetGameObjectLevelSlot(
+			Preload->LevelSlot);
+	}
+
+	// Checked again, creating the game objects may have cached the level (e.g. a game object loading its level)
+	if (DiscardLevelPreloadIfCached(Engine))
+	{
+		return;
+	}
+
+	AddCachedLevel(Engine, Preload->Read->FileName.c_str(), Preload->SpawnedGameObjects, Preload->LevelSlot);
+	EndLevelPreload(Preload);
+	EvictLevelsOverBudget(Engine);
+}
+
+void UpdateLevelPreload(VoodooEngine* Engine)
+{
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	bool Requested = Preload->Requested;
+	Preload->Requested = false;
+
+	switch (Preload->State)
+	{
+	case LevelPreload_None:
+		if (Requested &&
+			Engine->LevelManager.CachedLevels.find(Preload->RequestedFileName) == Engine->LevelManager.CachedLevels.end())
+		{
+			StartLevelPreload(Engine, Preload->RequestedFileName.c_str());
+		}
+		break;
+	case LevelPreload_Reading:
+		if (!Preload->Read->Done.load())
+		{
+			break;
+		}
+
+		Preload->Read->ReadThread.join();
+		if (!Preload->Read->Succeeded)
+		{
+			EndLevelPreload(Preload);
+			break;
+		}
+
+		Preload->SpawnedGameObjects.reserve(Preload->Read->LevelObjects.size());
+		Preload->LevelSlot = AllocateLevelSlot(Engine);
+		Preload->State = LevelPreload_Spawning;
+		break;
+	case LevelPreload_Spawning:
+		SpawnLevelPreload(Engine, LEVELPRELOAD_SPAWN_BUDGET);
+		break;
+	}
+}
+
+bool IsLevelPreloading(VoodooEngine* Engine, const wchar_t* FileName)
+{
+	return Engine->LevelPreload.Read &&
+		Engine->LevelPreload.Read->FileName == FileName;
+}
+
+void FinishLevelPreload(VoodooEngine* Engine)
+{
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	if (!Preload->Read)
+	{
+		return;
+	}
+
+	VOODOO_PROFILE_SCOPE("FinishLevelPreload");
+
+	if (Preload->State == LevelPreload_Reading)
+	{
+		Preload->Read->ReadThread.join();
+		if (!Preload->Read->Succeeded)
+		{
+			EndLevelPreload(Preload);
+			return;
+		}
+
+		Preload->LevelSlot = AllocateLevelSlot(Engine);
+		Preload->State = LevelPreload_Spawning;
+	}
+
+	SpawnLevelPreload(Engine, INT_MAX);
+}
+
+void ResetLevelPreload(VoodooEngine* Engine)
+{
+	SLevelPreload* Preload = &Engine->LevelPreload;
+	for (int i = 0; i < Preload->SpawnedGameObjects.size(); ++i)
+	{
+		Preload->SpawnedGameObjects[i]->SetGameObjectLevelSlot(0);
+		Preload->SpawnedGameObjects[i]->SetGameObjectState(false);
+	}
+	FreeLevelSlot(&Engine->LevelManager, Preload->LevelSlot);
+
+	EndLevelPreload(Preload);
+	Preload->Requested = false;
+}
+
+void RemoveLevelPreloadObject(SLevelPreload* Preload, GameObject* DeletedObject)
+{
+	if (Preload->SpawnedGameObjects.empty())
+	{
+		return;
+	}
+
+	Preload->SpawnedGameObjects.erase(
+		std::remove(Preload->SpawnedGameObjects.begin(), Preload->SpawnedGameObjects.end(), DeletedObject),
+		Preload->SpawnedGameObjects.end());
+}
+
+void RemoveLevelPreloadObjects(SLevelPreload* Preload, const std::unordered_set<GameObject*>& DeletedObjects)
+{
+	if (Preload->SpawnedGameObjects.empty())
+	{
+		return;
+	}
+
+	Preload->SpawnedGameObjects.erase(std::remove_if(Preload->SpawnedGameObjects.begin(), Preload->SpawnedGameObjects.end(),
+		[&DeletedObjects](GameObject* SpawnedObject) { return DeletedObjects.count(SpawnedObject) > 0; }),
+		Preload->SpawnedGameObjects.end());
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "LevelEditJournal.h"
+#include "Tilemap.h"
+#include "SVector.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Level preload
+//---------------------
+// Loads the level a player is about to walk into in the background, so the level is in the level cache
+// (see "LevelManager.h") when the player reaches the edge of the screen and activating it never loads a file.
+// A "LoadLevelTrigger" with a preload target requests its neighbour level every frame the target is predicted
+// to reach the trigger soon (from the target location and velocity), the most urgent request of a frame is preloaded.
+//
+// A preload reads the level file on a preload thread, then the game objects of the level are created
+// (hidden by the level slot of the level) on the main thread a few at a time every frame ("LEVELPRELOAD_SPAWN_BUDGET"), so no frame creates the whole level.
+// Textures of game objects are the texture atlases loaded with the assets, so a preloaded level has no texture to load.
+//
+// Only one level is preloaded at a time, a level activated while it is being preloaded is finished right away.
+// A level cached some other way while it is being preloaded (e.g. added by the game) is kept,
+// the game objects created by the preload are deleted.
+//---------------------
+
+// A level is preloaded when its trigger is predicted to be reached within this many seconds
+#define LEVELPRELOAD_LOOKAHEAD_TIME 2.f
+// A level is preloaded when its trigger is closer than this (e.g. player standing still next to the edge)
+#define LEVELPRELOAD_DISTANCE 200.f
+// Number of game objects of a preloaded level created per frame
+#define LEVELPRELOAD_SPAWN_BUDGET 512
+
+class GameObject;
+class VoodooEngine;
+
+enum ELevelPreloadState
+{
+	LevelPreload_None = 0,
+	LevelPreload_Reading = 1,
+	LevelPreload_Spawning = 2
+};
+
+// Level file read on the preload thread
+struct SLevelPreloadRead
+{
+	std::wstring FileName;
+	std::vector<SLevelFileObject> LevelObjects;
+	// Tiles of the level, the tilemap game object is created once every other game object is created
+	STilemap Tilemap;
+	bool Succeeded = false;
+	std::atomic<bool> Done = { false };
+	std::thread ReadThread;
+};
+
+struct SLevelPreload
+{
+	ELevelPreloadState State = LevelPreload_None;
+	SLevelPreloadRead* Read = nullptr;
+	// Game objects created so far, added to the level cache once every game object is created
+	// (a game object deleted before that is removed, see "RemoveLevelPreloadObjects")
+	std::vector<GameObject*> SpawnedGameObjects;
+	int NumSpawned = 0;
+	// Level slot the game objects are hidden by until the level is activated (see "EnableMasks.h")
+	int LevelSlot = 0;
+
+	// Most urgent request of the current frame, cleared every frame
+	// (file name buffer is reused so requesting a level every frame never allocates)
+	bool Requested = false;
+	std::wstring RequestedFileName;
+	float RequestedTimeToReach = 0;
+};
+
+// Seconds until a point moving at "Velocity" (per second) enters a rect, 0 if within "LEVELPRELOAD_DISTANCE" of the rect,
+// negative if it never enters the rect (moving away or standing still)
+extern "C" VOODOOENGINE_API float PredictTimeToReachRect(
+	SVector Location, SVector Velocity, SVector RectLocation, SVector RectSize);
+
+// Request a level to be preloaded, the request with the lowest "TimeToReach" of a frame is preloaded
+// (ignored if the level is already cached or being preloaded)
+extern "C" VOODOOENGINE_API void RequestLevelPreload(VoodooEngine* Engine, const wchar_t* FileName, float TimeToReach);
+// Called by the engine every frame, continues the running preload or starts the requested one
+extern "C" VOODOOENGINE_API void UpdateLevelPreload(VoodooEngine* Engine);
+// True if the level is being preloaded (not in the level cache yet)
+extern "C" VOODOOENGINE_API bool IsLevelPreloading(VoodooEngine* Engine, const wchar_t* FileName);
+// Block until the running preload is in the level cache (e.g. the level is activated before its preload is done)
+extern "C" VOODOOENGINE_API void FinishLevelPreload(VoodooEngine* Engine);
+// Stop the running preload without deleting the game objects created by it (left disabled)
+// (called by the engine when all game objects are deleted)
+extern "C" VOODOOENGINE_API void ResetLevelPreload(VoodooEngine* Engine);
+// Called by the engine when game objects are deleted, so they are not added to the preloaded level
+extern "C" VOODOOENGINE_API void RemoveLevelPreloadObject(SLevelPreload* Preload, GameObject* DeletedObject);
+extern "C" VOODOOENGINE_API void RemoveLevelPreloadObjects(
+	SLevelPreload* Preload, const std::unordered_set<GameObject*>& DeletedObjects);
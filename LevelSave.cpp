@@ -0,0 +1,267 @@
+#include "LevelSave.h"
+#include "VoodooEngine.h"
+#include <fstream>
+
+static void WriteLevelEditOperation(std::ofstream& File, const SLevelEditOperation& Operation)
+{
+	switch (Operation.Type)
+	{
+	case LevelEditOperation_Create:
+		File << "create " << Operation.LevelObjectID << " " << Operation.GameObjectID
+			<< " " << Operation.ToLocation.X << " " << Operation.ToLocation.Y << '\n';
+		break;
+	case LevelEditOperation_Delete:
+		File << "delete " << Operation.LevelObjectID << '\n';
+		break;
+	case LevelEditOperation_Move:
+		File << "move " << Operation.LevelObjectID
+			<< " " << Operation.ToLocation.X << " " << Operation.ToLocation.Y << '\n';
+		break;
+	case LevelEditOperation_Tile:
+		File << "tile " << Operation.RenderLayer << " " << Operation.TileSize
+			<< " " << Operation.TileColumn << " " << Operation.TileRow << " " << Operation.GameObjectID << '\n';
+		break;
+	}
+}
+
+bool WriteLevelFile(const wchar_t* FileName,
+	const std::vector<SLevelFileObject>& LevelObjects, std::atomic<int>* NumWritten, const STilemap* Tilemap)
+{
+	std::wstring TempFileName = std::wstring(FileName) + LEVELSAVE_TEMP_FILE_EXTENSION;
+
+	std::ofstream File;
+	OpenPlatformFile(File, TempFileName.c_str(), std::ios_base::out | std::ios_base::trunc);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	for (int i = 0; i < LevelObjects.size(); ++i)
+	{
+		File << LevelObjects[i].GameObjectID
+			<< " " << LevelObjects[i].Location.X
+			<< " " << LevelObjects[i].Location.Y
+			<< " " << LevelObjects[i].LevelObjectID << '\n';
+
+		if (NumWritten &&
+			(i + 1) % LEVELSAVE_PROGRESS_INTERVAL == 0)
+		{
+			NumWritten->store(i + 1);
+		}
+	}
+
+	if (Tilemap)
+	{
+		WriteTilemap(File, Tilemap);
+	}
+
+	File.close();
+	if (File.fail())
+	{
+		return false;
+	}
+
+	// Level file is only replaced once the temp file is complete
+	return ReplacePlatformFile(TempFileName.c_str(), FileName);
+}
+
+// Operations are appended to the end of the journal (a crash can only cut off the last operation)
+static bool AppendLevelJournal(SLevelSaveTask* Task)
+{
+	std::ofstream File;
+	OpenPlatformFile(File, GetLevelJournalFileName(Task->FileName.c_str()).c_str(),
+		std::ios_base::out | std::ios_base::app);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	for (int i = 0; i < Task->Operations.size(); ++i)
+	{
+		WriteLevelEditOperation(File, Task->Operations[i]);
+
+		if ((i + 1) % LEVELSAVE_PROGRESS_INTERVAL == 0)
+		{
+			Task->NumItemsWritten.store(i + 1);
+		}
+	}
+
+	File.close();
+	return !File.fail();
+}
+
+// Run on the save thread, only uses the snapshot in the task
+static void RunLevelSave(SLevelSaveTask* Task)
+{
+	if (Task->RewriteLevelFile)
+	{
+		Task->Succeeded =
+			WriteLevelFile(Task->FileName.c_str(), Task->LevelObjects, &Task->NumItemsWritten, &Task->Tilemap);
+
+		// Level file now contains every operation of the journal,
+		// if the journal is not emptied (e.g. crash) its operations are applied again on load which gives the same level
+		if (Task->Succeeded)
+		{
+			std::ofstream JournalFile;
+			OpenPlatformFile(JournalFile, GetLevelJournalFileName(Task->FileName.c_str()).c_str(),
+				std::ios_base::out | std::ios_base::trunc);
+			JournalFile.close();
+		}
+	}
+	else
+	{
+		Task->Succeeded = AppendLevelJournal(Task);
+	}
+
+	Task->NumItemsWritten.store(Task->NumItems);
+	Task->Done.store(true);
+}
+
+static void FinishLevelSave(VoodooEngine* Engine)
+{
+	SLevelSave* LevelSave = &Engine->LevelSave;
+	SLevelSaveTask* Task = LevelSave->Task;
+	Task->SaveThread.join();
+
+	// Files written by this save (even a failed one) are not reloaded
+	SyncLevelFileWriteTime(Engine);
+
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	if (Task->Succeeded)
+	{
+		if (Task->RewriteLevelFile)
+		{
+			Journal->LevelFileName = Task->FileName;
+			Journal->NumJournalOperations = 0;
+			Journal->CompactOnNextSave = false;
+		}
+		else
+		{
+			Journal->NumJournalOperations += (int)Task->Operations.size();
+		}
+
+		LevelSave->State = LevelSave_Succeeded;
+	}
+	else
+	{
+		// Saved again by the next save, which rewrites the level file
+		// (the journal may end with a partly written operation)
+		Journal->UnsavedOperations.insert(
+			Journal->UnsavedOperations.begin(), Task->Operations.begin(), Task->Operations.end());
+		Journal->CompactOnNextSave = true;
+
+		LevelSave->State = LevelSave_Failed;
+	}
+
+	delete Task;
+	LevelSave->Task = nullptr;
+}
+
+bool SaveLevelAsync(VoodooEngine* Engine, const wchar_t* FileName, bool RewriteLevelFile)
+{
+	SLevelSave* LevelSave = &Engine->LevelSave;
+	if (LevelSave->Task)
+	{
+		return false;
+	}
+
+	VOODOO_PROFILE_SCOPE("SaveLevelAsync");
+
+	SLevelEditJournal* Journal = &Engine->LevelEditJournal;
+	RewriteLevelFile = RewriteLevelFile || IsLevelFileRewriteNeeded(Engine, FileName);
+
+	// Nothing has changed since the last save
+	if (!RewriteLevelFile &&
+		Journal->UnsavedOperations.empty())
+	{
+		LevelSave->State = LevelSave_Succeeded;
+		return true;
+	}
+
+	SLevelSaveTask* Task = new SLevelSaveTask;
+	Task->FileName = FileName;
+	Task->RewriteLevelFile = RewriteLevelFile;
+
+	if (RewriteLevelFile)
+	{
+		Task->LevelObjects.reserve(Engine->StoredGameObjects.size());
+		for (int i = 0; i < Engine->StoredGameObjects.size(); ++i)
+		{
+			GameObject* StoredObject = Engine->StoredGameObjects[i];
+			// Saved as tile rows
+			if (StoredObject->GameObjectID == TILEMAP_GAMEOBJECT_ID)
+			{
+				continue;
+			}
+
+			if (StoredObject->GetLevelObjectID() == 0)
+			{
+				AssignLevelObjectID(Journal, StoredObject);
+			}
+
+			SLevelFileObject LevelObject;
+			LevelObject.GameObjectID = StoredObject->GameObjectID;
+			LevelObject.Location = StoredObject->Location;
+			LevelObject.LevelObjectID = StoredObject->GetLevelObjectID();
+			Task->LevelObjects.push_back(LevelObject);
+		}
+
+		TilemapGameObject* EditedTilemap = GetEditedTilemap(Engine, false);
+		if (EditedTilemap)
+		{
+			Task->Tilemap = EditedTilemap->Tilemap;
+		}
+
+		Task->NumItems = (int)Task->LevelObjects.size();
+	}
+	else
+	{
+		Task->NumItems = (int)Journal->UnsavedOperations.size();
+	}
+
+	// Edits made while saving are saved by the next save
+	Task->Operations.swap(Journal->UnsavedOperations);
+
+	LevelSave->Task = Task;
+	LevelSave->State = LevelSave_Saving;
+	Task->SaveThread = std::thread(RunLevelSave, Task);
+	return true;
+}
+
+void UpdateLevelSave(VoodooEngine* Engine)
+{
+	if (!Engine->LevelSave.Task ||
+		!Engine->LevelSave.Task->Done.load())
+	{
+		return;
+	}
+
+	FinishLevelSave(Engine);
+}
+
+ELevelSaveState WaitForLevelSave(VoodooEngine* Engine)
+{
+	if (Engine->LevelSave.Task)
+	{
+		FinishLevelSave(Engine);
+	}
+
+	return Engine->LevelSave.State;
+}
+
+bool IsLevelSaving(VoodooEngine* Engine)
+{
+	return Engine->LevelSave.Task != nullptr;
+}
+
+float GetLevelSaveProgress(VoodooEngine* Engine)
+{
+	SLevelSaveTask* Task = Engine->LevelSave.Task;
+	if (!Task ||
+		Task->NumItems <= 0)
+	{
+		return 1;
+	}
+
+	return (float)Task->NumItemsWritten.load() / Task->NumItems;
+}
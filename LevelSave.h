@@ -0,0 +1,84 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "LevelEditJournal.h"
+#include "Tilemap.h"
+#include <atomic>
+#include <cwchar>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Level save
+//---------------------
+// Saves the level opened in the level editor in the background so the editor stays responsive,
+// everything to save is copied (snapshot) on the main thread and then written to file on a save thread.
+// The save thread is not a job system worker, a job waited for by the main thread can be run by the main thread
+// (a long file write would then block the frame).
+//
+// A save either appends the unsaved edits to the level journal or rewrites the whole level file
+// (see "LevelEditJournal.h" for when the level file is rewritten).
+// The level file is never written in place, a temp file ("<LevelFile>.tmp") is written and then renamed
+// over the level file, so a crash during a save leaves the previous level file as it was,
+// a journal operation cut off by a crash is skipped when the level is loaded.
+//
+// Only one save runs at a time, the engine finishes a save in "UpdateLevelSave" (called every frame)
+//---------------------
+
+// Progress is updated every time this many game objects/operations have been written
+#define LEVELSAVE_PROGRESS_INTERVAL 1024
+#define LEVELSAVE_TEMP_FILE_EXTENSION L".tmp"
+#define LEVELSAVE_STATUS_TEXT_LENGTH 64
+
+enum ELevelSaveState
+{
+	LevelSave_None = 0,
+	LevelSave_Saving = 1,
+	LevelSave_Succeeded = 2,
+	LevelSave_Failed = 3
+};
+
+struct SLevelSaveTask
+{
+	std::wstring FileName;
+	// Set if the whole level file is rewritten, otherwise the operations are appended to the journal
+	bool RewriteLevelFile = false;
+	std::vector<SLevelFileObject> LevelObjects;
+	// Tiles of the level (only copied if the level file is rewritten)
+	STilemap Tilemap;
+	// Operations saved by this save (given back to the journal if the save fails)
+	std::vector<SLevelEditOperation> Operations;
+
+	int NumItems = 0;
+	std::atomic<int> NumItemsWritten = { 0 };
+	std::atomic<bool> Done = { false };
+	bool Succeeded = false;
+	std::thread SaveThread;
+};
+
+struct SLevelSave
+{
+	// Running save, nullptr if none
+	SLevelSaveTask* Task = nullptr;
+	// State of the running save, or the result of the last save once done
+	ELevelSaveState State = LevelSave_None;
+};
+
+// Start saving the level (returns false if a save is already running),
+// the whole level file is rewritten if "RewriteLevelFile" is set or the journal needs to be compacted
+extern "C" VOODOOENGINE_API bool SaveLevelAsync(
+	VoodooEngine* Engine, const wchar_t* FileName, bool RewriteLevelFile = false);
+// Called by the engine every frame, finishes the running save once it has been written
+extern "C" VOODOOENGINE_API void UpdateLevelSave(VoodooEngine* Engine);
+// Block until the running save is finished (e.g. before the engine stops running), returns the result
+extern "C" VOODOOENGINE_API ELevelSaveState WaitForLevelSave(VoodooEngine* Engine);
+extern "C" VOODOOENGINE_API bool IsLevelSaving(VoodooEngine* Engine);
+// Progress of the running save (0-1), 1 if no save is running
+extern "C" VOODOOENGINE_API float GetLevelSaveProgress(VoodooEngine* Engine);
+
+// Write a level file through a temp file renamed over "FileName" (blocking, e.g. used by the save thread),
+// "NumWritten" (optional) is updated while writing, the tile rows of "Tilemap" (optional) are written after the game objects,
+// returns false if the file could not be written
+extern "C" VOODOOENGINE_API bool WriteLevelFile(const wchar_t* FileName,
+	const std::vector<SLevelFileObject>& LevelObjects, std::atomic<int>* NumWritten = nullptr,
+	const STilemap* Tilemap = nullptr);
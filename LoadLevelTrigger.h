@@ -30,6 +30,24 @@ public:
 	ELoadLevelTriggerType LoadLevelTriggerType = ELoadLevelTriggerType::LevelTriggerType_None;
 	void(*OnLoadLevelTriggerOverlap)(ELoadLevelTriggerType TriggerType) = nullptr;
 
+	// Optional, level behind the trigger is loaded in the background when "PreloadTarget" (e.g. the player)
+	// is about to reach the trigger, so it is in the level cache when activated (see "LevelPreload.h")
+	std::wstring NeighbourLevelFileName;
+	GameObject* PreloadTarget = nullptr;
+
+	void SetNeighbourLevel(GameObject* Target, const wchar_t* LevelFileName)
+	{
+		PreloadTarget = Target;
+		NeighbourLevelFileName = LevelFileName ? LevelFileName : L"";
+		PreviousTargetLocationValid = false;
+	}
+
+	void Update(float DeltaTime)
+	{
+		Trigger::Update(DeltaTime);
+		UpdateNeighbourLevelPreload(DeltaTime);
+	}
+
 	void OnBeginOverlap(int SenderCollisionTag, int TargetCollisionTag, Object* Target = nullptr)
 	{
 		Trigger::OnBeginOverlap(SenderCollisionTag, TargetCollisionTag, Target);
@@ -38,17 +56,51 @@ public:
 	}
 
 private:
+	SVector PreviousTargetLocation;
+	bool PreviousTargetLocationValid = false;
+
+	// Velocity of the target is taken from how far it moved since the last frame
+	void UpdateNeighbourLevelPreload(float DeltaTime)
+	{
+		if (!PreloadTarget ||
+			NeighbourLevelFileName.empty() ||
+			DeltaTime <= 0)
+		{
+			return;
+		}
+
+		SVector TargetLocation = PreloadTarget->Location;
+		SVector TargetVelocity = { 0, 0 };
+		if (PreviousTargetLocationValid)
+		{
+			TargetVelocity.X = (TargetLocation.X - PreviousTargetLocation.X) / DeltaTime;
+			TargetVelocity.Y = (TargetLocation.Y - PreviousTargetLocation.Y) / DeltaTime;
+		}
+		PreviousTargetLocation = TargetLocation;
+		PreviousTargetLocationValid = true;
+
+		float TimeToReach = PredictTimeToReachRect(
+			TargetLocation, TargetVelocity,
+			DefaultGameObjectCollision->ComponentLocation, DefaultGameObjectCollision->CollisionRect);
+		if (TimeToReach >= 0 &&
+			TimeToReach <= LEVELPRELOAD_LOOKAHEAD_TIME)
+		{
+			RequestLevelPreload(VoodooEngine::Engine, NeighbourLevelFileName.c_str(), TimeToReach);
+		}
+	}
+
 	void AddTriggerComponentsToEngine()
 	{
-		VoodooEngine::Engine->StoredCollisionComponents.push_back(&DefaultGameObjectCollision);
-		VoodooEngine::Engine->StoredUpdateComponents.push_back(this);
+		VoodooEngine::Engine->StoredCollisionComponents.push_back(CreateDefaultGameObjectCollision());
+		// Added from the constructor so the concrete type is not known yet
+		AddUpdateComponent(
+			&VoodooEngine::Engine->UpdateScheduler, (UpdateComponent*)this, UpdatePhase_PostPhysics);
 	}
 	void RemoveTriggerComponentsFromEngine()
 	{
 		VoodooEngine::Engine->RemoveComponent(
-			(CollisionComponent*)&DefaultGameObjectCollision, &VoodooEngine::Engine->StoredCollisionComponents);
-		VoodooEngine::Engine->RemoveComponent(
-			(UpdateComponent*)this, &VoodooEngine::Engine->StoredUpdateComponents);
+			DefaultGameObjectCollision, &VoodooEngine::Engine->StoredCollisionComponents);
+		RemoveUpdateComponent(&VoodooEngine::Engine->UpdateScheduler, this);
 	}
 	void SetupTrigger(
 		ELoadLevelTriggerType TriggerType = ELoadLevelTriggerType::LevelTriggerType_None,
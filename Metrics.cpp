@@ -0,0 +1,217 @@
+#include "Metrics.h"
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+// Metrics are stored in fixed arrays so pointers returned from "Register" functions stay valid
+static SMetricCounter MetricCounters[METRICS_MAXNUM_COUNTERS];
+static SMetricGauge MetricGauges[METRICS_MAXNUM_GAUGES];
+static SMetricHistogram MetricHistograms[METRICS_MAXNUM_HISTOGRAMS];
+static int NumMetricCounters = 0;
+static int NumMetricGauges = 0;
+static int NumMetricHistograms = 0;
+
+// Only used when registering metrics, updating a metric never locks
+static std::mutex MetricsRegisterMutex;
+
+SMetricCounter* RegisterMetricCounter(const char* Name, bool ResetEveryFrame)
+{
+	std::lock_guard<std::mutex> Lock(MetricsRegisterMutex);
+
+	for (int i = 0; i < NumMetricCounters; ++i)
+	{
+		if (std::strcmp(MetricCounters[i].Name, Name) == 0)
+		{
+			return &MetricCounters[i];
+		}
+	}
+
+	if (NumMetricCounters >= METRICS_MAXNUM_COUNTERS)
+	{
+		return nullptr;
+	}
+
+	SMetricCounter* Counter = &MetricCounters[NumMetricCounters];
+	Counter->Name = Name;
+	Counter->ResetEveryFrame = ResetEveryFrame;
+	NumMetricCounters++;
+
+	return Counter;
+}
+
+SMetricGauge* RegisterMetricGauge(const char* Name)
+{
+	std::lock_guard<std::mutex> Lock(MetricsRegisterMutex);
+
+	for (int i = 0; i < NumMetricGauges; ++i)
+	{
+		if (std::strcmp(MetricGauges[i].Name, Name) == 0)
+		{
+			return &MetricGauges[i];
+		}
+	}
+
+	if (NumMetricGauges >= METRICS_MAXNUM_GAUGES)
+	{
+		return nullptr;
+	}
+
+	SMetricGauge* Gauge = &MetricGauges[NumMetricGauges];
+	Gauge->Name = Name;
+	NumMetricGauges++;
+
+	return Gauge;
+}
+
+SMetricHistogram* RegisterMetricHistogram(const char* Name, float BucketWidth)
+{
+	std::lock_guard<std::mutex> Lock(MetricsRegisterMutex);
+
+	for (int i = 0; i < NumMetricHistograms; ++i)
+	{
+		if (std::strcmp(MetricHistograms[i].Name, Name) == 0)
+		{
+			return &MetricHistograms[i];
+		}
+	}
+
+	if (NumMetricHistograms >= METRICS_MAXNUM_HISTOGRAMS ||
+		BucketWidth <= 0)
+	{
+		return nullptr;
+	}
+
+	SMetricHistogram* Histogram = &MetricHistograms[NumMetricHistograms];
+	Histogram->Name = Name;
+	Histogram->BucketWidth = BucketWidth;
+	NumMetricHistograms++;
+
+	return Histogram;
+}
+
+SEngineMetrics* GetEngineMetrics()
+{
+	static SEngineMetrics EngineMetrics;
+	static std::once_flag EngineMetricsRegistered;
+
+	std::call_once(EngineMetricsRegistered, []()
+	{
+		EngineMetrics.ObjectsAlive = RegisterMetricGauge("voodoo_objects_alive");
+		EngineMetrics.TexturesResident = RegisterMetricGauge("voodoo_textures_resident");
+		EngineMetrics.TimersActive = RegisterMetricGauge("voodoo_timers_active");
+		EngineMetrics.CollidersTested = RegisterMetricCounter("voodoo_colliders_tested", true);
+		EngineMetrics.AABBTests = RegisterMetricCounter("voodoo_aabb_tests", true);
+		EngineMetrics.AABBHits = RegisterMetricCounter("voodoo_aabb_hits", true);
+		EngineMetrics.TransformsUpdated = RegisterMetricCounter("voodoo_transforms_updated", true);
+		// Only counted when allocation counting is enabled (see "FrameAllocator.h")
+		EngineMetrics.HeapAllocations = RegisterMetricCounter("voodoo_heap_allocations", true);
+		EngineMetrics.DrawCalls = RegisterMetricCounter("voodoo_draw_calls", true);
+		EngineMetrics.FramesRendered = RegisterMetricCounter("voodoo_frames_rendered");
+		// Frame time in milliseconds, bucket width of 0.5 ms covers frames up to 64 ms
+		EngineMetrics.FrameTime = RegisterMetricHistogram("voodoo_frame_time_ms", 0.5);
+	});
+
+	return &EngineMetrics;
+}
+
+float GetMetricHistogramPercentile(SMetricHistogram* Histogram, float Percentile)
+{
+	if (!Histogram)
+	{
+		return 0;
+	}
+
+	uint32_t NumValues = Histogram->NumValues.load(std::memory_order_relaxed);
+	if (NumValues == 0)
+	{
+		return 0;
+	}
+
+	// Returns the upper bound of the bucket the percentile falls in
+	uint64_t TargetCount = (uint64_t)(NumValues * (Percentile / 100.f));
+	uint64_t Count = 0;
+	for (int i = 0; i < METRICS_HISTOGRAM_NUMBUCKETS; ++i)
+	{
+		Count += Histogram->Buckets[i].load(std::memory_order_relaxed);
+		if (Count > TargetCount)
+		{
+			return (i + 1) * Histogram->BucketWidth;
+		}
+	}
+
+	return METRICS_HISTOGRAM_NUMBUCKETS * Histogram->BucketWidth;
+}
+
+void ResetMetricHistogram(SMetricHistogram* Histogram)
+{
+	if (!Histogram)
+	{
+		return;
+	}
+
+	for (int i = 0; i < METRICS_HISTOGRAM_NUMBUCKETS; ++i)
+	{
+		Histogram->Buckets[i].store(0, std::memory_order_relaxed);
+	}
+	Histogram->NumValues.store(0, std::memory_order_relaxed);
+}
+
+void EndMetricsFrame()
+{
+	for (int i = 0; i < NumMetricCounters; ++i)
+	{
+		if (MetricCounters[i].ResetEveryFrame)
+		{
+			MetricCounters[i].LastFrameValue = MetricCounters[i].Value.exchange(0, std::memory_order_relaxed);
+			MetricCounters[i].TotalValue += MetricCounters[i].LastFrameValue;
+		}
+	}
+}
+
+bool DumpMetricsToFile(const char* FileName)
+{
+	std::ofstream File(FileName);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	for (int i = 0; i < NumMetricCounters; ++i)
+	{
+		SMetricCounter& Counter = MetricCounters[i];
+		File << "# TYPE " << Counter.Name << " counter\n";
+		if (Counter.ResetEveryFrame)
+		{
+			File << Counter.Name << "_total " << Counter.TotalValue << "\n";
+			File << Counter.Name << "_last_frame " << Counter.LastFrameValue << "\n";
+		}
+		else
+		{
+			File << Counter.Name << " " << Counter.Value.load(std::memory_order_relaxed) << "\n";
+		}
+	}
+
+	for (int i = 0; i < NumMetricGauges; ++i)
+	{
+		SMetricGauge& Gauge = MetricGauges[i];
+		File << "# TYPE " << Gauge.Name << " gauge\n";
+		File << Gauge.Name << " " << Gauge.Value.load(std::memory_order_relaxed) << "\n";
+	}
+
+	const float Percentiles[] = { 50, 90, 99 };
+	for (int i = 0; i < NumMetricHistograms; ++i)
+	{
+		SMetricHistogram& Histogram = MetricHistograms[i];
+		File << "# TYPE " << Histogram.Name << " summary\n";
+		for (float Percentile : Percentiles)
+		{
+			File << Histogram.Name << "{quantile=\"" << Percentile / 100.f << "\"} "
+				<< GetMetricHistogramPercentile(&Histogram, Percentile) << "\n";
+		}
+		File << Histogram.Name << "_count " << Histogram.NumValues.load(std::memory_order_relaxed) << "\n";
+	}
+
+	File.close();
+
+	return true;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <atomic>
+#include <cstdint>
+
+// Metrics
+//---------------------
+// Registry of named counters, gauges and histograms that can be read from a running build.
+// Updating a metric is a single relaxed atomic add, so metrics are always enabled (also in release).
+// A snapshot of all registered metrics can be written to a file on demand ("DumpMetricsToFile"),
+// or periodically by the engine (see "MetricsDumpInterval" in the engine class)
+//---------------------
+
+// Max number of metrics that can be registered of each type
+#define METRICS_MAXNUM_COUNTERS 64
+#define METRICS_MAXNUM_GAUGES 64
+#define METRICS_MAXNUM_HISTOGRAMS 16
+// Number of buckets in every histogram (values above the last bucket are added to the last bucket)
+#define METRICS_HISTOGRAM_NUMBUCKETS 128
+
+// Counter that only goes up,
+// if set to reset every frame the value of the last completed frame is kept in "LastFrameValue"
+struct SMetricCounter
+{
+	const char* Name = nullptr;
+	bool ResetEveryFrame = false;
+	std::atomic<int64_t> Value = { 0 };
+	int64_t LastFrameValue = 0;
+	int64_t TotalValue = 0;
+};
+
+// Value that can go up and down e.g. number of objects alive
+struct SMetricGauge
+{
+	const char* Name = nullptr;
+	std::atomic<int64_t> Value = { 0 };
+};
+
+// Distribution of values e.g. frame times, used to get percentiles
+struct SMetricHistogram
+{
+	const char* Name = nullptr;
+	float BucketWidth = 1;
+	std::atomic<uint32_t> Buckets[METRICS_HISTOGRAM_NUMBUCKETS] = {};
+	std::atomic<uint32_t> NumValues = { 0 };
+};
+
+// Metrics built into the engine
+struct SEngineMetrics
+{
+	SMetricGauge* ObjectsAlive = nullptr;
+	SMetricGauge* TexturesResident = nullptr;
+	SMetricGauge* TimersActive = nullptr;
+	SMetricCounter* CollidersTested = nullptr;
+	SMetricCounter* AABBTests = nullptr;
+	SMetricCounter* AABBHits = nullptr;
+	SMetricCounter* TransformsUpdated = nullptr;
+	SMetricCounter* HeapAllocations = nullptr;
+	SMetricCounter* DrawCalls = nullptr;
+	SMetricCounter* FramesRendered = nullptr;
+	SMetricHistogram* FrameTime = nullptr;
+};
+
+// Register a new metric (or get the already registered metric with the same name),
+// returns nullptr if max number of metrics of that type is reached
+extern "C" VOODOOENGINE_API SMetricCounter* RegisterMetricCounter(const char* Name, bool ResetEveryFrame = false);
+extern "C" VOODOOENGINE_API SMetricGauge* RegisterMetricGauge(const char* Name);
+extern "C" VOODOOENGINE_API SMetricHistogram* RegisterMetricHistogram(const char* Name, float BucketWidth = 1);
+
+// Get the metrics built into the engine (registered the first time this is called)
+extern "C" VOODOOENGINE_API SEngineMetrics* GetEngineMetrics();
+
+// Get a percentile (0 - 100) of all values added to a histogram
+extern "C" VOODOOENGINE_API float GetMetricHistogramPercentile(SMetricHistogram* Histogram, float Percentile);
+extern "C" VOODOOENGINE_API void ResetMetricHistogram(SMetricHistogram* Histogram);
+
+// Called by the engine at the end of every frame,
+// moves the value of all per frame counters to "LastFrameValue"
+extern "C" VOODOOENGINE_API void EndMetricsFrame();
+
+// Write a snapshot of all registered metrics to a file (using the prometheus text format),
+// returns false if the file could not be written
+extern "C" VOODOOENGINE_API bool DumpMetricsToFile(const char* FileName);
+
+inline void AddMetricCounter(SMetricCounter* Counter, int64_t Amount = 1)
+{
+	if (Counter)
+	{
+		Counter->Value.fetch_add(Amount, std::memory_order_relaxed);
+	}
+}
+
+inline void AddMetricGauge(SMetricGauge* Gauge, int64_t Amount)
+{
+	if (Gauge)
+	{
+		Gauge->Value.fetch_add(Amount, std::memory_order_relaxed);
+	}
+}
+
+inline void SetMetricGauge(SMetricGauge* Gauge, int64_t NewValue)
+{
+	if (Gauge)
+	{
+		Gauge->Value.store(NewValue, std::memory_order_relaxed);
+	}
+}
+
+inline void AddMetricHistogramValue(SMetricHistogram* Histogram, float Value)
+{
+	if (!Histogram)
+	{
+		return;
+	}
+
+	int BucketIndex = 0;
+	if (Value > 0)
+	{
+		BucketIndex = (int)(Value / Histogram->BucketWidth);
+	}
+	if (BucketIndex >= METRICS_HISTOGRAM_NUMBUCKETS)
+	{
+		BucketIndex = METRICS_HISTOGRAM_NUMBUCKETS - 1;
+	}
+
+	Histogram->Buckets[BucketIndex].fetch_add(1, std::memory_order_relaxed);
+	Histogram->NumValues.fetch_add(1, std::memory_order_relaxed);
+}
@@ -3,13 +3,18 @@
 #include "VoodooEngine.h"
 #include "SVector.h"
 
-struct SQuadCollisionParameters
+// Collision rects of the quad collision (one per side), only created for characters that use quad collision
+// (see "InitMovementComponent")
+struct SQuadCollisionProbes
 {
 	CollisionComponent CollisionLeft;
 	CollisionComponent CollisionRight;
 	CollisionComponent CollisionUp;
 	CollisionComponent CollisionDown;
+};
 
+struct SQuadCollisionParameters
+{
 	SVector RectSizeCollisionLeft;
 	SVector RectSizeCollisionRight;
 	SVector RectSizeCollisionUp;
@@ -32,6 +37,8 @@ public:
 	SVector MovementDirection;
 	float MovementSpeed = 100;
 	SQuadCollisionParameters QuadCollisionParams;
+	// Optional, nullptr if the quad collision is not used (nothing blocks the movement), deleted with the component
+	SQuadCollisionProbes* QuadCollisionProbes = nullptr;
 
 	// Velocity makes gravity smooth when character is jumping/falling
 	float Velocity = 0;
@@ -44,6 +51,15 @@ public:
 	float GroundHitCollisionLocation = 0;
 	float RoofHitCollisionLocation = 0;
 
+	MovementComponent() = default;
+	~MovementComponent()
+	{
+		delete QuadCollisionProbes;
+	}
+	// Owns the quad collision probes, so never copied
+	MovementComponent(const MovementComponent&) = delete;
+	MovementComponent& operator=(const MovementComponent&) = delete;
+
 	void InitMovementComponent(GameObject* ComponentOwner,
 		SQuadCollisionParameters DesiredQuadCollisionParams,
 		float DesiredMovementSpeed, bool EnableGravity)
@@ -54,18 +70,26 @@ public:
 	}
 	void RemoveMovementComponent()
 	{
+		if (!QuadCollisionProbes)
+		{
+			return;
+		}
+
 		VoodooEngine::Engine->RemoveComponent(
-			&QuadCollisionParams.CollisionLeft, &VoodooEngine::Engine->StoredCollisionComponents);
+			&QuadCollisionProbes->CollisionLeft, &VoodooEngine::Engine->StoredCollisionComponents);
 		VoodooEngine::Engine->RemoveComponent(
-			&QuadCollisionParams.CollisionRight, &VoodooEngine::Engine->StoredCollisionComponents);
+			&QuadCollisionProbes->CollisionRight, &VoodooEngine::Engine->StoredCollisionComponents);
 		VoodooEngine::Engine->RemoveComponent(
-			&QuadCollisionParams.CollisionUp, &VoodooEngine::Engine->StoredCollisionComponents);
+			&QuadCollisionProbes->CollisionUp, &VoodooEngine::Engine->StoredCollisionComponents);
 		VoodooEngine::Engine->RemoveComponent(
-			&QuadCollisionParams.CollisionDown, &VoodooEngine::Engine->StoredCollisionComponents);
+			&QuadCollisionProbes->CollisionDown, &VoodooEngine::Engine->StoredCollisionComponents);
 	}
 	void UpdateQuadCollisionLocation(SVector NewLocation)
 	{
-		UpdateCollisionRectsLocation(NewLocation);
+		if (QuadCollisionProbes)
+		{
+			UpdateCollisionRectsLocation(NewLocation);
+		}
 	}
 	void UpdateGravity()
 	{
@@ -173,31 +197,36 @@ private:
 	void InitCollisionRectangles(GameObject* ComponentOwner,
 		SQuadCollisionParameters DesiredQuadCollisionParams)
 	{
+		if (!QuadCollisionProbes)
+		{
+			QuadCollisionProbes = new SQuadCollisionProbes;
+		}
+
 		if (VoodooEngine::Engine->DebugMode)
 		{
-			QuadCollisionParams.CollisionLeft.RenderCollisionRect = true;
-			QuadCollisionParams.CollisionRight.RenderCollisionRect = true;
-			QuadCollisionParams.CollisionUp.RenderCollisionRect = true;
-			QuadCollisionParams.CollisionDown.RenderCollisionRect = true;
-
-			QuadCollisionParams.CollisionLeft.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
-			QuadCollisionParams.CollisionRight.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
-			QuadCollisionParams.CollisionUp.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
-			QuadCollisionParams.CollisionDown.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
+			QuadCollisionProbes->CollisionLeft.RenderCollisionRect = true;
+			QuadCollisionProbes->CollisionRight.RenderCollisionRect = true;
+			QuadCollisionProbes->CollisionUp.RenderCollisionRect = true;
+			QuadCollisionProbes->CollisionDown.RenderCollisionRect = true;
+
+			QuadCollisionProbes->CollisionLeft.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
+			QuadCollisionProbes->CollisionRight.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
+			QuadCollisionProbes->CollisionUp.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
+			QuadCollisionProbes->CollisionDown.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
 		}
 
-		QuadCollisionParams.CollisionLeft.CollisionTag = ComponentOwner->GameObjectID;
-		QuadCollisionParams.CollisionRight.CollisionTag = ComponentOwner->GameObjectID;
-		QuadCollisionParams.CollisionUp.CollisionTag = ComponentOwner->GameObjectID;
-		QuadCollisionParams.CollisionDown.CollisionTag = ComponentOwner->GameObjectID;
+		QuadCollisionProbes->CollisionLeft.CollisionTag = ComponentOwner->GameObjectID;
+		QuadCollisionProbes->CollisionRight.CollisionTag = ComponentOwner->GameObjectID;
+		QuadCollisionProbes->CollisionUp.CollisionTag = ComponentOwner->GameObjectID;
+		QuadCollisionProbes->CollisionDown.CollisionTag = ComponentOwner->GameObjectID;
 
-		QuadCollisionParams.CollisionLeft.CollisionRect =
+		QuadCollisionProbes->CollisionLeft.CollisionRect =
 			DesiredQuadCollisionParams.RectSizeCollisionLeft;
-		QuadCollisionParams.CollisionRight.CollisionRect =
+		QuadCollisionProbes->CollisionRight.CollisionRect =
 			DesiredQuadCollisionParams.RectSizeCollisionRight;
-		QuadCollisionParams.CollisionUp.CollisionRect =
+		QuadCollisionProbes->CollisionUp.CollisionRect =
 			DesiredQuadCollisionParams.RectSizeCollisionUp;
-		QuadCollisionParams.CollisionDown.CollisionRect =
+		QuadCollisionProbes->CollisionDown.CollisionRect =
 			DesiredQuadCollisionParams.RectSizeCollisionDown;
 
 		QuadCollisionParams.RelativeOffsetCollisionLeft =
@@ -209,31 +238,41 @@ private:
 		QuadCollisionParams.RelativeOffsetCollisionDown =
 			DesiredQuadCollisionParams.RelativeOffsetCollisionDown;
 
-		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionParams.CollisionLeft);
-		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionParams.CollisionRight);
-		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionParams.CollisionUp);
-		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionParams.CollisionDown);
+		// Quad collision rects follow the owner location
+		AttachTransform(&ComponentOwner->ObjectTransform, 
+			&QuadCollisionProbes->CollisionLeft, QuadCollisionParams.RelativeOffsetCollisionLeft);
+		AttachTransform(&ComponentOwner->ObjectTransform, 
+			&QuadCollisionProbes->CollisionRight, QuadCollisionParams.RelativeOffsetCollisionRight);
+		AttachTransform(&ComponentOwner->ObjectTransform, 
+			&QuadCollisionProbes->CollisionUp, QuadCollisionParams.RelativeOffsetCollisionUp);
+		AttachTransform(&ComponentOwner->ObjectTransform, 
+			&QuadCollisionProbes->CollisionDown, QuadCollisionParams.RelativeOffsetCollisionDown);
+
+		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionProbes->CollisionLeft);
+		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionProbes->CollisionRight);
+		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionProbes->CollisionUp);
+		VoodooEngine::Engine->StoredCollisionComponents.push_back(&QuadCollisionProbes->CollisionDown);
 	}
 	void UpdateCollisionRectsLocation(SVector NewLocation)
 	{
-		QuadCollisionParams.CollisionLeft.ComponentLocation.X =
+		QuadCollisionProbes->CollisionLeft.ComponentLocation.X =
 			NewLocation.X + QuadCollisionParams.RelativeOffsetCollisionLeft.X;
-		QuadCollisionParams.CollisionLeft.ComponentLocation.Y =
+		QuadCollisionProbes->CollisionLeft.ComponentLocation.Y =
 			NewLocation.Y + QuadCollisionParams.RelativeOffsetCollisionLeft.Y;
 
-		QuadCollisionParams.CollisionRight.ComponentLocation.X =
+		QuadCollisionProbes->CollisionRight.ComponentLocation.X =
 			NewLocation.X + QuadCollisionParams.RelativeOffsetCollisionRight.X;
-		QuadCollisionParams.CollisionRight.ComponentLocation.Y =
+		QuadCollisionProbes->CollisionRight.ComponentLocation.Y =
 			NewLocation.Y + QuadCollisionParams.RelativeOffsetCollisionRight.Y;
 
-		QuadCollisionParams.CollisionUp.ComponentLocation.X =
+		QuadCollisionProbes->CollisionUp.ComponentLocation.X =
 			NewLocation.X + QuadCollisionParams.RelativeOffsetCollisionUp.X;
-		QuadCollisionParams.CollisionUp.ComponentLocation.Y =
+		QuadCollisionProbes->CollisionUp.ComponentLocation.Y =
 			NewLocation.Y + QuadCollisionParams.RelativeOffsetCollisionUp.Y;
 
-		QuadCollisionParams.CollisionDown.ComponentLocation.X =
+		QuadCollisionProbes->CollisionDown.ComponentLocation.X =
 			NewLocation.X + QuadCollisionParams.RelativeOffsetCollisionDown.X;
-		QuadCollisionParams.CollisionDown.ComponentLocation.Y =
+		QuadCollisionProbes->CollisionDown.ComponentLocation.Y =
 			NewLocation.Y + QuadCollisionParams.RelativeOffsetCollisionDown.Y;
 	}
 };
@@ -13,6 +13,9 @@ class Object
 {
 public:
 	SVector Location;
+	// Root transform of the object, components attached to it follow the object location
+	// (see "SetObjectLocation" and "TransformComponent.h")
+	TransformComponent ObjectTransform;
 
 	// These are overriden by the game object class
 	virtual void OnBeginOverlap(int SenderCollisionTag, int TargetCollisionTag, Object* Target = nullptr){};
@@ -27,6 +30,7 @@ extern "C" VOODOOENGINE_API SVector GetObjectLocation(Object* Object);
 // a gun is the component that will have its location set relative to where the player is, in local space
 // so if we set the player position in screen space to X=100, Y=200, and we set the gun position to be X=10, Y=20,
 // the gun position will end up being X=100 + X=10, Y=200 + Y=20
+// (the component is attached to the owner, so it keeps following the owner when the owner location is set)
 extern "C" VOODOOENGINE_API void SetComponentRelativeLocation(
 	Object* ComponentOwner, TransformComponent* Component, SVector NewLocation);
 
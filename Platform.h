@@ -0,0 +1,157 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "SVector.h"
+#include <cstdint>
+#include <string>
+#include <ios>
+
+// Platform layer
+//---------------------
+// Everything the engine needs from the operating system and graphics API goes through here,
+// so the rest of the engine never uses Win32/Direct2D types directly.
+//
+// VOODOOENGINE_PLATFORM_WIN32 - Win32 window, Direct2D renderer and WIC texture loading (see "PlatformWin32.cpp")
+// VOODOOENGINE_PLATFORM_NULL - No window, no renderer and no textures (see "PlatformNull.cpp"),
+// used for headless builds (e.g. simulation and profiling on Linux build servers).
+// Defining "VOODOOENGINE_HEADLESS" selects the null platform on Windows as well
+//---------------------
+
+#if defined(_WIN32) && !defined(VOODOOENGINE_HEADLESS)
+#define VOODOOENGINE_PLATFORM_WIN32
+#else
+#define VOODOOENGINE_PLATFORM_NULL
+#endif
+
+#ifdef VOODOOENGINE_PLATFORM_WIN32
+// Win32 API
+#include <Windows.h>
+// Direct2D API
+#include <d2d1.h>
+#pragma comment(lib, "d2d1.lib")
+// DirectWrite API
+#include <dwrite.h>
+#pragma comment(lib, "Dwrite.lib")
+
+// Opaque handles used by the engine,
+// on Win32 these are the Direct2D/DirectWrite types so they can be used directly by a game when needed
+typedef ID2D1Bitmap PlatformTexture;
+typedef ID2D1HwndRenderTarget PlatformRenderTarget;
+typedef ID2D1SolidColorBrush PlatformBrush;
+typedef IDWriteTextFormat PlatformTextFormat;
+typedef D2D1_COLOR_F PlatformColor;
+typedef HWND PlatformWindowHandle;
+// Window procedure that receives all input messages from the operating system
+typedef WNDPROC PlatformWindowProcedure;
+#else
+// Opaque handles used by the engine,
+// never defined on the null platform since nothing is ever created (always nullptr)
+struct PlatformTexture;
+struct PlatformRenderTarget;
+struct PlatformBrush;
+struct PlatformTextFormat;
+struct PlatformColor
+{
+	float r = 0;
+	float g = 0;
+	float b = 0;
+	float a = 1;
+};
+typedef void* PlatformWindowHandle;
+typedef intptr_t(*PlatformWindowProcedure)(PlatformWindowHandle, unsigned int, uintptr_t, intptr_t);
+#endif
+
+// Clock
+//---------------------
+// Current time of the high resolution clock in ticks (see "GetPlatformTicksPerSecond")
+extern "C" VOODOOENGINE_API int64_t GetPlatformTicks();
+extern "C" VOODOOENGINE_API int64_t GetPlatformTicksPerSecond();
+// Suspend the calling thread
+extern "C" VOODOOENGINE_API void PlatformSleep(int Milliseconds);
+//---------------------
+
+// Window
+//---------------------
+// Create and show the app window, returns nullptr on the null platform
+extern "C" VOODOOENGINE_API PlatformWindowHandle CreatePlatformWindow(
+	const wchar_t* WindowTitle,
+	int WindowResolutionWidth,
+	int WindowResolutionHeight,
+	bool WindowFullScreen,
+	PlatformWindowProcedure WindowProcedure);
+// Dispatch all pending window messages (e.g. dragging the window, input)
+extern "C" VOODOOENGINE_API void UpdatePlatformWindow();
+// Set the icon of the window title/task bar from an ico file (window keeps its default icon if not found)
+extern "C" VOODOOENGINE_API void SetPlatformWindowIcon(PlatformWindowHandle Window, const wchar_t* IconPath);
+// Get the mouse cursor location in screen space
+extern "C" VOODOOENGINE_API SVector GetPlatformCursorLocation();
+// Open a file dialog, returns false if no file was chosen (always false on the null platform)
+extern "C" VOODOOENGINE_API bool OpenPlatformFileDialog(
+	PlatformWindowHandle Window, const wchar_t* Filter, wchar_t* FileNameBuffer, int FileNameBufferSize);
+//---------------------
+
+// Renderer and textures
+//---------------------
+// Create the renderer for a window, returns nullptr on the null platform
+extern "C" VOODOOENGINE_API PlatformRenderTarget* CreatePlatformRenderer(PlatformWindowHandle Window);
+// Load a texture from a png file, returns nullptr if the file is not found or if there is no renderer
+extern "C" VOODOOENGINE_API PlatformTexture* LoadPlatformTexture(const wchar_t* FileName, PlatformRenderTarget* Renderer);
+extern "C" VOODOOENGINE_API void ReleasePlatformTexture(PlatformTexture* Texture);
+// Get the size in pixels of a texture, returns { 0, 0 } for nullptr
+extern "C" VOODOOENGINE_API SVector GetPlatformTextureSize(PlatformTexture* Texture);
+//---------------------
+
+// File I/O
+//---------------------
+// Engine file paths are wide strings (Win32),
+// only MSVC can open a file stream from a wide path so it is converted to UTF-8 everywhere else
+inline std::string ConvertPlatformPathToUTF8(const wchar_t* Path)
+{
+	std::string ConvertedPath;
+	for (; Path && *Path; ++Path)
+	{
+		uint32_t Character = (uint32_t)*Path;
+		if (Character < 0x80)
+		{
+			ConvertedPath += (char)Character;
+		}
+		else if (Character < 0x800)
+		{
+			ConvertedPath += (char)(0xC0 | (Character >> 6));
+			ConvertedPath += (char)(0x80 | (Character & 0x3F));
+		}
+		else if (Character < 0x10000)
+		{
+			ConvertedPath += (char)(0xE0 | (Character >> 12));
+			ConvertedPath += (char)(0x80 | ((Character >> 6) & 0x3F));
+			ConvertedPath += (char)(0x80 | (Character & 0x3F));
+		}
+		else
+		{
+			ConvertedPath += (char)(0xF0 | (Character >> 18));
+			ConvertedPath += (char)(0x80 | ((Character >> 12) & 0x3F));
+			ConvertedPath += (char)(0x80 | ((Character >> 6) & 0x3F));
+			ConvertedPath += (char)(0x80 | (Character & 0x3F));
+		}
+	}
+
+	return ConvertedPath;
+}
+
+// Open any file stream (fstream/ofstream/ifstream) from a wide path
+template<class T>
+inline void OpenPlatformFile(T& File, const wchar_t* FileName, std::ios_base::openmode Mode)
+{
+#ifdef _MSC_VER
+	File.open(FileName, Mode);
+#else
+	File.open(ConvertPlatformPathToUTF8(FileName), Mode);
+#endif
+}
+
+// Replace a file with another file in a single step (the replaced file is never left half written,
+// e.g. a file written to a temp file first), returns false if the file could not be replaced
+extern "C" VOODOOENGINE_API bool ReplacePlatformFile(const wchar_t* SourceFileName, const wchar_t* DestinationFileName);
+// Last time a file was written (only compared with an earlier value of the same file), returns 0 if not found
+extern "C" VOODOOENGINE_API uint64_t GetPlatformFileWriteTime(const wchar_t* FileName);
+//---------------------
@@ -0,0 +1,104 @@
+#include "Platform.h"
+
+#ifdef VOODOOENGINE_PLATFORM_NULL
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+// Null platform has no window, renderer or textures,
+// only the clock is implemented so the engine can run headless
+
+int64_t GetPlatformTicks()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t GetPlatformTicksPerSecond()
+{
+	return 1000000000;
+}
+
+void PlatformSleep(int Milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(Milliseconds));
+}
+
+PlatformWindowHandle CreatePlatformWindow(
+	const wchar_t* WindowTitle,
+	int WindowResolutionWidth,
+	int WindowResolutionHeight,
+	bool WindowFullScreen,
+	PlatformWindowProcedure WindowProcedure)
+{
+	return nullptr;
+}
+
+void UpdatePlatformWindow()
+{
+}
+
+void SetPlatformWindowIcon(PlatformWindowHandle Window, const wchar_t* IconPath)
+{
+}
+
+SVector GetPlatformCursorLocation()
+{
+	return { 0, 0 };
+}
+
+bool OpenPlatformFileDialog(
+	PlatformWindowHandle Window, const wchar_t* Filter, wchar_t* FileNameBuffer, int FileNameBufferSize)
+{
+	return false;
+}
+
+bool ReplacePlatformFile(const wchar_t* SourceFileName, const wchar_t* DestinationFileName)
+{
+	std::string Source = ConvertPlatformPathToUTF8(SourceFileName);
+	std::string Destination = ConvertPlatformPathToUTF8(DestinationFileName);
+
+	// Rename replaces an existing file in a single step on POSIX,
+	// the Windows C runtime fails instead so the existing file is removed first
+	if (std::rename(Source.c_str(), Destination.c_str()) == 0)
+	{
+		return true;
+	}
+
+	std::remove(Destination.c_str());
+	return std::rename(Source.c_str(), Destination.c_str()) == 0;
+}
+
+uint64_t GetPlatformFileWriteTime(const wchar_t* FileName)
+{
+	std::error_code Error;
+	std::filesystem::file_time_type WriteTime =
+		std::filesystem::last_write_time(ConvertPlatformPathToUTF8(FileName), Error);
+	if (Error)
+	{
+		return 0;
+	}
+
+	return (uint64_t)WriteTime.time_since_epoch().count();
+}
+
+PlatformRenderTarget* CreatePlatformRenderer(PlatformWindowHandle Window)
+{
+	return nullptr;
+}
+
+PlatformTexture* LoadPlatformTexture(const wchar_t* FileName, PlatformRenderTarget* Renderer)
+{
+	return nullptr;
+}
+
+void ReleasePlatformTexture(PlatformTexture* Texture)
+{
+}
+
+SVector GetPlatformTextureSize(PlatformTexture* Texture)
+{
+	return { 0, 0 };
+}
+#endif
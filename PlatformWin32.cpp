@@ -0,0 +1,282 @@
+#include "Platform.h"
+
+#ifdef VOODOOENGINE_PLATFORM_WIN32
+#include <commdlg.h>
+#include <wincodec.h>
+
+int64_t GetPlatformTicks()
+{
+	LARGE_INTEGER Ticks;
+	QueryPerformanceCounter(&Ticks);
+	return Ticks.QuadPart;
+}
+
+int64_t GetPlatformTicksPerSecond()
+{
+	LARGE_INTEGER TicksPerSecond;
+	QueryPerformanceFrequency(&TicksPerSecond);
+	return TicksPerSecond.QuadPart;
+}
+
+void PlatformSleep(int Milliseconds)
+{
+	Sleep(Milliseconds);
+}
+
+// Create and register app window
+PlatformWindowHandle CreatePlatformWindow(
+	const wchar_t* WindowTitle,
+	int WindowResolutionWidth,
+	int WindowResolutionHeight,
+	bool WindowFullScreen,
+	PlatformWindowProcedure WindowProcedure)
+{
+	WNDCLASSEX WindowClass;
+	WindowClass.cbSize = sizeof(WNDCLASSEX);
+	WindowClass.style = 0;
+	WindowClass.lpfnWndProc = WindowProcedure;
+	WindowClass.cbClsExtra = 0;
+	WindowClass.cbWndExtra = 0;
+	WindowClass.hInstance = nullptr;
+	WindowClass.lpszClassName = L"Window";
+	WindowClass.lpszMenuName = nullptr;
+	WindowClass.hbrBackground = nullptr;
+	WindowClass.hIcon = nullptr;
+	WindowClass.hIconSm = nullptr;
+	WindowClass.hCursor = nullptr;
+
+	RegisterClassEx(&WindowClass);
+
+	int WindowFullscreen = 0;
+	if (WindowFullScreen)
+	{
+		WindowFullscreen = WS_POPUP;
+	}
+	else
+	{
+		WindowFullscreen = WS_OVERLAPPEDWINDOW;
+	}
+
+	return CreateWindow(
+		WindowClass.lpszClassName,
+		WindowTitle,
+		WindowFullscreen,
+		0, 0,
+		WindowResolutionWidth,
+		WindowResolutionHeight,
+		nullptr,
+		nullptr,
+		WindowClass.hInstance,
+		nullptr);
+}
+
+// Updates any changes made to the app window (e.g. dragging the window)
+void UpdatePlatformWindow()
+{
+	MSG MSGMessage;
+	MSGMessage.message = WM_NULL;
+	while (PeekMessage(&MSGMessage, nullptr, 0, 0, PM_REMOVE))
+	{
+		DispatchMessage(&MSGMessage);
+	}
+}
+
+void SetPlatformWindowIcon(PlatformWindowHandle Window, const wchar_t* IconPath)
+{
+	// Load custom app icon from file (ico file format)
+	HANDLE CustomAppIcon = LoadImage(
+		0, IconPath,
+		IMAGE_ICON, 0, 0,
+		LR_DEFAULTSIZE | LR_LOADFROMFILE);
+
+	// Assign the custom icon as the official icon of the app
+	// (if no icon is found, then the engine will use default desktop icon)
+	if (CustomAppIcon)
+	{
+		SendMessage(Window, WM_SETICON, ICON_SMALL, (LPARAM)CustomAppIcon);
+		SendMessage(Window, WM_SETICON, ICON_BIG, (LPARAM)CustomAppIcon);
+
+		SendMessage(GetWindow(
+			Window, GW_OWNER), WM_SETICON, ICON_SMALL, (LPARAM)CustomAppIcon);
+		SendMessage(GetWindow(
+			Window, GW_OWNER), WM_SETICON, ICON_BIG, (LPARAM)CustomAppIcon);
+	}
+}
+
+SVector GetPlatformCursorLocation()
+{
+	POINT MousePositionPoint;
+	GetCursorPos(&MousePositionPoint);
+	SVector MousePosition = { 0, 0 };
+	MousePosition.X = MousePositionPoint.x;
+	MousePosition.Y = MousePositionPoint.y;
+
+	return MousePosition;
+}
+
+bool OpenPlatformFileDialog(
+	PlatformWindowHandle Window, const wchar_t* Filter, wchar_t* FileNameBuffer, int FileNameBufferSize)
+{
+	// Common dialog box structure
+	OPENFILENAME OFN;
+
+	// Initialize OPENFILENAME
+	ZeroMemory(&OFN, sizeof(OFN));
+	OFN.lStructSize = sizeof(OFN);
+	OFN.hwndOwner = Window;
+	OFN.lpstrFile = FileNameBuffer;
+
+	// Set lpstrFile[0] to '\0',
+	// so that GetOpenFileName does not use the contents of FileNameBuffer to initialize itself
+	OFN.lpstrFile[0] = '\0';
+
+	OFN.nMaxFile = FileNameBufferSize;
+	OFN.lpstrFilter = Filter;
+	OFN.nFilterIndex = 1;
+	OFN.lpstrFileTitle = NULL;
+	OFN.nMaxFileTitle = 0;
+	OFN.lpstrInitialDir = NULL;
+	OFN.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST;
+
+	return GetOpenFileName(&OFN) == TRUE;
+}
+
+bool ReplacePlatformFile(const wchar_t* SourceFileName, const wchar_t* DestinationFileName)
+{
+	// Write through so the file is on disk when this returns
+	return MoveFileExW(SourceFileName, DestinationFileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+uint64_t GetPlatformFileWriteTime(const wchar_t* FileName)
+{
+	WIN32_FILE_ATTRIBUTE_DATA FileAttributes;
+	if (!GetFileAttributesExW(FileName, GetFileExInfoStandard, &FileAttributes))
+	{
+		return 0;
+	}
+
+	return ((uint64_t)FileAttributes.ftLastWriteTime.dwHighDateTime << 32) | FileAttributes.ftLastWriteTime.dwLowDateTime;
+}
+
+PlatformRenderTarget* CreatePlatformRenderer(PlatformWindowHandle Window)
+{
+	ID2D1HwndRenderTarget* Renderer = nullptr;
+	ID2D1Factory* Factory = nullptr;
+	HRESULT Result = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &Factory);
+
+	RECT WinRect;
+	// Get user screen size
+	GetClientRect(Window, &WinRect);
+
+	Result = Factory->CreateHwndRenderTarget(
+		D2D1::RenderTargetProperties(),
+		D2D1::HwndRenderTargetProperties(
+			Window, D2D1::SizeU(WinRect.right, WinRect.bottom)),
+		&Renderer);
+
+	Factory->Release();
+
+	return Renderer;
+}
+
+// Create a converter from WIC bitmap to Direct2D bitmap
+// (flipped bitmaps are drawn flipped by the renderer, see "SBitmapParameters")
+static IWICFormatConverter* SetupWicConverter(
+	IWICFormatConverter* WicConverter,
+	IWICImagingFactory* WicFactory,
+	IWICBitmapFrameDecode* DecoderFrame)
+{
+	WicFactory->CreateFormatConverter(&WicConverter);
+	WicConverter->Initialize(
+		DecoderFrame,
+		GUID_WICPixelFormat32bppPBGRA,
+		WICBitmapDitherTypeNone,
+		nullptr,
+		0,
+		WICBitmapPaletteTypeCustom);
+
+	return WicConverter;
+}
+
+PlatformTexture* LoadPlatformTexture(const wchar_t* FileName, PlatformRenderTarget* Renderer)
+{
+	if (!Renderer)
+	{
+		return nullptr;
+	}
+
+	HRESULT Result;
+
+	// Create Wic factory
+	IWICImagingFactory* WicFactory = nullptr;
+	Result = CoCreateInstance(
+		CLSID_WICImagingFactory,
+		nullptr,
+		CLSCTX_INPROC_SERVER,
+		IID_PPV_ARGS(&WicFactory));
+
+	// Create decoder
+	IWICBitmapDecoder* Decoder = nullptr;
+	Result = WicFactory->CreateDecoderFromFilename(
+		FileName,
+		nullptr,
+		GENERIC_READ,
+		WICDecodeMetadataCacheOnDemand,
+		&Decoder);
+
+	// Failed to find file
+	if (!Decoder)
+	{
+		WicFactory->Release();
+		return nullptr;
+	}
+
+	// Create decoder frame
+	IWICBitmapFrameDecode* DecoderFrame = nullptr;
+	Result = Decoder->GetFrame(0, &DecoderFrame);
+
+	IWICFormatConverter* WicConverter = nullptr;
+	WicConverter = SetupWicConverter(WicConverter, WicFactory, DecoderFrame);
+
+	// The final bitmap will be returned
+	ID2D1Bitmap* Texture = nullptr;
+	Renderer->CreateBitmapFromWicBitmap(WicConverter, nullptr, &Texture);
+
+	if (WicFactory)
+	{
+		WicFactory->Release();
+	}
+	if (Decoder)
+	{
+		Decoder->Release();
+	}
+	if (DecoderFrame)
+	{
+		DecoderFrame->Release();
+	}
+	if (WicConverter)
+	{
+		WicConverter->Release();
+	}
+
+	return Texture;
+}
+
+void ReleasePlatformTexture(PlatformTexture* Texture)
+{
+	if (Texture)
+	{
+		Texture->Release();
+	}
+}
+
+SVector GetPlatformTextureSize(PlatformTexture* Texture)
+{
+	if (!Texture)
+	{
+		return { 0, 0 };
+	}
+
+	return { Texture->GetSize().width, Texture->GetSize().height };
+}
+#endif
@@ -7,15 +7,18 @@ class PlayerStart : public GameObject
 public:
 	void SetVisibility(bool Show)
 	{
+		if (DefaultGameObjectCollision)
+		{
+			DefaultGameObjectCollision->RenderCollisionRect = Show;
+		}
+
 		if (Show)
 		{
 			GameObjectBitmap.BitmapParams.BitmapSetToNotRender = false;
-			DefaultGameObjectCollision.RenderCollisionRect = true;
 		}
 		else
 		{
 			GameObjectBitmap.BitmapParams.BitmapSetToNotRender = true;
-			DefaultGameObjectCollision.RenderCollisionRect = false;
 		}
 	}
 };
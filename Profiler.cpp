@@ -0,0 +1,262 @@
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+// Max number of nested zones on a single thread
+#define PROFILER_MAXNUM_ZONE_DEPTH 64
+
+// Storage owned by a single thread, assigned the first time the thread records a zone
+struct SProfilerThreadStorage
+{
+	int ThreadIndex = 0;
+	int CurrentDepth = 0;
+	// Frame number each currently open zone was started in (indexed by zone depth)
+	uint64_t OpenZoneFrameNumbers[PROFILER_MAXNUM_ZONE_DEPTH] = {};
+	SProfilerFrame Frames[PROFILER_MAXNUM_FRAMES];
+};
+
+static std::atomic<uint64_t> ProfilerCurrentFrame = { 1 };
+static uint64_t ProfilerLastCompletedFrame = 0;
+static SProfilerFrameTime ProfilerFrameTimes[PROFILER_MAXNUM_FRAMES];
+
+static std::atomic<int> ProfilerNumThreads = { 0 };
+static SProfilerThreadStorage* ProfilerThreads[PROFILER_MAXNUM_THREADS] = {};
+static thread_local SProfilerThreadStorage* ProfilerCurrentThread = nullptr;
+
+static int64_t GetProfilerTime()
+{
+	static const std::chrono::steady_clock::time_point ProfilerStartTime = std::chrono::steady_clock::now();
+
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - ProfilerStartTime).count();
+}
+
+static SProfilerThreadStorage* GetProfilerThreadStorage()
+{
+	if (ProfilerCurrentThread)
+	{
+		return ProfilerCurrentThread;
+	}
+
+	int ThreadIndex = ProfilerNumThreads.fetch_add(1);
+	if (ThreadIndex >= PROFILER_MAXNUM_THREADS)
+	{
+		return nullptr;
+	}
+
+	ProfilerCurrentThread = new SProfilerThreadStorage();
+	ProfilerCurrentThread->ThreadIndex = ThreadIndex;
+	ProfilerThreads[ThreadIndex] = ProfilerCurrentThread;
+
+	return ProfilerCurrentThread;
+}
+
+// Get the ring buffer slot of a frame on the calling thread,
+// the slot is cleared the first time it is used for a new frame
+static SProfilerFrame* GetProfilerThreadFrame(SProfilerThreadStorage* Storage, uint64_t FrameNumber)
+{
+	SProfilerFrame* Frame = &Storage->Frames[FrameNumber % PROFILER_MAXNUM_FRAMES];
+	if (Frame->FrameNumber != FrameNumber)
+	{
+		Frame->FrameNumber = FrameNumber;
+		Frame->NumZones = 0;
+	}
+
+	return Frame;
+}
+
+void ProfilerBeginFrame()
+{
+	uint64_t FrameNumber = ProfilerCurrentFrame.load();
+	SProfilerFrameTime& FrameTime = ProfilerFrameTimes[FrameNumber % PROFILER_MAXNUM_FRAMES];
+	FrameTime.FrameNumber = FrameNumber;
+	FrameTime.StartTime = GetProfilerTime();
+	FrameTime.EndTime = FrameTime.StartTime;
+}
+
+void ProfilerEndFrame()
+{
+	uint64_t FrameNumber = ProfilerCurrentFrame.load();
+	ProfilerFrameTimes[FrameNumber % PROFILER_MAXNUM_FRAMES].EndTime = GetProfilerTime();
+	ProfilerLastCompletedFrame = FrameNumber;
+	ProfilerCurrentFrame.store(FrameNumber + 1);
+}
+
+int ProfilerBeginZone(const char* ZoneName)
+{
+	SProfilerThreadStorage* Storage = GetProfilerThreadStorage();
+	if (!Storage)
+	{
+		return -1;
+	}
+
+	uint64_t FrameNumber = ProfilerCurrentFrame.load();
+	SProfilerFrame* Frame = GetProfilerThreadFrame(Storage, FrameNumber);
+	if (Storage->CurrentDepth < PROFILER_MAXNUM_ZONE_DEPTH)
+	{
+		Storage->OpenZoneFrameNumbers[Storage->CurrentDepth] = FrameNumber;
+	}
+	Storage->CurrentDepth++;
+
+	if (Frame->NumZones >= PROFILER_MAXNUM_ZONES_PER_FRAME ||
+		Storage->CurrentDepth > PROFILER_MAXNUM_ZONE_DEPTH)
+	{
+		return -1;
+	}
+
+	SProfilerZone& Zone = Frame->Zones[Frame->NumZones];
+	Zone.Name = ZoneName;
+	Zone.Depth = Storage->CurrentDepth - 1;
+	Zone.StartTime = GetProfilerTime();
+	Zone.EndTime = Zone.StartTime;
+
+	return Frame->NumZones++;
+}
+
+void ProfilerEndZone(int ZoneIndex)
+{
+	SProfilerThreadStorage* Storage = ProfilerCurrentThread;
+	if (!Storage)
+	{
+		return;
+	}
+
+	Storage->CurrentDepth--;
+
+	if (ZoneIndex < 0)
+	{
+		return;
+	}
+
+	// A zone that started before a frame boundary is ended in the frame it was started in
+	uint64_t FrameNumber = Storage->OpenZoneFrameNumbers[Storage->CurrentDepth];
+	SProfilerFrame* Frame = &Storage->Frames[FrameNumber % PROFILER_MAXNUM_FRAMES];
+	if (Frame->FrameNumber == FrameNumber &&
+		ZoneIndex < Frame->NumZones)
+	{
+		Frame->Zones[ZoneIndex].EndTime = GetProfilerTime();
+	}
+}
+
+// Get the frame number of a completed frame, returns 0 if the frame is no longer (or not yet) recorded
+static uint64_t GetProfilerCompletedFrameNumber(int FramesAgo)
+{
+	if (FramesAgo < 0 ||
+		FramesAgo >= PROFILER_MAXNUM_FRAMES ||
+		ProfilerLastCompletedFrame <= (uint64_t)FramesAgo)
+	{
+		return 0;
+	}
+
+	return ProfilerLastCompletedFrame - FramesAgo;
+}
+
+float GetProfilerFrameTime(int FramesAgo)
+{
+	uint64_t FrameNumber = GetProfilerCompletedFrameNumber(FramesAgo);
+	if (FrameNumber == 0)
+	{
+		return 0;
+	}
+
+	const SProfilerFrameTime& FrameTime = ProfilerFrameTimes[FrameNumber % PROFILER_MAXNUM_FRAMES];
+	return (FrameTime.EndTime - FrameTime.StartTime) / 1000.f;
+}
+
+float GetProfilerZoneTime(const char* ZoneName, int FramesAgo)
+{
+	uint64_t FrameNumber = GetProfilerCompletedFrameNumber(FramesAgo);
+	if (FrameNumber == 0)
+	{
+		return 0;
+	}
+
+	int64_t ZoneTime = 0;
+	int NumThreads = ProfilerNumThreads.load();
+	for (int ThreadIndex = 0; ThreadIndex < NumThreads && ThreadIndex < PROFILER_MAXNUM_THREADS; ++ThreadIndex)
+	{
+		if (!ProfilerThreads[ThreadIndex])
+		{
+			continue;
+		}
+
+		const SProfilerFrame& Frame = ProfilerThreads[ThreadIndex]->Frames[FrameNumber % PROFILER_MAXNUM_FRAMES];
+		if (Frame.FrameNumber != FrameNumber)
+		{
+			continue;
+		}
+
+		for (int i = 0; i < Frame.NumZones; ++i)
+		{
+			if (std::strcmp(Frame.Zones[i].Name, ZoneName) == 0)
+			{
+				ZoneTime += Frame.Zones[i].EndTime - Frame.Zones[i].StartTime;
+			}
+		}
+	}
+
+	return ZoneTime / 1000.f;
+}
+
+bool ExportProfilerTraceToFile(const char* FileName)
+{
+	std::ofstream File(FileName);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	File << "{\"traceEvents\":[\n";
+	bool FirstEvent = true;
+
+	for (int FramesAgo = PROFILER_MAXNUM_FRAMES - 1; FramesAgo >= 0; --FramesAgo)
+	{
+		uint64_t FrameNumber = GetProfilerCompletedFrameNumber(FramesAgo);
+		if (FrameNumber == 0)
+		{
+			continue;
+		}
+
+		// Frames are added as their own row so frame boundaries are visible in the trace viewer
+		const SProfilerFrameTime& FrameTime = ProfilerFrameTimes[FrameNumber % PROFILER_MAXNUM_FRAMES];
+		if (!FirstEvent)
+		{
+			File << ",\n";
+		}
+		FirstEvent = false;
+		File << "{\"name\":\"Frame " << FrameNumber << "\",\"cat\":\"frame\",\"ph\":\"X\""
+			<< ",\"ts\":" << FrameTime.StartTime
+			<< ",\"dur\":" << (FrameTime.EndTime - FrameTime.StartTime)
+			<< ",\"pid\":0,\"tid\":\"Frames\"}";
+
+		int NumThreads = ProfilerNumThreads.load();
+		for (int ThreadIndex = 0; ThreadIndex < NumThreads && ThreadIndex < PROFILER_MAXNUM_THREADS; ++ThreadIndex)
+		{
+			if (!ProfilerThreads[ThreadIndex])
+			{
+				continue;
+			}
+
+			const SProfilerFrame& Frame = ProfilerThreads[ThreadIndex]->Frames[FrameNumber % PROFILER_MAXNUM_FRAMES];
+			if (Frame.FrameNumber != FrameNumber)
+			{
+				continue;
+			}
+
+			for (int i = 0; i < Frame.NumZones; ++i)
+			{
+				File << ",\n{\"name\":\"" << Frame.Zones[i].Name << "\",\"cat\":\"zone\",\"ph\":\"X\""
+					<< ",\"ts\":" << Frame.Zones[i].StartTime
+					<< ",\"dur\":" << (Frame.Zones[i].EndTime - Frame.Zones[i].StartTime)
+					<< ",\"pid\":0,\"tid\":" << ThreadIndex << "}";
+			}
+		}
+	}
+
+	File << "\n]}\n";
+	File.close();
+
+	return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <cstdint>
+
+// Frame profiler
+//---------------------
+// Lightweight instrumentation used to see where the time of a frame goes.
+// Zones are recorded with the "VOODOO_PROFILE_SCOPE" macro, every thread writes to its own storage
+// and the last "PROFILER_MAXNUM_FRAMES" frames are kept in a ring buffer,
+// so they can be displayed as a graph (in debug mode) or exported as a chrome trace file.
+//
+// The profiler is only compiled in when "VOODOOENGINE_PROFILER" is defined,
+// otherwise the macros expand to nothing and no time is spent on profiling
+//---------------------
+
+// Number of frames kept in the ring buffer
+#define PROFILER_MAXNUM_FRAMES 128
+// Number of zones that can be recorded per frame on each thread (any zone above this is dropped)
+#define PROFILER_MAXNUM_ZONES_PER_FRAME 512
+// Number of threads that can record zones
+#define PROFILER_MAXNUM_THREADS 16
+
+// A single recorded zone, time is in microseconds since the profiler was first used
+struct SProfilerZone
+{
+	const char* Name = nullptr;
+	int64_t StartTime = 0;
+	int64_t EndTime = 0;
+	int Depth = 0;
+};
+
+// All zones recorded by a single thread during a single frame
+struct SProfilerFrame
+{
+	uint64_t FrameNumber = 0;
+	int NumZones = 0;
+	SProfilerZone Zones[PROFILER_MAXNUM_ZONES_PER_FRAME];
+};
+
+// Start and end time of a frame (shared by all threads)
+struct SProfilerFrameTime
+{
+	uint64_t FrameNumber = 0;
+	int64_t StartTime = 0;
+	int64_t EndTime = 0;
+};
+
+// Called by the engine at the start/end of every frame (in "RunEngine")
+extern "C" VOODOOENGINE_API void ProfilerBeginFrame();
+extern "C" VOODOOENGINE_API void ProfilerEndFrame();
+
+// Record a zone on the calling thread,
+// the returned zone index is passed to "ProfilerEndZone" (negative if the zone was dropped)
+extern "C" VOODOOENGINE_API int ProfilerBeginZone(const char* ZoneName);
+extern "C" VOODOOENGINE_API void ProfilerEndZone(int ZoneIndex);
+
+// Get the duration of a completed frame,
+// "FramesAgo" as 0 is the last completed frame, 1 the frame before that etc.
+// Returns 0 if no frame is recorded that far back
+extern "C" VOODOOENGINE_API float GetProfilerFrameTime(int FramesAgo);
+
+// Get the summed duration of all zones with the given name (on all threads) during a completed frame
+extern "C" VOODOOENGINE_API float GetProfilerZoneTime(const char* ZoneName, int FramesAgo);
+
+// Write all frames in the ring buffer to a file using the chrome trace event format
+// (open with "chrome://tracing" or "ui.perfetto.dev"), returns false if the file could not be written
+extern "C" VOODOOENGINE_API bool ExportProfilerTraceToFile(const char* FileName);
+
+// Records a zone for as long as the instance is in scope (use the macros below instead of this directly)
+class ProfilerScopedZone
+{
+public:
+	ProfilerScopedZone(const char* ZoneName)
+	{
+		ZoneIndex = ProfilerBeginZone(ZoneName);
+	}
+	~ProfilerScopedZone()
+	{
+		ProfilerEndZone(ZoneIndex);
+	}
+
+private:
+	int ZoneIndex = -1;
+};
+
+#define VOODOO_PROFILE_CONCAT_INNER(A, B) A##B
+#define VOODOO_PROFILE_CONCAT(A, B) VOODOO_PROFILE_CONCAT_INNER(A, B)
+
+#ifdef VOODOOENGINE_PROFILER
+// Zone name must be a string literal (or any string that outlives the ring buffer)
+#define VOODOO_PROFILE_SCOPE(ZoneName) \
+	ProfilerScopedZone VOODOO_PROFILE_CONCAT(ProfilerZone_, __LINE__)(ZoneName)
+#define VOODOO_PROFILE_BEGIN_FRAME() ProfilerBeginFrame()
+#define VOODOO_PROFILE_END_FRAME() ProfilerEndFrame()
+#else
+#define VOODOO_PROFILE_SCOPE(ZoneName)
+#define VOODOO_PROFILE_BEGIN_FRAME()
+#define VOODOO_PROFILE_END_FRAME()
+#endif
@@ -1,30 +1,31 @@
 #include "Renderer.h"
 #include "VoodooEngine.h"
 
-ID2D1HwndRenderTarget* SetupRenderer(ID2D1HwndRenderTarget* Renderer, HWND HWind)
+#ifdef VOODOOENGINE_PLATFORM_WIN32
+void SetupDefaultBrushes(VoodooEngine* Engine)
 {
-	ID2D1Factory* Factory = nullptr;
-	HRESULT Result = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &Factory);
+	Engine->Renderer->CreateSolidColorBrush(
+		D2D1::ColorF(D2D1::ColorF::Black),
+		&Engine->BlackBrush);
 
-	RECT WinRect;
-	// Get user screen size
-	GetClientRect(HWind, &WinRect);
+	Engine->Renderer->CreateSolidColorBrush(
+		D2D1::ColorF(D2D1::ColorF::White),
+		&Engine->WhiteBrush);
 
-	Result = Factory->CreateHwndRenderTarget(
-		D2D1::RenderTargetProperties(),
-		D2D1::HwndRenderTargetProperties(
-			HWind, D2D1::SizeU(WinRect.right, WinRect.bottom)),
-		&Renderer);
+	Engine->Renderer->CreateSolidColorBrush(
+		D2D1::ColorF(D2D1::ColorF::Green),
+		&Engine->ProfilerGraphBrush);
 
-	Factory->Release();
-
-	return Renderer;
+	Engine->Renderer->CreateSolidColorBrush(
+		D2D1::ColorF(D2D1::ColorF::White),
+		&Engine->CollisionRectBrush);
 }
 
 void AssignCollisionRectangleToRender(
-	ID2D1HwndRenderTarget* Renderer, CollisionComponent* CollisionRectToRender)
+	PlatformRenderTarget* Renderer, PlatformBrush* Brush, CollisionComponent* CollisionRectToRender)
 {
-	if (!CollisionRectToRender->RenderCollisionRect)
+	if (!CollisionRectToRender->RenderCollisionRect ||
+		!IsEnableGroupEnabled(CollisionRectToRender->EnableGroup, GetEnableMasks()))
 	{
 		return;
 	}
@@ -35,9 +36,8 @@ void AssignCollisionRectangleToRender(
 	CollisionRectToRender->CollisionRectColor.G,
 	CollisionRectToRender->CollisionRectColor.B, 1 };
 
-	ID2D1SolidColorBrush* Brush;
-	Renderer->CreateSolidColorBrush(Color, &Brush);
-
+	// Same brush is used for all collision rects (only color/opacity is changed)
+	Brush->SetColor(Color);
 	Brush->SetOpacity(CollisionRectToRender->Opacity);
 
 	D2D1_RECT_F Rect = D2D1::RectF(
@@ -56,51 +56,102 @@ void AssignCollisionRectangleToRender(
 	{
 		Renderer->DrawRectangle(Rect, Brush);
 	}
-
-	Brush->Release();
+	AddMetricCounter(GetEngineMetrics()->DrawCalls);
 }
 
-void RenderCollisionRectangles(ID2D1HwndRenderTarget* Renderer,
-	std::vector<CollisionComponent*> CollisionRectsToRender)
+void RenderCollisionRectangles(PlatformRenderTarget* Renderer, PlatformBrush* Brush,
+	const std::vector<CollisionComponent*>& CollisionRectsToRender)
 {
+	VOODOO_PROFILE_SCOPE("RenderCollisionRectangles");
+
 	for (int i = 0; i < CollisionRectsToRender.size(); ++i)
 	{
-		AssignCollisionRectangleToRender(Renderer, CollisionRectsToRender[i]);
+		AssignCollisionRectangleToRender(Renderer, Brush, CollisionRectsToRender[i]);
 	}
 }
 
-void RenderBitmap(ID2D1HwndRenderTarget* Renderer, BitmapComponent* BitmapToRender)
+// Draw the bitmap source rect of "BitmapParams" at a location,
+// flip/rotation/scale are applied around the center of the bitmap with a render transform (same texture is used)
+static void DrawBitmapWithParameters(PlatformRenderTarget* Renderer,
+	PlatformTexture* Bitmap, SVector Location, const SBitmapParameters& BitmapParams, float Opacity)
 {
-	if (!BitmapToRender)
-	{
-		return;
-	}
-
 	D2D_RECT_F DestRect =
 		D2D1::RectF(
-			BitmapToRender->ComponentLocation.X,
-			BitmapToRender->ComponentLocation.Y,
-			BitmapToRender->ComponentLocation.X + BitmapToRender->BitmapParams.BitmapOffsetRight.X,
-			BitmapToRender->ComponentLocation.Y + BitmapToRender->BitmapParams.BitmapOffsetRight.Y);
+			Location.X,
+			Location.Y,
+			Location.X + BitmapParams.BitmapOffsetRight.X,
+			Location.Y + BitmapParams.BitmapOffsetRight.Y);
 
 	D2D_RECT_F SourceRect =
 		D2D1::RectF(
-			BitmapToRender->BitmapParams.BitmapOffsetLeft.X,
-			BitmapToRender->BitmapParams.BitmapOffsetLeft.Y,
-			BitmapToRender->BitmapParams.BitmapSource.X,
-			BitmapToRender->BitmapParams.BitmapSource.Y);
+			BitmapParams.BitmapOffsetLeft.X,
+			BitmapParams.BitmapOffsetLeft.Y,
+			BitmapParams.BitmapSource.X,
+			BitmapParams.BitmapSource.Y);
+
+	bool Transformed =
+		BitmapParams.FlipX ||
+		BitmapParams.FlipY ||
+		BitmapParams.Rotation != 0 ||
+		BitmapParams.Scale.X != 1 ||
+		BitmapParams.Scale.Y != 1;
+
+	D2D1::Matrix3x2F PreviousTransform;
+	if (Transformed)
+	{
+		D2D1_POINT_2F Center = D2D1::Point2F(
+			Location.X + BitmapParams.BitmapOffsetRight.X * 0.5f,
+			Location.Y + BitmapParams.BitmapOffsetRight.Y * 0.5f);
+		D2D1::Matrix3x2F Scale = D2D1::Matrix3x2F::Scale(
+			BitmapParams.FlipX ? -BitmapParams.Scale.X : BitmapParams.Scale.X,
+			BitmapParams.FlipY ? -BitmapParams.Scale.Y : BitmapParams.Scale.Y,
+			Center);
+		D2D1::Matrix3x2F Rotation = D2D1::Matrix3x2F::Rotation(BitmapParams.Rotation, Center);
+
+		Renderer->GetTransform(&PreviousTransform);
+		Renderer->SetTransform(Scale * Rotation * PreviousTransform);
+	}
 
 	Renderer->DrawBitmap(
-		BitmapToRender->Bitmap,
+		Bitmap,
 		DestRect,
-		BitmapToRender->BitmapParams.Opacity,
+		Opacity,
 		D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
 		SourceRect);
+	AddMetricCounter(GetEngineMetrics()->DrawCalls);
+
+	if (Transformed)
+	{
+		Renderer->SetTransform(PreviousTransform);
+	}
 }
 
-void RenderBitmapByLayer(ID2D1HwndRenderTarget* Renderer,
-	std::vector<BitmapComponent*> StoredBitmaps, int RenderLayer)
+void RenderBitmap(PlatformRenderTarget* Renderer, BitmapComponent* BitmapToRender)
 {
+	if (!BitmapToRender)
+	{
+		return;
+	}
+
+	DrawBitmapWithParameters(Renderer, BitmapToRender->Bitmap, 
+		BitmapToRender->ComponentLocation, BitmapToRender->BitmapParams, BitmapToRender->BitmapParams.Opacity);
+}
+
+// Zone names used by the frame profiler for every render layer pass
+static const char* RenderLayerProfilerZoneNames[RENDERLAYER_MAXNUM + 1] =
+{
+	"RenderLayer 0", "RenderLayer 1", "RenderLayer 2", "RenderLayer 3",
+	"RenderLayer 4", "RenderLayer 5", "RenderLayer 6", "RenderLayer 7",
+	"RenderLayer 8", "RenderLayer 9", "RenderLayer 10"
+};
+
+void RenderBitmapByLayer(PlatformRenderTarget* Renderer,
+	const std::vector<BitmapComponent*>& StoredBitmaps, int RenderLayer)
+{
+	VOODOO_PROFILE_SCOPE(RenderLayer <= RENDERLAYER_MAXNUM ?
+		RenderLayerProfilerZoneNames[RenderLayer] : "RenderLayer");
+
+	const SEnableMasks* EnableMasks = GetEnableMasks();
 	for (int i = 0; i < StoredBitmaps.size(); ++i)
 	{
 		// Go to next if bitmap is not valid
@@ -109,8 +160,9 @@ void RenderBitmapByLayer(ID2D1HwndRenderTarget* Renderer,
 			continue;
 		}
 
-		// Go to next bitmap if set to be hidden in game
-		if (StoredBitmaps[i]->BitmapParams.BitmapSetToNotRender)
+		// Go to next bitmap if set to be hidden in game, or its render layer/level is disabled
+		if (StoredBitmaps[i]->BitmapParams.BitmapSetToNotRender ||
+			!IsEnableGroupEnabled(StoredBitmaps[i]->BitmapParams.EnableGroup, EnableMasks))
 		{
 			continue;
 		}
@@ -125,13 +177,213 @@ void RenderBitmapByLayer(ID2D1HwndRenderTarget* Renderer,
 	}
 }
 
-void RenderBitmaps(ID2D1HwndRenderTarget* Renderer,
-	std::vector<BitmapComponent*> BitmapsToRender, int MaxNumRenderLayers)
+// Render list of the bitmaps currently being rendered sorted by render layer,
+// only used during "RenderBitmaps" (kept between frames so the memory is reused)
+struct SRenderList
 {
+	const std::vector<BitmapComponent*>* Bitmaps = nullptr;
+	const SEnableMasks* EnableMasks = nullptr;
+	int MaxNumRenderLayers = 0;
+	// Render layer of every bitmap (-1 if the bitmap is not rendered)
+	std::vector<int> RenderLayers;
+	std::vector<BitmapComponent*> SortedBitmaps;
+	int RenderLayerStart[RENDERLAYER_MAXNUM + 2] = {};
+};
+static SRenderList RenderList;
+
+// Bitmaps within the render list are built in batches of this size on the job system
+#define RENDERLIST_BUILD_BATCHSIZE 2048
+
+static void BuildRenderListLayers(void* Context, int Begin, int End)
+{
+	SRenderList* List = (SRenderList*)Context;
+	for (int i = Begin; i < End; ++i)
+	{
+		BitmapComponent* Bitmap = (*List->Bitmaps)[i];
+		int RenderLayer = Bitmap->BitmapParams.RenderLayer;
+
+		// Not rendered if bitmap is not valid, set to be hidden in game, disabled or not within the render layers
+		if (!Bitmap->Bitmap ||
+			Bitmap->BitmapParams.BitmapSetToNotRender ||
+			!IsEnableGroupEnabled(Bitmap->BitmapParams.EnableGroup, List->EnableMasks) ||
+			RenderLayer < 0 || RenderLayer > List->MaxNumRenderLayers)
+		{
+			RenderLayer = -1;
+		}
+
+		List->RenderLayers[i] = RenderLayer;
+	}
+}
+
+// Render the sprites of all entities of a render layer (sprite arrays are contiguous, 
+// so every layer scans them directly instead of building a render list)
+static void RenderEntitySprites(PlatformRenderTarget* Renderer, SEntityStorage* Storage, int RenderLayer)
+{
+	const SEnableMasks* EnableMasks = GetEnableMasks();
+	for (int ArchetypeIndex = 0; ArchetypeIndex < EntityComponent_NumArchetypes; ++ArchetypeIndex)
+	{
+		SEntityArchetype& Archetype = Storage->Archetypes[ArchetypeIndex];
+		if (!(Archetype.ComponentMask & EntityComponent_Sprite))
+		{
+			continue;
+		}
+
+		for (int Row = 0; Row < Archetype.Sprites.size(); ++Row)
+		{
+			SEntitySprite& Sprite = Archetype.Sprites[Row];
+			if (!Sprite.Bitmap ||
+				Sprite.BitmapParams.BitmapSetToNotRender ||
+				Sprite.BitmapParams.RenderLayer != RenderLayer ||
+				!IsEnableGroupEnabled(Sprite.BitmapParams.EnableGroup, EnableMasks))
+			{
+				continue;
+			}
+
+			SVector Location = 
+				{ Archetype.Transforms[Row].Location.X + Sprite.Offset.X,
+				Archetype.Transforms[Row].Location.Y + Sprite.Offset.Y };
+
+			DrawBitmapWithParameters(Renderer, Sprite.Bitmap, Location, Sprite.BitmapParams, Sprite.BitmapParams.Opacity);
+		}
+	}
+}
+
+// Render the tiles of a render layer of every enabled tilemap, only chunks with tiles on screen are walked
+static void RenderTilemaps(PlatformRenderTarget* Renderer, VoodooEngine* Engine, int RenderLayer)
+{
+	if (Engine->StoredTilemaps.empty() ||
+		RenderLayer >= TILEMAP_MAXNUM_LAYERS)
+	{
+		return;
+	}
+
+	const SEnableMasks* EnableMasks = GetEnableMasks();
+	const std::vector<STileType>& TileTypes = Engine->TileTypes;
+	D2D1_SIZE_F ScreenSize = Renderer->GetSize();
+	for (int i = 0; i < Engine->StoredTilemaps.size(); ++i)
+	{
+		TilemapGameObject* StoredTilemap = Engine->StoredTilemaps[i];
+		SEnableGroup LayerEnableGroup = StoredTilemap->GameObjectBitmap.BitmapParams.EnableGroup;
+		LayerEnableGroup.RenderLayer = RenderLayer < ENABLEMASKS_MAXNUM_RENDER_LAYERS ? (int8_t)RenderLayer : -1;
+		if (StoredTilemap->GameObjectBitmap.BitmapParams.BitmapSetToNotRender ||
+			!IsEnableGroupEnabled(LayerEnableGroup, EnableMasks))
+		{
+			continue;
+		}
+
+		const STilemapLayer& Layer = StoredTilemap->Tilemap.Layers[RenderLayer];
+		if (Layer.TileSize <= 0)
+		{
+			continue;
+		}
+
+		// Grid starts at the top left of the screen, so chunks on screen are the first columns/rows of chunks
+		float ChunkSize = Layer.TileSize * TILEMAP_CHUNK_SIZE;
+		int NumChunksX = std::min(Layer.NumChunksX, (int)(ScreenSize.width / ChunkSize) + 1);
+		int NumChunksY = std::min(Layer.NumChunksY, (int)(ScreenSize.height / ChunkSize) + 1);
+		for (int ChunkY = 0; ChunkY < NumChunksY; ++ChunkY)
+		{
+			for (int ChunkX = 0; ChunkX < NumChunksX; ++ChunkX)
+			{
+				int ChunkIndex = ChunkY * Layer.NumChunksX + ChunkX;
+				if (Layer.NumChunkTiles[ChunkIndex] == 0)
+				{
+					continue;
+				}
+
+				const uint16_t* ChunkTiles = &Layer.Tiles[(size_t)ChunkIndex * TILEMAP_CHUNK_NUM_TILES];
+				for (int TileIndex = 0; TileIndex < TILEMAP_CHUNK_NUM_TILES; ++TileIndex)
+				{
+					int TileID = ChunkTiles[TileIndex];
+					if (TileID == TILEMAP_EMPTY_TILE ||
+						TileID >= TileTypes.size() ||
+						!TileTypes[TileID].Texture)
+					{
+						continue;
+					}
+
+					const STileType& TileType = TileTypes[TileID];
+					float X = (ChunkX * TILEMAP_CHUNK_SIZE + TileIndex % TILEMAP_CHUNK_SIZE) * Layer.TileSize;
+					float Y = (ChunkY * TILEMAP_CHUNK_SIZE + TileIndex / TILEMAP_CHUNK_SIZE) * Layer.TileSize;
+					Renderer->DrawBitmap(
+						TileType.Texture,
+						D2D1::RectF(X, Y, X + TileType.Size.X, Y + TileType.Size.Y),
+						1,
+						D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+						D2D1::RectF(TileType.SourceLeft.X, TileType.SourceLeft.Y, TileType.SourceRight.X, TileType.SourceRight.Y));
+					AddMetricCounter(GetEngineMetrics()->DrawCalls);
+				}
+			}
+		}
+	}
+}
+
+// Tilemaps and entity sprites of the engine (optional) are rendered before/after the bitmaps of the same render layer
+void RenderBitmaps(PlatformRenderTarget* Renderer,
+	const std::vector<BitmapComponent*>& BitmapsToRender, int MaxNumRenderLayers, 
+	VoodooEngine* GameObjectsEngine = nullptr)
+{
+	if (MaxNumRenderLayers > RENDERLAYER_MAXNUM)
+	{
+		MaxNumRenderLayers = RENDERLAYER_MAXNUM;
+	}
+
+	// Find the render layer of every bitmap in parallel,
+	// then sort by render layer on this thread (keeps the stored order within a render layer)
+	{
+		VOODOO_PROFILE_SCOPE("BuildRenderList");
+		RenderList.Bitmaps = &BitmapsToRender;
+		RenderList.EnableMasks = GetEnableMasks();
+		RenderList.MaxNumRenderLayers = MaxNumRenderLayers;
+		RenderList.RenderLayers.resize(BitmapsToRender.size());
+		ParallelFor((int)BitmapsToRender.size(), RENDERLIST_BUILD_BATCHSIZE, BuildRenderListLayers, &RenderList);
+
+		int NumBitmapsInLayer[RENDERLAYER_MAXNUM + 1] = {};
+		for (int i = 0; i < RenderList.RenderLayers.size(); ++i)
+		{
+			if (RenderList.RenderLayers[i] >= 0)
+			{
+				NumBitmapsInLayer[RenderList.RenderLayers[i]]++;
+			}
+		}
+
+		RenderList.RenderLayerStart[0] = 0;
+		for (int i = 0; i < (MaxNumRenderLayers + 1); ++i)
+		{
+			RenderList.RenderLayerStart[i + 1] = RenderList.RenderLayerStart[i] + NumBitmapsInLayer[i];
+		}
+
+		RenderList.SortedBitmaps.resize(RenderList.RenderLayerStart[MaxNumRenderLayers + 1]);
+		int NextSlot[RENDERLAYER_MAXNUM + 1] = {};
+		for (int i = 0; i < RenderList.RenderLayers.size(); ++i)
+		{
+			int RenderLayer = RenderList.RenderLayers[i];
+			if (RenderLayer >= 0)
+			{
+				RenderList.SortedBitmaps[RenderList.RenderLayerStart[RenderLayer] + NextSlot[RenderLayer]] =
+					BitmapsToRender[i];
+				NextSlot[RenderLayer]++;
+			}
+		}
+		RenderList.Bitmaps = nullptr;
+	}
+
 	// "+1" is there to account for the last render layer 
-	for (int i = 0; i < (MaxNumRenderLayers + 1); ++i)
+	for (int RenderLayer = 0; RenderLayer < (MaxNumRenderLayers + 1); ++RenderLayer)
 	{
-		RenderBitmapByLayer(Renderer, BitmapsToRender, i);
+		VOODOO_PROFILE_SCOPE(RenderLayerProfilerZoneNames[RenderLayer]);
+		if (GameObjectsEngine)
+		{
+			RenderTilemaps(Renderer, GameObjectsEngine, RenderLayer);
+		}
+		for (int i = RenderList.RenderLayerStart[RenderLayer]; i < RenderList.RenderLayerStart[RenderLayer + 1]; ++i)
+		{
+			RenderBitmap(Renderer, RenderList.SortedBitmaps[i]);
+		}
+		if (GameObjectsEngine)
+		{
+			RenderEntitySprites(Renderer, &GameObjectsEngine->EntityStorage, RenderLayer);
+		}
 	}
 }
 
@@ -184,7 +436,22 @@ void RenderUITextsRenderLayer(VoodooEngine* Engine)
 	}
 }
 
-void RenderCustomMouseCursor(ID2D1HwndRenderTarget* Renderer, VoodooEngine* Engine)
+void RenderLevelSaveStatusText(VoodooEngine* Engine)
+{
+	if (Engine->LevelSaveStatusText[0] == L'\0')
+	{
+		return;
+	}
+
+	Engine->Renderer->DrawText(
+		Engine->LevelSaveStatusText,
+		wcslen(Engine->LevelSaveStatusText),
+		Engine->TextFormat,
+		D2D1::RectF(TEXT_LOC_X_LEVELSAVE_STATUS, TEXT_LOC_Y_LEVELSAVE_STATUS, 2000.f, TEXT_LOC_Y_LEVELSAVE_STATUS),
+		Engine->WhiteBrush);
+}
+
+void RenderCustomMouseCursor(PlatformRenderTarget* Renderer, VoodooEngine* Engine)
 {
 	// Render mouse collider as fallback if no custom cursor image file is found or in debug mode
 	if (Engine->Mouse.MouseBitmap.Bitmap == nullptr ||
@@ -213,33 +480,78 @@ void RenderCustomMouseCursor(ID2D1HwndRenderTarget* Renderer, VoodooEngine* Engi
 		return;
 	}
 
-	D2D_RECT_F DestRect =
-		D2D1::RectF(
-			Engine->Mouse.MouseBitmap.ComponentLocation.X,
-			Engine->Mouse.MouseBitmap.ComponentLocation.Y,
-			Engine->Mouse.MouseBitmap.ComponentLocation.X +
-			Engine->Mouse.MouseBitmap.BitmapParams.BitmapOffsetRight.X,
-			Engine->Mouse.MouseBitmap.ComponentLocation.Y +
-			Engine->Mouse.MouseBitmap.BitmapParams.BitmapOffsetRight.Y);
+	DrawBitmapWithParameters(Renderer, Engine->Mouse.MouseBitmap.Bitmap,
+		Engine->Mouse.MouseBitmap.ComponentLocation, Engine->Mouse.MouseBitmap.BitmapParams,
+		// Always render mouse cursor at full opacity
+		1);
+}
 
-	D2D_RECT_F SourceRect =
-		D2D1::RectF(
-			Engine->Mouse.MouseBitmap.BitmapParams.BitmapOffsetLeft.X,
-			Engine->Mouse.MouseBitmap.BitmapParams.BitmapOffsetLeft.Y,
-			Engine->Mouse.MouseBitmap.BitmapParams.BitmapSource.X,
-			Engine->Mouse.MouseBitmap.BitmapParams.BitmapSource.Y);
+// Renders a rolling graph of the frame times recorded by the frame profiler,
+// every bar is a frame (newest to the right) and the line is the frame target time
+void RenderProfilerGraph(VoodooEngine* Engine)
+{
+#ifdef VOODOOENGINE_PROFILER
+	if (!Engine->ProfilerGraphBrush)
+	{
+		return;
+	}
 
-	Renderer->DrawBitmap(
-		Engine->Mouse.MouseBitmap.Bitmap,
-		DestRect,
-		// Always render mouse cursor at full opacity
-		1,
-		D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
-		SourceRect);
+	SVector GraphLocation = { 20, 980 };
+	float BarWidth = 3;
+	// Height in pixels of one millisecond
+	float GraphScale = 4;
+	float GraphHeight = 80;
+
+	const D2D1_COLOR_F ColorWithinTarget = { 0, 1, 0, 1 };
+	const D2D1_COLOR_F ColorAboveTarget = { 1, 0, 0, 1 };
+
+	for (int FramesAgo = 0; FramesAgo < PROFILER_MAXNUM_FRAMES; ++FramesAgo)
+	{
+		float FrameTime = GetProfilerFrameTime(FramesAgo);
+		if (FrameTime <= 0)
+		{
+			break;
+		}
+
+		float BarHeight = FrameTime * GraphScale;
+		if (BarHeight > GraphHeight)
+		{
+			BarHeight = GraphHeight;
+		}
+
+		float BarLocationX = GraphLocation.X + (PROFILER_MAXNUM_FRAMES - 1 - FramesAgo) * BarWidth;
+		D2D1_RECT_F Bar = D2D1::RectF(
+			BarLocationX,
+			GraphLocation.Y + GraphHeight - BarHeight,
+			BarLocationX + BarWidth - 1,
+			GraphLocation.Y + GraphHeight);
+
+		if (FrameTime > Engine->FrameTargetTime)
+		{
+			Engine->ProfilerGraphBrush->SetColor(ColorAboveTarget);
+		}
+		else
+		{
+			Engine->ProfilerGraphBrush->SetColor(ColorWithinTarget);
+		}
+		Engine->Renderer->FillRectangle(Bar, Engine->ProfilerGraphBrush);
+	}
+
+	float TargetLineLocationY = GraphLocation.Y + GraphHeight - (Engine->FrameTargetTime * GraphScale);
+	Engine->Renderer->DrawLine(
+		D2D1::Point2F(GraphLocation.X, TargetLineLocationY),
+		D2D1::Point2F(GraphLocation.X + PROFILER_MAXNUM_FRAMES * BarWidth, TargetLineLocationY),
+		Engine->WhiteBrush);
+#endif
 }
 
 void Render(VoodooEngine* Engine)
 {
+	VOODOO_PROFILE_SCOPE("Render");
+
+	Engine->Renderer->BeginDraw();
+	Engine->Renderer->Clear(Engine->ClearScreenColor);
+
 	// NOTE - 
 	// We use painter's algorithm so the stuff that gets called to render last will be in front of everything else
 
@@ -247,11 +559,11 @@ void Render(VoodooEngine* Engine)
 	RenderBitmap(Engine->Renderer, Engine->CurrentLevelBackground);
 
 	// Render all bitmaps (from gameobjects) stored in engine
-	RenderBitmaps(Engine->Renderer, Engine->StoredBitmapComponents, RENDERLAYER_MAXNUM);
+	RenderBitmaps(Engine->Renderer, Engine->StoredBitmapComponents, RENDERLAYER_MAXNUM, Engine);
 	
 	// Render all collision rects
 	RenderCollisionRectangles(
-		Engine->Renderer, Engine->StoredCollisionComponents);
+		Engine->Renderer, Engine->CollisionRectBrush, Engine->StoredCollisionComponents);
 
 	// Call render interface to all inherited objects 
 	// (If you want to override an object to render in front of everything else)
@@ -263,23 +575,47 @@ void Render(VoodooEngine* Engine)
 	// Render level editor related stuff
 	if (Engine->EditorMode)
 	{
+		VOODOO_PROFILE_SCOPE("RenderLevelEditor");
 		RenderLevelEditor(Engine);
 		RenderUITextsRenderLayer(Engine);
+		RenderLevelSaveStatusText(Engine);
 	}
 
 	// Render debug related stuff
 	if (Engine->DebugMode)
 	{
 		RenderCollisionRectangles(
-			Engine->Renderer, Engine->StoredEditorCollisionComponents);
+			Engine->Renderer, Engine->CollisionRectBrush, Engine->StoredEditorCollisionComponents);
 
 		// Default render layer is used
 		RenderBitmaps(
 			Engine->Renderer, Engine->StoredScreenPrintTexts, 0);
+
+		RenderProfilerGraph(Engine);
 	}
 
 	// This replaces the default windows system mouse cursor 
 	// (The windows system mouse cursor is hidden)
 	// Always rendered on top of everything else
 	RenderCustomMouseCursor(Engine->Renderer, Engine);
+
+	{
+		VOODOO_PROFILE_SCOPE("EndDraw");
+		Engine->Renderer->EndDraw();
+	}
+}
+#else
+// Null renderer (headless builds), nothing is ever drawn
+
+void SetupDefaultBrushes(VoodooEngine* Engine)
+{
+}
+
+void RenderBitmap(PlatformRenderTarget* Renderer, BitmapComponent* BitmapToRender)
+{
+}
+
+void Render(VoodooEngine* Engine)
+{
 }
+#endif
@@ -1,14 +1,11 @@
 #pragma once
 
 #include "VoodooEngineDLLExport.h"
+#include "Platform.h"
 #include "CollisionComponent.h"
 #include "BitmapComponent.h"
 #include <vector> 
 
-// Direct2D API
-#include <d2d1.h>
-#pragma comment(lib, "d2d1.lib")
-
 class VoodooEngine;
 
 // Render layer names used by the level editor
@@ -27,13 +24,13 @@ struct SRenderLayerNames
 	const wchar_t* RenderlayerName_10 = { L"RenderLayer 10" };
 };
 
-// Called by the engine during init
-extern "C" VOODOOENGINE_API ID2D1HwndRenderTarget* SetupRenderer(
-	ID2D1HwndRenderTarget* Renderer, HWND HWind);
+// Called by the engine during init, 
+// setup default brushes used by various objects that needs a brush (so we don't create new brushes for every object)
+extern "C" VOODOOENGINE_API void SetupDefaultBrushes(VoodooEngine* Engine);
 
 // Optional can be called during the game in conjuction with the interface "IRender" 
 // to override rendering of an object to be rendered on top of every other game object regardless of render layer
-extern "C" void RenderBitmap(ID2D1HwndRenderTarget* Renderer, BitmapComponent* BitmapToRender);
+extern "C" void RenderBitmap(PlatformRenderTarget* Renderer, BitmapComponent* BitmapToRender);
 
 // Called during the game loop
 extern "C" VOODOOENGINE_API void Render(VoodooEngine* Engine);
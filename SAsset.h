@@ -14,7 +14,7 @@ struct SAssetTextureAtlas
 // Contains all the information for game assets
 struct SAssetParameters
 {
-	ID2D1Bitmap* TextureAtlasBitmap = nullptr;
+	PlatformTexture* TextureAtlasBitmap = nullptr;
 	SVector TextureAtlasWidthHeight = { 0, 0 };
 	int TextureAtlasOffsetMultiplierHeight = 1;
 	int RenderLayer = 0;
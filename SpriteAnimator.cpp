@@ -0,0 +1,463 @@
+#include "SpriteAnimator.h"
+#include "JobSystem.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static SAnimatorRecord* GetAnimatorRecord(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator)
+{
+	if (Animator.Index >= Registry->Records.size())
+	{
+		return nullptr;
+	}
+
+	SAnimatorRecord* Record = &Registry->Records[Animator.Index];
+	if (Record->Generation != Animator.Generation ||
+		Record->Slot < 0)
+	{
+		return nullptr;
+	}
+
+	return Record;
+}
+
+static void ShowAnimationFrame(SSpriteAnimator* Animator, const SAnimationFrame& Frame)
+{
+	if (!Animator->Target)
+	{
+		return;
+	}
+
+	Animator->Target->BitmapOffsetLeft = Frame.BitmapOffsetLeft;
+	Animator->Target->BitmapSource = Frame.BitmapSource;
+	Animator->Target->BitmapOffsetRight = Frame.BitmapOffsetRight;
+}
+
+// Set the animator to the first frame of its clip
+static void RestartSpriteAnimator(SSpriteAnimatorRegistry* Registry, SSpriteAnimator* Animator)
+{
+	Animator->Frame = 0;
+	Animator->Direction = 1;
+	Animator->FrameTime = 0;
+	Animator->Finished = false;
+
+	const SAnimationClip& Clip = Registry->Library.Clips[Animator->Clip];
+	ShowAnimationFrame(Animator, Registry->Library.Frames[Clip.FirstFrame]);
+}
+
+SAnimationFrame MakeAnimationFrame(
+	float SourceX, float SourceY, float Width, float Height, float Duration, int EventID)
+{
+	SAnimationFrame Frame;
+	Frame.BitmapOffsetLeft = { SourceX, SourceY };
+	Frame.BitmapSource = { SourceX + Width, SourceY + Height };
+	Frame.BitmapOffsetRight = { Width, Height };
+	Frame.Duration = Duration;
+	Frame.EventID = EventID;
+
+	return Frame;
+}
+
+bool AddAnimationClip(SSpriteAnimatorRegistry* Registry,
+	int ClipID, EAnimationPlayback Playback, const SAnimationFrame* Frames, int NumFrames)
+{
+	if (!Frames ||
+		NumFrames <= 0)
+	{
+		return false;
+	}
+
+	SAnimationClipLibrary& Library = Registry->Library;
+
+	SAnimationClip Clip;
+	Clip.ClipID = ClipID;
+	Clip.Playback = Playback;
+	Clip.FirstFrame = (int)Library.Frames.size();
+	Clip.NumFrames = NumFrames;
+	for (int i = 0; i < NumFrames; ++i)
+	{
+		Library.Frames.push_back(Frames[i]);
+		if (Library.Frames.back().Duration < SPRITEANIMATOR_MIN_FRAME_DURATION)
+		{
+			Library.Frames.back().Duration = SPRITEANIMATOR_MIN_FRAME_DURATION;
+		}
+	}
+
+	auto Iterator = Library.ClipIndices.find(ClipID);
+	if (Iterator == Library.ClipIndices.end())
+	{
+		Library.ClipIndices[ClipID] = (int)Library.Clips.size();
+		Library.Clips.push_back(Clip);
+		return true;
+	}
+
+	// Replaced clip, frames of the old clip are left unused until the clips are cleared
+	// and animators playing it are restarted (the number of frames may have changed)
+	int ClipIndex = Iterator->second;
+	Library.Clips[ClipIndex] = Clip;
+	for (int i = 0; i < Registry->Animators.size(); ++i)
+	{
+		if (Registry->Animators[i].Clip == ClipIndex)
+		{
+			RestartSpriteAnimator(Registry, &Registry->Animators[i]);
+		}
+	}
+
+	return true;
+}
+
+bool AddAnimationClipFromSpriteSheetRow(SSpriteAnimatorRegistry* Registry,
+	int ClipID, EAnimationPlayback Playback, int FrameWidth, int FrameHeight, int Row, int NumFrames, float FrameDuration)
+{
+	std::vector<SAnimationFrame> Frames;
+	for (int i = 0; i < NumFrames; ++i)
+	{
+		Frames.push_back(MakeAnimationFrame(
+			(float)(FrameWidth * i), (float)(FrameHeight * Row), (float)FrameWidth, (float)FrameHeight, FrameDuration));
+	}
+
+	return AddAnimationClip(Registry, ClipID, Playback, Frames.data(), (int)Frames.size());
+}
+
+static EAnimationPlayback GetAnimationPlayback(const std::string& PlaybackName)
+{
+	if (PlaybackName == "once")
+	{
+		return AnimationPlayback_Once;
+	}
+	else if (PlaybackName == "pingpong")
+	{
+		return AnimationPlayback_PingPong;
+	}
+
+	return AnimationPlayback_Loop;
+}
+
+bool LoadAnimationClipsFromFile(SSpriteAnimatorRegistry* Registry, const wchar_t* FileName)
+{
+	std::ifstream File;
+	OpenPlatformFile(File, FileName, std::ios_base::in);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	int ClipID = -1;
+	EAnimationPlayback Playback = AnimationPlayback_Loop;
+	std::vector<SAnimationFrame> Frames;
+
+	std::string Line;
+	while (getline(File, Line))
+	{
+		std::stringstream Stream(Line);
+		std::string Type;
+		if (!(Stream >> Type) ||
+			Type.compare(0, 2, "//") == 0)
+		{
+			continue;
+		}
+
+		if (Type == "clip")
+		{
+			// Previous clip is complete
+			if (ClipID >= 0)
+			{
+				AddAnimationClip(Registry, ClipID, Playback, Frames.data(), (int)Frames.size());
+			}
+
+			std::string PlaybackName;
+			Stream >> ClipID >> PlaybackName;
+			Playback = GetAnimationPlayback(PlaybackName);
+			Frames.clear();
+		}
+		else if (Type == "frame")
+		{
+			float SourceX = 0;
+			float SourceY = 0;
+			float Width = 0;
+			float Height = 0;
+			float Duration = 0;
+			int EventID = ANIMATION_NO_EVENT;
+			if (Stream >> SourceX >> SourceY >> Width >> Height >> Duration)
+			{
+				// Event is optional
+				Stream >> EventID;
+				Frames.push_back(MakeAnimationFrame(SourceX, SourceY, Width, Height, Duration, EventID));
+			}
+		}
+	}
+
+	if (ClipID >= 0)
+	{
+		AddAnimationClip(Registry, ClipID, Playback, Frames.data(), (int)Frames.size());
+	}
+
+	File.close();
+	return true;
+}
+
+void ClearAnimationClips(SSpriteAnimatorRegistry* Registry)
+{
+	for (int i = 0; i < Registry->Animators.size(); ++i)
+	{
+		Registry->Animators[i].Clip = -1;
+	}
+
+	Registry->Library.Clips.clear();
+	Registry->Library.Frames.clear();
+	Registry->Library.ClipIndices.clear();
+}
+
+SAnimatorHandle CreateSpriteAnimator(SSpriteAnimatorRegistry* Registry,
+	SBitmapParameters* Target, AnimationEventCallback EventCallback, void* EventContext)
+{
+	uint32_t RecordIndex = 0;
+	if (!Registry->FreeRecords.empty())
+	{
+		RecordIndex = Registry->FreeRecords.back();
+		Registry->FreeRecords.pop_back();
+	}
+	else
+	{
+		RecordIndex = (uint32_t)Registry->Records.size();
+		Registry->Records.emplace_back();
+	}
+
+	SAnimatorHandle Animator;
+	Animator.Index = RecordIndex;
+	Animator.Generation = Registry->Records[RecordIndex].Generation;
+
+	Registry->Records[RecordIndex].Slot = (int)Registry->Animators.size();
+	Registry->Animators.emplace_back();
+	Registry->Animators.back().Target = Target;
+	Registry->Animators.back().EventCallback = EventCallback;
+	Registry->Animators.back().EventContext = EventContext;
+	Registry->Handles.push_back(Animator);
+
+	return Animator;
+}
+
+bool DestroySpriteAnimator(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator)
+{
+	SAnimatorRecord* Record = GetAnimatorRecord(Registry, Animator);
+	if (!Record)
+	{
+		return false;
+	}
+
+	// Move the last animator into the slot of the destroyed animator
+	int Slot = Record->Slot;
+	int LastSlot = (int)Registry->Animators.size() - 1;
+	if (Slot != LastSlot)
+	{
+		Registry->Animators[Slot] = Registry->Animators[LastSlot];
+		Registry->Handles[Slot] = Registry->Handles[LastSlot];
+		Registry->Records[Registry->Handles[Slot].Index].Slot = Slot;
+	}
+	Registry->Animators.pop_back();
+	Registry->Handles.pop_back();
+
+	Record->Generation++;
+	Record->Slot = -1;
+	Registry->FreeRecords.push_back(Animator.Index);
+
+	return true;
+}
+
+bool IsSpriteAnimatorValid(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator)
+{
+	return GetAnimatorRecord(Registry, Animator) != nullptr;
+}
+
+void DestroyAllSpriteAnimators(SSpriteAnimatorRegistry* Registry)
+{
+	for (int i = 0; i < Registry->Handles.size(); ++i)
+	{
+		SAnimatorRecord& Record = Registry->Records[Registry->Handles[i].Index];
+		Record.Generation++;
+		Record.Slot = -1;
+		Registry->FreeRecords.push_back(Registry->Handles[i].Index);
+	}
+
+	Registry->Animators.clear();
+	Registry->Handles.clear();
+}
+
+SSpriteAnimator* GetSpriteAnimator(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator)
+{
+	SAnimatorRecord* Record = GetAnimatorRecord(Registry, Animator);
+	if (!Record)
+	{
+		return nullptr;
+	}
+
+	return &Registry->Animators[Record->Slot];
+}
+
+bool PlaySpriteAnimation(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator, int ClipID, bool Restart)
+{
+	SSpriteAnimator* AnimatorToPlay = GetSpriteAnimator(Registry, Animator);
+	if (!AnimatorToPlay)
+	{
+		return false;
+	}
+
+	auto Iterator = Registry->Library.ClipIndices.find(ClipID);
+	if (Iterator == Registry->Library.ClipIndices.end())
+	{
+		return false;
+	}
+
+	if (AnimatorToPlay->Clip == Iterator->second &&
+		!Restart)
+	{
+		return true;
+	}
+
+	AnimatorToPlay->Clip = Iterator->second;
+	RestartSpriteAnimator(Registry, AnimatorToPlay);
+
+	return true;
+}
+
+void StopSpriteAnimation(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator)
+{
+	SSpriteAnimator* AnimatorToStop = GetSpriteAnimator(Registry, Animator);
+	if (AnimatorToStop)
+	{
+		AnimatorToStop->Clip = -1;
+	}
+}
+
+void SetSpriteAnimationSpeed(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator, float PlaybackSpeed)
+{
+	SSpriteAnimator* AnimatorToSet = GetSpriteAnimator(Registry, Animator);
+	if (AnimatorToSet)
+	{
+		AnimatorToSet->PlaybackSpeed = PlaybackSpeed;
+	}
+}
+
+bool IsSpriteAnimationFinished(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator)
+{
+	SSpriteAnimator* AnimatorToTest = GetSpriteAnimator(Registry, Animator);
+	return AnimatorToTest && AnimatorToTest->Finished;
+}
+
+// Move to the next frame of the clip, returns false if a clip played once is already on its last frame
+static bool AdvanceAnimationFrame(SSpriteAnimator* Animator, const SAnimationClip& Clip)
+{
+	switch (Clip.Playback)
+	{
+	case AnimationPlayback_Loop:
+		Animator->Frame = (Animator->Frame + 1) % Clip.NumFrames;
+		return true;
+
+	case AnimationPlayback_Once:
+		if (Animator->Frame + 1 >= Clip.NumFrames)
+		{
+			return false;
+		}
+		Animator->Frame++;
+		return true;
+
+	case AnimationPlayback_PingPong:
+		if (Clip.NumFrames > 1)
+		{
+			int NextFrame = Animator->Frame + Animator->Direction;
+			if (NextFrame < 0 ||
+				NextFrame >= Clip.NumFrames)
+			{
+				Animator->Direction = -Animator->Direction;
+				NextFrame = Animator->Frame + Animator->Direction;
+			}
+			Animator->Frame = NextFrame;
+		}
+		return true;
+	}
+
+	return true;
+}
+
+struct SSpriteAnimatorBatch
+{
+	SSpriteAnimatorRegistry* Registry = nullptr;
+	float DeltaTime = 0;
+};
+
+static void UpdateSpriteAnimatorBatch(void* Context, int Begin, int End)
+{
+	SSpriteAnimatorBatch* Batch = (SSpriteAnimatorBatch*)Context;
+	const SAnimationClipLibrary& Library = Batch->Registry->Library;
+	SSpriteAnimator* Animators = Batch->Registry->Animators.data();
+
+	for (int i = Begin; i < End; ++i)
+	{
+		SSpriteAnimator* Animator = &Animators[i];
+		Animator->NumPendingEvents = 0;
+		if (Animator->Clip < 0 ||
+			Animator->Finished)
+		{
+			continue;
+		}
+
+		const SAnimationClip& Clip = Library.Clips[Animator->Clip];
+		const SAnimationFrame* ClipFrames = &Library.Frames[Clip.FirstFrame];
+		int StartFrame = Animator->Frame;
+
+		Animator->FrameTime += Batch->DeltaTime * Animator->PlaybackSpeed;
+		while (Animator->FrameTime >= ClipFrames[Animator->Frame].Duration)
+		{
+			Animator->FrameTime -= ClipFrames[Animator->Frame].Duration;
+			if (!AdvanceAnimationFrame(Animator, Clip))
+			{
+				Animator->Finished = true;
+				Animator->FrameTime = 0;
+				break;
+			}
+
+			int EventID = ClipFrames[Animator->Frame].EventID;
+			if (EventID != ANIMATION_NO_EVENT &&
+				Animator->EventCallback &&
+				Animator->NumPendingEvents < SPRITEANIMATOR_MAXNUM_PENDING_EVENTS)
+			{
+				Animator->PendingEvents[Animator->NumPendingEvents++] = EventID;
+			}
+		}
+
+		if (Animator->Frame != StartFrame)
+		{
+			ShowAnimationFrame(Animator, ClipFrames[Animator->Frame]);
+		}
+	}
+}
+
+void UpdateSpriteAnimators(SSpriteAnimatorRegistry* Registry, float DeltaTime)
+{
+	VOODOO_PROFILE_SCOPE("UpdateSpriteAnimators");
+
+	SSpriteAnimatorBatch Batch;
+	Batch.Registry = Registry;
+	Batch.DeltaTime = DeltaTime;
+	ParallelFor((int)Registry->Animators.size(), SPRITEANIMATOR_UPDATE_BATCHSIZE, UpdateSpriteAnimatorBatch, &Batch);
+
+	// Events are sent in animator order after all animators are updated,
+	// an event callback may create/destroy animators so the size is checked every iteration
+	for (int i = 0; i < Registry->Animators.size(); ++i)
+	{
+		if (Registry->Animators[i].NumPendingEvents == 0)
+		{
+			continue;
+		}
+
+		// Copied since the animator can be moved by the callback
+		SSpriteAnimator Animator = Registry->Animators[i];
+		Registry->Animators[i].NumPendingEvents = 0;
+		for (int Event = 0; Event < Animator.NumPendingEvents; ++Event)
+		{
+			Animator.EventCallback(Animator.EventContext, Animator.PendingEvents[Event]);
+		}
+	}
+}
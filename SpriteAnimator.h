@@ -0,0 +1,157 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "BitmapComponent.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Sprite animator
+//---------------------
+// Animation clips are defined once (loaded from a data file or added from code) as a list of frames,
+// every frame stores its source rect in the sprite sheet in the same layout as "SBitmapParameters",
+// so showing a frame is a copy of the precomputed rect instead of computing it from frame size and state.
+// Animators play a clip on a bitmap, all animators are stored contiguously in a registry
+// and updated in one batch per frame by the engine (game code only plays/stops clips).
+//
+// Playback is either loop, once (stops on the last frame) or ping-pong (forward then backward),
+// a frame can have an event ID that is sent to the event callback of the animator when the frame is shown
+// (events are sent on the main thread once all animators have been updated)
+//
+// Clip file format (one entry per line, frames are added to the clip above them, lines starting with "//" are skipped):
+//   clip <ClipID> <loop/once/pingpong>
+//   frame <SourceX> <SourceY> <Width> <Height> <DurationInSeconds> [EventID]
+//
+// NOTE: An animator writes to the bitmap parameters it was created with,
+// destroy the animator before the bitmap is deleted (e.g. in "OnGameObjectDeleted")
+//---------------------
+
+#define ANIMATION_NO_EVENT -1
+#define SPRITEANIMATOR_INVALID_INDEX 0xFFFFFFFF
+// Max number of events an animator can send in a single update (more frames than this passed in one update
+// e.g. after a long frame, only the first events are sent)
+#define SPRITEANIMATOR_MAXNUM_PENDING_EVENTS 4
+#define SPRITEANIMATOR_UPDATE_BATCHSIZE 256
+// Frames shorter than this are clamped (so an update always ends)
+#define SPRITEANIMATOR_MIN_FRAME_DURATION 0.001f
+
+enum EAnimationPlayback
+{
+	AnimationPlayback_Loop = 0,
+	AnimationPlayback_Once = 1,
+	AnimationPlayback_PingPong = 2
+};
+
+struct SAnimationFrame
+{
+	// Source rect (same layout as "SBitmapParameters", top left, bottom right and size)
+	SVector BitmapOffsetLeft;
+	SVector BitmapSource;
+	SVector BitmapOffsetRight;
+	float Duration = 0.1f;
+	int EventID = ANIMATION_NO_EVENT;
+};
+
+// Frames of a clip are stored in a range of the library frames
+struct SAnimationClip
+{
+	int ClipID = -1;
+	EAnimationPlayback Playback = AnimationPlayback_Loop;
+	int FirstFrame = 0;
+	int NumFrames = 0;
+};
+
+struct SAnimationClipLibrary
+{
+	std::vector<SAnimationClip> Clips;
+	std::vector<SAnimationFrame> Frames;
+	// Clip ID to index in "Clips"
+	std::map<int, int> ClipIndices;
+};
+
+typedef void(*AnimationEventCallback)(void* Context, int EventID);
+
+// Stays safe to use after the animator has been destroyed (the generation no longer matches)
+struct SAnimatorHandle
+{
+	uint32_t Index = SPRITEANIMATOR_INVALID_INDEX;
+	uint32_t Generation = 0;
+};
+
+struct SSpriteAnimator
+{
+	SBitmapParameters* Target = nullptr;
+	// Index in the library clips (-1 if no clip is playing)
+	int Clip = -1;
+	// Frame within the clip
+	int Frame = 0;
+	// 1 when playing forward, -1 when playing backward (ping-pong)
+	int Direction = 1;
+	float FrameTime = 0;
+	float PlaybackSpeed = 1;
+	// Set when a clip played once has reached the end
+	bool Finished = false;
+	AnimationEventCallback EventCallback = nullptr;
+	void* EventContext = nullptr;
+	int NumPendingEvents = 0;
+	int PendingEvents[SPRITEANIMATOR_MAXNUM_PENDING_EVENTS] = {};
+};
+
+struct SAnimatorRecord
+{
+	uint32_t Generation = 1;
+	// Index in the registry animators (-1 if the record is not in use)
+	int Slot = -1;
+};
+
+struct SSpriteAnimatorRegistry
+{
+	SAnimationClipLibrary Library;
+	// Animators are kept tightly packed (last animator is moved into the slot of a destroyed animator)
+	std::vector<SSpriteAnimator> Animators;
+	// Handle of the animator in the same slot
+	std::vector<SAnimatorHandle> Handles;
+	std::vector<SAnimatorRecord> Records;
+	std::vector<uint32_t> FreeRecords;
+};
+
+// Make a frame from a source rect in the sprite sheet
+extern "C" VOODOOENGINE_API SAnimationFrame MakeAnimationFrame(
+	float SourceX, float SourceY, float Width, float Height, float Duration, int EventID = ANIMATION_NO_EVENT);
+
+// Add a clip (a clip already added with the same ID is replaced), returns false if there are no frames
+extern "C" VOODOOENGINE_API bool AddAnimationClip(SSpriteAnimatorRegistry* Registry,
+	int ClipID, EAnimationPlayback Playback, const SAnimationFrame* Frames, int NumFrames);
+// Add a clip of equally sized frames from left to right on a row of a sprite sheet (first row is 0)
+extern "C" VOODOOENGINE_API bool AddAnimationClipFromSpriteSheetRow(SSpriteAnimatorRegistry* Registry,
+	int ClipID, EAnimationPlayback Playback, int FrameWidth, int FrameHeight, int Row, int NumFrames, float FrameDuration);
+// Add all clips of a clip file (see format above), returns false if the file could not be opened
+extern "C" VOODOOENGINE_API bool LoadAnimationClipsFromFile(SSpriteAnimatorRegistry* Registry, const wchar_t* FileName);
+// Remove all clips, all animators are stopped
+extern "C" VOODOOENGINE_API void ClearAnimationClips(SSpriteAnimatorRegistry* Registry);
+
+// Create an animator writing the source rect of the playing clip frame to "Target"
+extern "C" VOODOOENGINE_API SAnimatorHandle CreateSpriteAnimator(SSpriteAnimatorRegistry* Registry,
+	SBitmapParameters* Target, AnimationEventCallback EventCallback = nullptr, void* EventContext = nullptr);
+// Returns false if the animator is already destroyed
+extern "C" VOODOOENGINE_API bool DestroySpriteAnimator(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator);
+extern "C" VOODOOENGINE_API bool IsSpriteAnimatorValid(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator);
+extern "C" VOODOOENGINE_API void DestroyAllSpriteAnimators(SSpriteAnimatorRegistry* Registry);
+// Returns nullptr if the animator is not valid
+// (pointer is only valid until the next time an animator is created/destroyed)
+extern "C" VOODOOENGINE_API SSpriteAnimator* GetSpriteAnimator(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator);
+
+// Play a clip from the first frame (the first frame is shown directly),
+// if the clip is already playing it keeps playing unless "Restart" is set, returns false if the clip is not found
+extern "C" VOODOOENGINE_API bool PlaySpriteAnimation(
+	SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator, int ClipID, bool Restart = false);
+// Stop playing, the current frame stays shown
+extern "C" VOODOOENGINE_API void StopSpriteAnimation(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator);
+extern "C" VOODOOENGINE_API void SetSpriteAnimationSpeed(
+	SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator, float PlaybackSpeed);
+// True if a clip played once has shown its last frame for its full duration
+extern "C" VOODOOENGINE_API bool IsSpriteAnimationFinished(SSpriteAnimatorRegistry* Registry, SAnimatorHandle Animator);
+
+// Called by the engine every frame while the game is running, advances all animators
+// (in batches on the job system) and then sends the frame events
+extern "C" VOODOOENGINE_API void UpdateSpriteAnimators(SSpriteAnimatorRegistry* Registry, float DeltaTime);
@@ -1,6 +1,7 @@
 #include "Text.h"
 #include "VoodooEngine.h"
 
+#ifdef VOODOOENGINE_PLATFORM_WIN32
 void CreateUITextFormat(VoodooEngine* Engine)
 {
 	IDWriteFactory* IDWriteFactory = nullptr;
@@ -22,3 +23,9 @@ void CreateUITextFormat(VoodooEngine* Engine)
 
 	IDWriteFactory->Release();
 }
+#else
+// No text rendering on the null platform
+void CreateUITextFormat(VoodooEngine* Engine)
+{
+}
+#endif
@@ -1,10 +1,7 @@
 #pragma once
 
 #include "VoodooEngineDLLExport.h"
-
-// DirectWrite API
-#include <dwrite.h>
-#pragma comment(lib, "Dwrite.lib")
+#include "Platform.h"
 
 class VoodooEngine;
 
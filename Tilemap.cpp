@@ -0,0 +1,518 @@
+#include "Tilemap.h"
+#include "VoodooEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// Level file lines of tile rows start with this (never a number, so older engines skip them as not a game object)
+#define TILEMAP_ROW_PREFIX "tiles "
+
+// Grow a layer to fit a cell, the number of chunk columns is at least doubled
+// (growing the columns moves every tile to its new chunk index, growing the rows only appends chunks)
+static void GrowTilemapLayer(STilemapLayer* Layer, int Column, int Row)
+{
+	int NumChunksX = Layer->NumChunksX;
+	if (Column >= NumChunksX * TILEMAP_CHUNK_SIZE)
+	{
+		NumChunksX = std::max(Column / TILEMAP_CHUNK_SIZE + 1,
+			std::min(NumChunksX * 2, TILEMAP_MAXNUM_COLUMNS / TILEMAP_CHUNK_SIZE));
+	}
+	int NumChunksY = std::max(Layer->NumChunksY, Row / TILEMAP_CHUNK_SIZE + 1);
+
+	if (NumChunksX == Layer->NumChunksX ||
+		Layer->Tiles.empty())
+	{
+		Layer->Tiles.resize((size_t)NumChunksX * NumChunksY * TILEMAP_CHUNK_NUM_TILES, TILEMAP_EMPTY_TILE);
+		Layer->NumChunkTiles.resize((size_t)NumChunksX * NumChunksY, 0);
+	}
+	else
+	{
+		std::vector<uint16_t> Tiles((size_t)NumChunksX * NumChunksY * TILEMAP_CHUNK_NUM_TILES, TILEMAP_EMPTY_TILE);
+		std::vector<uint16_t> NumChunkTiles((size_t)NumChunksX * NumChunksY, 0);
+		for (int ChunkY = 0; ChunkY < Layer->NumChunksY; ++ChunkY)
+		{
+			for (int ChunkX = 0; ChunkX < Layer->NumChunksX; ++ChunkX)
+			{
+				int PreviousChunkIndex = ChunkY * Layer->NumChunksX + ChunkX;
+				int ChunkIndex = ChunkY * NumChunksX + ChunkX;
+				std::copy_n(Layer->Tiles.begin() + (size_t)PreviousChunkIndex * TILEMAP_CHUNK_NUM_TILES,
+					TILEMAP_CHUNK_NUM_TILES, Tiles.begin() + (size_t)ChunkIndex * TILEMAP_CHUNK_NUM_TILES);
+				NumChunkTiles[ChunkIndex] = Layer->NumChunkTiles[PreviousChunkIndex];
+			}
+		}
+
+		Layer->Tiles.swap(Tiles);
+		Layer->NumChunkTiles.swap(NumChunkTiles);
+	}
+
+	Layer->NumChunksX = NumChunksX;
+	Layer->NumChunksY = NumChunksY;
+}
+
+bool SetTile(STilemap* Tilemap, int RenderLayer, float TileSize, int Column, int Row, int TileID)
+{
+	if (RenderLayer < 0 || RenderLayer >= TILEMAP_MAXNUM_LAYERS ||
+		Column < 0 || Column >= TILEMAP_MAXNUM_COLUMNS ||
+		Row < 0 || Row >= TILEMAP_MAXNUM_ROWS ||
+		TileID < TILEMAP_EMPTY_TILE || TileID >= TILEMAP_MAXNUM_TILE_TYPES)
+	{
+		return false;
+	}
+
+	STilemapLayer* Layer = &Tilemap->Layers[RenderLayer];
+	if (Column >= Layer->NumChunksX * TILEMAP_CHUNK_SIZE ||
+		Row >= Layer->NumChunksY * TILEMAP_CHUNK_SIZE)
+	{
+		// Nothing to erase outside of the layer
+		if (TileID == TILEMAP_EMPTY_TILE)
+		{
+			return false;
+		}
+
+		if (Layer->TileSize <= 0 &&
+			TileSize <= 0)
+		{
+			return false;
+		}
+
+		GrowTilemapLayer(Layer, Column, Row);
+	}
+
+	if (Layer->TileSize <= 0)
+	{
+		Layer->TileSize = TileSize;
+	}
+
+	int TileIndex = GetTilemapTileIndex(Layer, Column, Row);
+	uint16_t PreviousTileID = Layer->Tiles[TileIndex];
+	if (PreviousTileID == TileID)
+	{
+		return false;
+	}
+
+	Layer->Tiles[TileIndex] = (uint16_t)TileID;
+	uint16_t& NumChunkTiles = Layer->NumChunkTiles[TileIndex / TILEMAP_CHUNK_NUM_TILES];
+	if (PreviousTileID == TILEMAP_EMPTY_TILE)
+	{
+		NumChunkTiles++;
+	}
+	else if (TileID == TILEMAP_EMPTY_TILE)
+	{
+		NumChunkTiles--;
+	}
+
+	return true;
+}
+
+int GetTile(const STilemap* Tilemap, int RenderLayer, int Column, int Row)
+{
+	if (RenderLayer < 0 || RenderLayer >= TILEMAP_MAXNUM_LAYERS)
+	{
+		return TILEMAP_EMPTY_TILE;
+	}
+
+	const STilemapLayer* Layer = &Tilemap->Layers[RenderLayer];
+	if (Column < 0 || Column >= Layer->NumChunksX * TILEMAP_CHUNK_SIZE ||
+		Row < 0 || Row >= Layer->NumChunksY * TILEMAP_CHUNK_SIZE)
+	{
+		return TILEMAP_EMPTY_TILE;
+	}
+
+	return Layer->Tiles[GetTilemapTileIndex(Layer, Column, Row)];
+}
+
+bool IsTilemapEmpty(const STilemap* Tilemap)
+{
+	for (int RenderLayer = 0; RenderLayer < TILEMAP_MAXNUM_LAYERS; ++RenderLayer)
+	{
+		const std::vector<uint16_t>& NumChunkTiles = Tilemap->Layers[RenderLayer].NumChunkTiles;
+		for (int i = 0; i < NumChunkTiles.size(); ++i)
+		{
+			if (NumChunkTiles[i] > 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+size_t GetTilemapMemoryUsage(const STilemap* Tilemap)
+{
+	size_t MemoryUsage = 0;
+	for (int RenderLayer = 0; RenderLayer < TILEMAP_MAXNUM_LAYERS; ++RenderLayer)
+	{
+		MemoryUsage += Tilemap->Layers[RenderLayer].Tiles.capacity() * sizeof(uint16_t);
+		MemoryUsage += Tilemap->Layers[RenderLayer].NumChunkTiles.capacity() * sizeof(uint16_t);
+	}
+
+	return MemoryUsage;
+}
+
+// Column/row of a world coordinate clamped to [-1, NumTiles] (world coordinates can be far outside of the grid)
+static int ClampTileCoordinate(float Coordinate, int NumTiles)
+{
+	if (Coordinate < -1)
+	{
+		return -1;
+	}
+	if (Coordinate > NumTiles)
+	{
+		return NumTiles;
+	}
+
+	return (int)Coordinate;
+}
+
+bool IsTilemapRectBlocked(const STilemap* Tilemap, int RenderLayer,
+	const std::vector<STileType>& TileTypes, SVector Location, SVector Size,
+	const std::vector<int>* TileIDsToIgnore, float* OutTopY)
+{
+	if (RenderLayer < 0 || RenderLayer >= TILEMAP_MAXNUM_LAYERS)
+	{
+		return false;
+	}
+
+	const STilemapLayer* Layer = &Tilemap->Layers[RenderLayer];
+	if (Layer->TileSize <= 0 ||
+		Layer->Tiles.empty())
+	{
+		return false;
+	}
+
+	// Cells overlapped by the rect, a rect touching the edge of a cell does not overlap it (same as "IsCollisionDetected")
+	int NumColumns = Layer->NumChunksX * TILEMAP_CHUNK_SIZE;
+	int NumRows = Layer->NumChunksY * TILEMAP_CHUNK_SIZE;
+	int FirstColumn = std::max(0, ClampTileCoordinate(std::floor(Location.X / Layer->TileSize), NumColumns));
+	int LastColumn = std::min(NumColumns - 1,
+		ClampTileCoordinate(std::ceil((Location.X + Size.X) / Layer->TileSize) - 1, NumColumns));
+	int FirstRow = std::max(0, ClampTileCoordinate(std::floor(Location.Y / Layer->TileSize), NumRows));
+	int LastRow = std::min(NumRows - 1,
+		ClampTileCoordinate(std::ceil((Location.Y + Size.Y) / Layer->TileSize) - 1, NumRows));
+
+	// Rows are tested top to bottom, so the first solid tile found is the highest one
+	for (int Row = FirstRow; Row <= LastRow; ++Row)
+	{
+		for (int Column = FirstColumn; Column <= LastColumn; ++Column)
+		{
+			int TileID = Layer->Tiles[GetTilemapTileIndex(Layer, Column, Row)];
+			if (TileID == TILEMAP_EMPTY_TILE ||
+				TileID >= TileTypes.size() ||
+				!TileTypes[TileID].Solid)
+			{
+				continue;
+			}
+
+			if (TileIDsToIgnore &&
+				std::find(TileIDsToIgnore->begin(), TileIDsToIgnore->end(), TileID) != TileIDsToIgnore->end())
+			{
+				continue;
+			}
+
+			if (OutTopY)
+			{
+				*OutTopY = Row * Layer->TileSize;
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WriteTilemap(std::ostream& File, const STilemap* Tilemap)
+{
+	for (int RenderLayer = 0; RenderLayer < TILEMAP_MAXNUM_LAYERS; ++RenderLayer)
+	{
+		const STilemapLayer* Layer = &Tilemap->Layers[RenderLayer];
+		if (Layer->TileSize <= 0)
+		{
+			continue;
+		}
+
+		int NumColumns = Layer->NumChunksX * TILEMAP_CHUNK_SIZE;
+		int NumRows = Layer->NumChunksY * TILEMAP_CHUNK_SIZE;
+		for (int Row = 0; Row < NumRows; ++Row)
+		{
+			// Trailing empty tiles are not written, rows without tiles are not written at all
+			int RowEnd = NumColumns;
+			while (RowEnd > 0 &&
+				(Layer->NumChunkTiles[(Row / TILEMAP_CHUNK_SIZE) * Layer->NumChunksX + (RowEnd - 1) / TILEMAP_CHUNK_SIZE] == 0 ||
+				Layer->Tiles[GetTilemapTileIndex(Layer, RowEnd - 1, Row)] == TILEMAP_EMPTY_TILE))
+			{
+				RowEnd--;
+			}
+			if (RowEnd == 0)
+			{
+				continue;
+			}
+
+			File << TILEMAP_ROW_PREFIX << RenderLayer << " " << Layer->TileSize << " " << Row;
+			int Column = 0;
+			while (Column < RowEnd)
+			{
+				int TileID = Layer->Tiles[GetTilemapTileIndex(Layer, Column, Row)];
+				int RunEnd = Column + 1;
+				while (RunEnd < RowEnd &&
+					Layer->Tiles[GetTilemapTileIndex(Layer, RunEnd, Row)] == TileID)
+				{
+					RunEnd++;
+				}
+
+				File << " " << RunEnd - Column << " " << TileID;
+				Column = RunEnd;
+			}
+			File << '\n';
+		}
+	}
+}
+
+bool ParseTilemapLine(const char* Line, STilemap* Tilemap)
+{
+	if (std::strncmp(Line, TILEMAP_ROW_PREFIX, sizeof(TILEMAP_ROW_PREFIX) - 1) != 0)
+	{
+		return false;
+	}
+
+	Line += sizeof(TILEMAP_ROW_PREFIX) - 1;
+	char* End = nullptr;
+	int RenderLayer = (int)std::strtol(Line, &End, 10);
+	if (End == Line)
+	{
+		return false;
+	}
+
+	Line = End;
+	float TileSize = std::strtof(Line, &End);
+	if (End == Line)
+	{
+		return false;
+	}
+
+	Line = End;
+	int Row = (int)std::strtol(Line, &End, 10);
+	if (End == Line)
+	{
+		return false;
+	}
+
+	int Column = 0;
+	while (Column < TILEMAP_MAXNUM_COLUMNS)
+	{
+		Line = End;
+		long NumTiles = std::strtol(Line, &End, 10);
+		if (End == Line ||
+			NumTiles <= 0)
+		{
+			break;
+		}
+
+		Line = End;
+		int TileID = (int)std::strtol(Line, &End, 10);
+		if (End == Line)
+		{
+			break;
+		}
+
+		int RunEnd = (int)std::min((long)TILEMAP_MAXNUM_COLUMNS, Column + NumTiles);
+		if (TileID != TILEMAP_EMPTY_TILE)
+		{
+			for (int i = Column; i < RunEnd; ++i)
+			{
+				SetTile(Tilemap, RenderLayer, TileSize, i, Row, TileID);
+			}
+		}
+		Column = RunEnd;
+	}
+
+	return true;
+}
+
+void UpdateTileTypes(VoodooEngine* Engine)
+{
+	int NumTileTypes = 0;
+	for (auto& Asset : Engine->StoredGameObjectIDs)
+	{
+		if (Asset.first > TILEMAP_EMPTY_TILE &&
+			Asset.first < TILEMAP_MAXNUM_TILE_TYPES)
+		{
+			NumTileTypes = std::max(NumTileTypes, Asset.first + 1);
+		}
+	}
+
+	Engine->TileTypes.assign(NumTileTypes, STileType());
+	for (auto& Asset : Engine->StoredGameObjectIDs)
+	{
+		if (Asset.first <= TILEMAP_EMPTY_TILE ||
+			Asset.first >= TILEMAP_MAXNUM_TILE_TYPES)
+		{
+			continue;
+		}
+
+		// Same texture atlas slot as the bitmap of a game object created from the asset
+		BitmapComponent AssetBitmap;
+		SetupBitmapComponent(&AssetBitmap,
+			Asset.second.TextureAtlasBitmap,
+			Asset.second.TextureAtlasWidthHeight,
+			Asset.second.TextureAtlasOffsetMultiplierHeight, false);
+
+		STileType& TileType = Engine->TileTypes[Asset.first];
+		TileType.Texture = Asset.second.TextureAtlasBitmap;
+		TileType.Size = Asset.second.TextureAtlasWidthHeight;
+		TileType.SourceLeft = AssetBitmap.BitmapParams.BitmapOffsetLeft;
+		TileType.SourceRight = AssetBitmap.BitmapParams.BitmapSource;
+		TileType.Solid = Asset.second.CreateDefaultAssetCollision;
+		TileType.Valid = true;
+	}
+}
+
+TilemapGameObject* CreateTilemapGameObject(VoodooEngine* Engine, STilemap* Tiles, std::vector<GameObject*>* Level)
+{
+	UpdateTileTypes(Engine);
+
+	// Not created by "CreateGameObject", a tilemap has no asset and no bitmap/collision stored in the engine
+	TilemapGameObject* CreatedTilemap = new TilemapGameObject;
+	CreatedTilemap->GetColdData()->GameObjectClassSize = sizeof(TilemapGameObject);
+	if (Tiles)
+	{
+		CreatedTilemap->Tilemap = std::move(*Tiles);
+		*Tiles = STilemap();
+	}
+
+	Engine->StoredGameObjects.push_back(CreatedTilemap);
+	Engine->StoredTilemaps.push_back(CreatedTilemap);
+	AddMetricGauge(GetEngineMetrics()->ObjectsAlive, 1);
+	if (Level)
+	{
+		Level->push_back(CreatedTilemap);
+	}
+
+	CreatedTilemap->OnGameObjectCreated({ 0, 0 });
+	return CreatedTilemap;
+}
+
+TilemapGameObject* GetEditedTilemap(VoodooEngine* Engine, bool Create)
+{
+	// Only the edited level is loaded in the level editor
+	if (!Engine->StoredTilemaps.empty())
+	{
+		return Engine->StoredTilemaps.front();
+	}
+
+	if (!Create)
+	{
+		return nullptr;
+	}
+
+	return CreateTilemapGameObject(Engine, nullptr);
+}
+
+bool PaintTile(VoodooEngine* Engine, int TileAssetID, SVector Location, bool Erase)
+{
+	auto Iterator = Engine->StoredGameObjectIDs.find(TileAssetID);
+	if (Iterator == Engine->StoredGameObjectIDs.end() ||
+		TileAssetID <= TILEMAP_EMPTY_TILE ||
+		TileAssetID >= TILEMAP_MAXNUM_TILE_TYPES)
+	{
+		return false;
+	}
+
+	int RenderLayer = Iterator->second.RenderLayer;
+	if (RenderLayer < 0 ||
+		RenderLayer >= TILEMAP_MAXNUM_LAYERS ||
+		Location.X < 0 ||
+		Location.Y < 0)
+	{
+		return false;
+	}
+
+	TilemapGameObject* EditedTilemap = GetEditedTilemap(Engine, !Erase);
+	if (!EditedTilemap)
+	{
+		return false;
+	}
+
+	// Asset added after the tile types were built
+	if (TileAssetID >= Engine->TileTypes.size())
+	{
+		UpdateTileTypes(Engine);
+	}
+
+	// First tile painted into a layer sets the tile size of the layer
+	STilemap* Tilemap = &EditedTilemap->Tilemap;
+	float TileSize = Tilemap->Layers[RenderLayer].TileSize > 0 ?
+		Tilemap->Layers[RenderLayer].TileSize : Iterator->second.TextureAtlasWidthHeight.X;
+	if (TileSize <= 0 ||
+		Location.X / TileSize >= TILEMAP_MAXNUM_COLUMNS ||
+		Location.Y / TileSize >= TILEMAP_MAXNUM_ROWS)
+	{
+		return false;
+	}
+
+	int Column = (int)(Location.X / TileSize);
+	int Row = (int)(Location.Y / TileSize);
+	int PreviousTileID = GetTile(Tilemap, RenderLayer, Column, Row);
+	int TileID = Erase ? TILEMAP_EMPTY_TILE : TileAssetID;
+	if (!SetTile(Tilemap, RenderLayer, TileSize, Column, Row, TileID))
+	{
+		return false;
+	}
+
+	RecordTilePainted(&Engine->LevelEditJournal, RenderLayer, TileSize, Column, Row, PreviousTileID, TileID);
+	return true;
+}
+
+bool IsTilemapCollisionDetected(VoodooEngine* Engine, CollisionComponent* Sender, float* OutTopY)
+{
+	if (Engine->StoredTilemaps.empty() ||
+		Sender->NoCollision)
+	{
+		return false;
+	}
+
+	const SEnableMasks* EnableMasks = GetEnableMasks();
+	if (!IsEnableGroupEnabled(Sender->EnableGroup, EnableMasks))
+	{
+		return false;
+	}
+
+	bool CollisionDetected = false;
+	for (int i = 0; i < Engine->StoredTilemaps.size(); ++i)
+	{
+		TilemapGameObject* StoredTilemap = Engine->StoredTilemaps[i];
+		if (StoredTilemap->GameObjectBitmap.BitmapParams.BitmapSetToNotRender)
+		{
+			continue;
+		}
+
+		// Every layer is enabled/disabled with its render layer and with the level of the tilemap
+		SEnableGroup LayerEnableGroup = StoredTilemap->GameObjectBitmap.BitmapParams.EnableGroup;
+		for (int RenderLayer = 0; RenderLayer < TILEMAP_MAXNUM_LAYERS; ++RenderLayer)
+		{
+			LayerEnableGroup.RenderLayer = RenderLayer < ENABLEMASKS_MAXNUM_RENDER_LAYERS ? (int8_t)RenderLayer : -1;
+			if (!IsEnableGroupEnabled(LayerEnableGroup, EnableMasks))
+			{
+				continue;
+			}
+
+			float LayerTopY = 0;
+			if (!IsTilemapRectBlocked(&StoredTilemap->Tilemap, RenderLayer, Engine->TileTypes,
+				Sender->ComponentLocation, Sender->CollisionRect, &Sender->CollisionTagsToIgnore, &LayerTopY))
+			{
+				continue;
+			}
+
+			if (!OutTopY)
+			{
+				return true;
+			}
+
+			*OutTopY = CollisionDetected ? std::min(*OutTopY, LayerTopY) : LayerTopY;
+			CollisionDetected = true;
+		}
+	}
+
+	return CollisionDetected;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "Platform.h"
+#include "SVector.h"
+#include "DDefaultRenderLayers.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Tilemap
+//---------------------
+// Grid aligned static geometry (e.g. ground and walls made of thousands of tiles) stored as a dense grid of tile IDs
+// per render layer instead of one game object per tile, a tile costs 2 bytes instead of a game object with
+// its bitmap/collision components.
+// A tile ID is the game object ID of the asset the tile is painted with (its texture atlas slot is drawn,
+// tiles of an asset with default collision are solid), tile ID 0 is an empty cell.
+//
+// The grid starts at world location (0, 0), every layer has its own tile size (set by the first tile painted
+// into the layer) and grows to the right/down as tiles are painted.
+// Tiles are stored in chunks of "TILEMAP_CHUNK_SIZE" x "TILEMAP_CHUNK_SIZE" tiles (the tiles of a chunk are
+// contiguous), the renderer only walks the chunks on screen that have tiles, and collision is a lookup of the cells
+// under a collision rect instead of testing every tile.
+//
+// A tilemap is owned by a tilemap game object of its level (see "TilemapGameObject.h").
+// Level file format (one line per row with tiles, run length encoded from column 0, trailing empty tiles are left out):
+//   tiles <RenderLayer> <TileSize> <Row> <NumTiles> <TileID> <NumTiles> <TileID> ...
+//---------------------
+
+#define TILEMAP_EMPTY_TILE 0
+#define TILEMAP_CHUNK_SIZE 16
+#define TILEMAP_CHUNK_NUM_TILES (TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE)
+// One layer for every render layer (including the last render layer)
+#define TILEMAP_MAXNUM_LAYERS (RENDERLAYER_MAXNUM + 1)
+// Max number of columns/rows of a layer (tiles painted further away from the grid origin are ignored)
+#define TILEMAP_MAXNUM_COLUMNS 4096
+#define TILEMAP_MAXNUM_ROWS 4096
+// Tile IDs are stored as 16 bit, assets with a higher game object ID can't be painted as tiles
+#define TILEMAP_MAXNUM_TILE_TYPES 65536
+// Game object ID of tilemap game objects (never an asset ID)
+#define TILEMAP_GAMEOBJECT_ID -100
+
+class VoodooEngine;
+class GameObject;
+class CollisionComponent;
+class TilemapGameObject;
+
+// How a tile ID is drawn/collided, built from the stored assets (see "UpdateTileTypes")
+struct STileType
+{
+	PlatformTexture* Texture = nullptr;
+	SVector Size = { 0, 0 };
+	// Texture atlas source rect
+	SVector SourceLeft = { 0, 0 };
+	SVector SourceRight = { 0, 0 };
+	bool Solid = false;
+	bool Valid = false;
+};
+
+struct STilemapLayer
+{
+	// 0 if no tile has been painted into the layer
+	float TileSize = 0;
+	int NumChunksX = 0;
+	int NumChunksY = 0;
+	// Tile IDs chunk by chunk (row major chunks, row major tiles within a chunk)
+	std::vector<uint16_t> Tiles;
+	// Number of tiles that are not empty in every chunk (empty chunks are skipped)
+	std::vector<uint16_t> NumChunkTiles;
+};
+
+struct STilemap
+{
+	STilemapLayer Layers[TILEMAP_MAXNUM_LAYERS];
+};
+
+inline int GetTilemapTileIndex(const STilemapLayer* Layer, int Column, int Row)
+{
+	int ChunkIndex = (Row / TILEMAP_CHUNK_SIZE) * Layer->NumChunksX + Column / TILEMAP_CHUNK_SIZE;
+	return ChunkIndex * TILEMAP_CHUNK_NUM_TILES +
+		(Row % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE + Column % TILEMAP_CHUNK_SIZE;
+}
+
+// Set a tile (layer is grown to fit the tile, "TileSize" is only used if the layer has no tile size yet),
+// returns false if the tile did not change or is outside of the grid
+extern "C" VOODOOENGINE_API bool SetTile(
+	STilemap* Tilemap, int RenderLayer, float TileSize, int Column, int Row, int TileID);
+// Returns "TILEMAP_EMPTY_TILE" if outside of the layer
+extern "C" VOODOOENGINE_API int GetTile(const STilemap* Tilemap, int RenderLayer, int Column, int Row);
+extern "C" VOODOOENGINE_API bool IsTilemapEmpty(const STilemap* Tilemap);
+extern "C" VOODOOENGINE_API size_t GetTilemapMemoryUsage(const STilemap* Tilemap);
+
+// True if a solid tile of the layer overlaps the rect (tiles with an ID in "TileIDsToIgnore" are not solid),
+// "OutTopY" (optional) is set to the top of the highest solid tile overlapping the rect
+extern "C" VOODOOENGINE_API bool IsTilemapRectBlocked(const STilemap* Tilemap, int RenderLayer,
+	const std::vector<STileType>& TileTypes, SVector Location, SVector Size,
+	const std::vector<int>* TileIDsToIgnore = nullptr, float* OutTopY = nullptr);
+
+// Write the tile rows of every layer (level file format above)
+extern "C" VOODOOENGINE_API void WriteTilemap(std::ostream& File, const STilemap* Tilemap);
+// Read a level file line into the tilemap, returns false if the line is not a tile row
+extern "C" VOODOOENGINE_API bool ParseTilemapLine(const char* Line, STilemap* Tilemap);
+
+// Rebuild the tile types of the engine from the stored assets (called when a tilemap is created)
+extern "C" VOODOOENGINE_API void UpdateTileTypes(VoodooEngine* Engine);
+// Create a tilemap game object owning the tiles (moved out of "Tiles"), added to "Level" if set
+extern "C" VOODOOENGINE_API TilemapGameObject* CreateTilemapGameObject(
+	VoodooEngine* Engine, STilemap* Tiles, std::vector<GameObject*>* Level = nullptr);
+// Tilemap of the level opened in the level editor (created if none and "Create" is set), nullptr if none
+extern "C" VOODOOENGINE_API TilemapGameObject* GetEditedTilemap(VoodooEngine* Engine, bool Create);
+// Paint a tile of an asset at a world location into the edited tilemap (into the render layer of the asset)
+// or erase the tile of that render layer, the change is recorded for undo/redo and saving (see "LevelEditJournal.h"),
+// returns false if nothing changed
+extern "C" VOODOOENGINE_API bool PaintTile(VoodooEngine* Engine, int TileAssetID, SVector Location, bool Erase = false);
+// True if the collision rect of "Sender" overlaps a solid tile of any enabled tilemap,
+// "OutTopY" (optional) is set to the top of the highest overlapped solid tile
+extern "C" VOODOOENGINE_API bool IsTilemapCollisionDetected(
+	VoodooEngine* Engine, CollisionComponent* Sender, float* OutTopY = nullptr);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "VoodooEngine.h"
+
+// Tilemap game object
+//---------------------
+// Owns the tilemap of a level (see "Tilemap.h"), created when a level with tiles is loaded
+// or when the first tile of a level is painted in the level editor.
+// It is part of its level like any other game object (level list, level slot, enabled/disabled with the level),
+// its bitmap has no texture and is never stored in the engine, the bitmap render state/enable group
+// is the state of the whole tilemap. It is not saved as a game object, its tiles are saved as tile rows of the level file
+//---------------------
+class TilemapGameObject : public GameObject
+{
+public:
+	TilemapGameObject()
+	{
+		GameObjectID = TILEMAP_GAMEOBJECT_ID;
+	}
+
+	STilemap Tilemap;
+
+	void OnGameObjectDeleted()
+	{
+		VoodooEngine::Engine->RemoveComponent(this, &VoodooEngine::Engine->StoredTilemaps);
+	}
+};
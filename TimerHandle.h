@@ -1,35 +1,67 @@
 #pragma once
 
-#include "UpdateComponent.h"
 #include "VoodooEngine.h"
 
-// Timer that counts down and sends a function pointer callback when finished
-class TimerHandle : public UpdateComponent
+// Timer that counts down and sends a function pointer callback when finished,
+// scheduled in the engine timer service (see "TimerService.h") so it costs nothing until it expires
+class TimerHandle
 {
 public:
+	// Time the timer was last set to (use "GetRemainingTime" to get the time left)
 	float TimerValue = 1;
 	bool TimerCompleted = false;
-	void(*OnTimerEndFunctionPointer)(void);
+	void(*OnTimerEndFunctionPointer)(void) = nullptr;
+	// Optional callback with a user context, sent after "OnTimerEndFunctionPointer"
+	TimerCallback OnTimerEndCallback = nullptr;
+	void* OnTimerEndContext = nullptr;
+	STimerID TimerID;
 
-	void SetTimer(float NewTime)
+	~TimerHandle()
 	{
-		VoodooEngine::Engine->StoredTimerUpdateComponents.push_back(this);
+		ClearTimer();
+	}
+
+	// Start (or restart) the timer, if "Repeating" is true the callback is sent every "NewTime" seconds
+	void SetTimer(float NewTime, bool Repeating = false)
+	{
+		ClearTimer();
 		TimerCompleted = false;
 		TimerValue = NewTime;
+		TimerID = ScheduleTimer(
+			&VoodooEngine::Engine->TimerService, NewTime, &TimerHandle::OnTimerEnd, this, Repeating);
 	};
 
-	void Update(float DeltaTime)
+	// Stop the timer without sending the callback
+	void ClearTimer()
+	{
+		if (VoodooEngine::Engine)
+		{
+			CancelTimer(&VoodooEngine::Engine->TimerService, TimerID);
+		}
+		TimerID = STimerID();
+	}
+
+	float GetRemainingTime()
 	{
-		TimerValue -= 0.025;
-		if (TimerValue <= 0)
+		return GetTimerRemainingTime(&VoodooEngine::Engine->TimerService, TimerID);
+	}
+
+private:
+	static void OnTimerEnd(void* Context)
+	{
+		TimerHandle* Timer = (TimerHandle*)Context;
+		Timer->TimerCompleted = true;
+
+		// Copied first since the timer can be deleted by the function pointer callback
+		TimerCallback Callback = Timer->OnTimerEndCallback;
+		void* CallbackContext = Timer->OnTimerEndContext;
+		if (Timer->OnTimerEndFunctionPointer)
+		{
+			Timer->OnTimerEndFunctionPointer();
+		}
+		if (Callback)
 		{
-			if (!TimerCompleted)
-			{
-				TimerCompleted = true;
-				OnTimerEndFunctionPointer();
-				VoodooEngine::Engine->RemoveComponent(
-					(UpdateComponent*)this, &VoodooEngine::Engine->StoredTimerUpdateComponents);
-			}
+			Callback(CallbackContext);
 		}
 	};
 };
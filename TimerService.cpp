@@ -0,0 +1,280 @@
+#include "TimerService.h"
+#include "Metrics.h"
+#include <cmath>
+
+static void LinkTimer(STimerService* TimerService, uint32_t TimerIndex, uint32_t List)
+{
+	STimer& Timer = TimerService->Timers[TimerIndex];
+	Timer.List = List;
+	Timer.Previous = TIMERSERVICE_INVALID_INDEX;
+	Timer.Next = TimerService->ListHeads[List];
+	if (Timer.Next != TIMERSERVICE_INVALID_INDEX)
+	{
+		TimerService->Timers[Timer.Next].Previous = TimerIndex;
+	}
+	TimerService->ListHeads[List] = TimerIndex;
+}
+
+static void UnlinkTimer(STimerService* TimerService, uint32_t TimerIndex)
+{
+	STimer& Timer = TimerService->Timers[TimerIndex];
+	if (Timer.Previous != TIMERSERVICE_INVALID_INDEX)
+	{
+		TimerService->Timers[Timer.Previous].Next = Timer.Next;
+	}
+	else
+	{
+		TimerService->ListHeads[Timer.List] = Timer.Next;
+	}
+	if (Timer.Next != TIMERSERVICE_INVALID_INDEX)
+	{
+		TimerService->Timers[Timer.Next].Previous = Timer.Previous;
+	}
+	Timer.Previous = TIMERSERVICE_INVALID_INDEX;
+	Timer.Next = TIMERSERVICE_INVALID_INDEX;
+	Timer.List = TIMERSERVICE_INVALID_INDEX;
+}
+
+// Store a timer in the wheel slot of its expire tick,
+// the level is the lowest level that covers the number of ticks left until the timer expires
+static void InsertTimer(STimerService* TimerService, uint32_t TimerIndex)
+{
+	uint64_t ExpireTick = TimerService->Timers[TimerIndex].ExpireTick;
+	uint64_t TicksLeft = 0;
+	if (ExpireTick > TimerService->CurrentTick)
+	{
+		TicksLeft = ExpireTick - TimerService->CurrentTick;
+	}
+
+	for (int Level = 0; Level < TIMERSERVICE_NUMLEVELS; ++Level)
+	{
+		uint64_t LevelRange = 1ull << (TIMERSERVICE_SLOT_BITS * (Level + 1));
+		if (TicksLeft < LevelRange || Level == TIMERSERVICE_NUMLEVELS - 1)
+		{
+			// Delays longer than the whole wheel are stored in the last slot the top level can reach,
+			// they are inserted again (with the remaining delay) when that slot is cascaded
+			uint64_t SlotTick = ExpireTick;
+			if (TicksLeft >= LevelRange)
+			{
+				SlotTick = TimerService->CurrentTick + LevelRange - 1;
+			}
+			uint32_t Slot = (uint32_t)(SlotTick >> (TIMERSERVICE_SLOT_BITS * Level)) & (TIMERSERVICE_NUMSLOTS - 1);
+			LinkTimer(TimerService, TimerIndex, Level * TIMERSERVICE_NUMSLOTS + Slot);
+			return;
+		}
+	}
+}
+
+static void FreeTimer(STimerService* TimerService, uint32_t TimerIndex)
+{
+	STimer& Timer = TimerService->Timers[TimerIndex];
+	Timer.Generation++;
+	Timer.Callback = nullptr;
+	Timer.Context = nullptr;
+	TimerService->FreeTimers.push_back(TimerIndex);
+	TimerService->NumActiveTimers--;
+	AddMetricGauge(GetEngineMetrics()->TimersActive, -1);
+}
+
+static STimer* GetActiveTimer(STimerService* TimerService, STimerID TimerID)
+{
+	if (TimerID.Index >= TimerService->Timers.size())
+	{
+		return nullptr;
+	}
+
+	STimer* Timer = &TimerService->Timers[TimerID.Index];
+	if (Timer->Generation != TimerID.Generation ||
+		Timer->List == TIMERSERVICE_INVALID_INDEX)
+	{
+		return nullptr;
+	}
+
+	return Timer;
+}
+
+// Move all timers of the current slot of a level down to the lower levels
+static void CascadeTimers(STimerService* TimerService, int Level)
+{
+	uint32_t Slot = (uint32_t)(TimerService->CurrentTick >> (TIMERSERVICE_SLOT_BITS * Level)) & (TIMERSERVICE_NUMSLOTS - 1);
+	uint32_t List = Level * TIMERSERVICE_NUMSLOTS + Slot;
+	while (TimerService->ListHeads[List] != TIMERSERVICE_INVALID_INDEX)
+	{
+		uint32_t TimerIndex = TimerService->ListHeads[List];
+		UnlinkTimer(TimerService, TimerIndex);
+		InsertTimer(TimerService, TimerIndex);
+	}
+}
+
+static void AdvanceTimerTick(STimerService* TimerService)
+{
+	TimerService->CurrentTick++;
+
+	// When a lower level wraps around, the current slot of the level above is cascaded down
+	// (highest level first, so timers cascaded from above are cascaded again in the same tick if needed)
+	int HighestCascadeLevel = 0;
+	for (int Level = 1; Level < TIMERSERVICE_NUMLEVELS; ++Level)
+	{
+		uint64_t LowerLevelMask = (1ull << (TIMERSERVICE_SLOT_BITS * Level)) - 1;
+		if ((TimerService->CurrentTick & LowerLevelMask) != 0)
+		{
+			break;
+		}
+		HighestCascadeLevel = Level;
+	}
+	for (int Level = HighestCascadeLevel; Level > 0; --Level)
+	{
+		CascadeTimers(TimerService, Level);
+	}
+
+	// Move all timers of the current level 0 slot to the expired list before sending any callback,
+	// so callbacks can schedule and cancel timers (including timers in the expired list)
+	uint32_t Slot = (uint32_t)TimerService->CurrentTick & (TIMERSERVICE_NUMSLOTS - 1);
+	while (TimerService->ListHeads[Slot] != TIMERSERVICE_INVALID_INDEX)
+	{
+		uint32_t TimerIndex = TimerService->ListHeads[Slot];
+		UnlinkTimer(TimerService, TimerIndex);
+		LinkTimer(TimerService, TimerIndex, TIMERSERVICE_EXPIRED_LIST);
+	}
+
+	while (TimerService->ListHeads[TIMERSERVICE_EXPIRED_LIST] != TIMERSERVICE_INVALID_INDEX)
+	{
+		uint32_t TimerIndex = TimerService->ListHeads[TIMERSERVICE_EXPIRED_LIST];
+		UnlinkTimer(TimerService, TimerIndex);
+
+		// Copy before sending the callback, "Timers" can grow if the callback schedules a new timer
+		STimer& Timer = TimerService->Timers[TimerIndex];
+		TimerCallback Callback = Timer.Callback;
+		void* Context = Timer.Context;
+
+		if (Timer.IntervalTicks > 0)
+		{
+			Timer.ExpireTick += Timer.IntervalTicks;
+			InsertTimer(TimerService, TimerIndex);
+		}
+		else
+		{
+			FreeTimer(TimerService, TimerIndex);
+		}
+
+		if (Callback)
+		{
+			Callback(Context);
+		}
+	}
+}
+
+STimerID ScheduleTimer(
+	STimerService* TimerService, float Delay, TimerCallback Callback, void* Context, bool Repeating)
+{
+	uint32_t TimerIndex = 0;
+	if (!TimerService->FreeTimers.empty())
+	{
+		TimerIndex = TimerService->FreeTimers.back();
+		TimerService->FreeTimers.pop_back();
+	}
+	else
+	{
+		TimerIndex = (uint32_t)TimerService->Timers.size();
+		TimerService->Timers.emplace_back();
+	}
+
+	// Delay is rounded up to a whole tick (at least one tick, so a timer never expires in the same frame)
+	double DelayTicks = std::ceil((double)Delay * TIMERSERVICE_TICKS_PER_SECOND - 0.001);
+	uint64_t NumTicks = 1;
+	if (DelayTicks > 1)
+	{
+		NumTicks = (uint64_t)DelayTicks;
+	}
+
+	STimer& Timer = TimerService->Timers[TimerIndex];
+	Timer.ExpireTick = TimerService->CurrentTick + NumTicks;
+	Timer.IntervalTicks = Repeating ? NumTicks : 0;
+	Timer.Callback = Callback;
+	Timer.Context = Context;
+	InsertTimer(TimerService, TimerIndex);
+
+	TimerService->NumActiveTimers++;
+	AddMetricGauge(GetEngineMetrics()->TimersActive, 1);
+
+	STimerID TimerID;
+	TimerID.Index = TimerIndex;
+	TimerID.Generation = Timer.Generation;
+	return TimerID;
+}
+
+bool CancelTimer(STimerService* TimerService, STimerID TimerID)
+{
+	if (!GetActiveTimer(TimerService, TimerID))
+	{
+		return false;
+	}
+
+	UnlinkTimer(TimerService, TimerID.Index);
+	FreeTimer(TimerService, TimerID.Index);
+	return true;
+}
+
+bool IsTimerActive(STimerService* TimerService, STimerID TimerID)
+{
+	return GetActiveTimer(TimerService, TimerID) != nullptr;
+}
+
+float GetTimerRemainingTime(STimerService* TimerService, STimerID TimerID)
+{
+	STimer* Timer = GetActiveTimer(TimerService, TimerID);
+	if (!Timer || Timer->ExpireTick <= TimerService->CurrentTick)
+	{
+		return 0;
+	}
+
+	float RemainingTime =
+		(float)(Timer->ExpireTick - TimerService->CurrentTick) / TIMERSERVICE_TICKS_PER_SECOND - TimerService->TickTimeRemainder;
+	if (RemainingTime < 0)
+	{
+		return 0;
+	}
+
+	return RemainingTime;
+}
+
+void ClearAllTimers(STimerService* TimerService)
+{
+	for (int i = 0; i <= TIMERSERVICE_EXPIRED_LIST; ++i)
+	{
+		while (TimerService->ListHeads[i] != TIMERSERVICE_INVALID_INDEX)
+		{
+			uint32_t TimerIndex = TimerService->ListHeads[i];
+			UnlinkTimer(TimerService, TimerIndex);
+			FreeTimer(TimerService, TimerIndex);
+		}
+	}
+}
+
+void UpdateTimerService(STimerService* TimerService, float DeltaTime)
+{
+	if (DeltaTime <= 0)
+	{
+		return;
+	}
+
+	TimerService->TickTimeRemainder += DeltaTime;
+	uint64_t NumTicks = (uint64_t)((double)TimerService->TickTimeRemainder * TIMERSERVICE_TICKS_PER_SECOND);
+	TimerService->TickTimeRemainder -= (float)((double)NumTicks / TIMERSERVICE_TICKS_PER_SECOND);
+	if (TimerService->TickTimeRemainder < 0)
+	{
+		TimerService->TickTimeRemainder = 0;
+	}
+
+	// Nothing is scheduled so there is nothing to cascade or send
+	if (TimerService->NumActiveTimers == 0)
+	{
+		TimerService->CurrentTick += NumTicks;
+		return;
+	}
+
+	for (uint64_t i = 0; i < NumTicks; ++i)
+	{
+		AdvanceTimerTick(TimerService);
+	}
+}
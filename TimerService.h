@@ -0,0 +1,91 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include <cstdint>
+#include <vector>
+
+// Timer service
+//---------------------
+// All engine timers are stored in a hierarchical timing wheel, so scheduling and cancelling a timer is O(1)
+// and pending timers cost nothing per frame, only the timers that expire (and the occasional cascade of
+// a higher wheel level into the level below) are touched.
+//
+// Time is advanced by the frame delta time in ticks of 1 / "TIMERSERVICE_TICKS_PER_SECOND" seconds,
+// a timer expires on the first tick at or after its delay (delay is rounded up to a whole tick).
+// Wheel level 0 has a slot per tick, every level above covers "TIMERSERVICE_NUMSLOTS" slots of the level below
+// (4 levels of 256 slots at 1 ms per tick is ~49 days, longer delays are clamped)
+//---------------------
+
+#define TIMERSERVICE_TICKS_PER_SECOND 1000
+#define TIMERSERVICE_SLOT_BITS 8
+#define TIMERSERVICE_NUMSLOTS (1 << TIMERSERVICE_SLOT_BITS)
+#define TIMERSERVICE_NUMLEVELS 4
+#define TIMERSERVICE_INVALID_INDEX 0xFFFFFFFF
+
+// Callback sent when a timer expires, "Context" is the user pointer passed when the timer was scheduled
+typedef void(*TimerCallback)(void* Context);
+
+// Handle to a scheduled timer, stays safe to use after the timer has expired or been cancelled
+// (the generation no longer matches, so the handle is simply no longer active)
+struct STimerID
+{
+	uint32_t Index = TIMERSERVICE_INVALID_INDEX;
+	uint32_t Generation = 0;
+};
+
+struct STimer
+{
+	uint64_t ExpireTick = 0;
+	// Number of ticks between each callback of a repeating timer (0 if not repeating)
+	uint64_t IntervalTicks = 0;
+	TimerCallback Callback = nullptr;
+	void* Context = nullptr;
+	uint32_t Generation = 1;
+	// Timers in the same wheel slot are stored in an intrusive double linked list (index into "Timers")
+	uint32_t Previous = TIMERSERVICE_INVALID_INDEX;
+	uint32_t Next = TIMERSERVICE_INVALID_INDEX;
+	// Wheel slot list the timer is stored in (see "TIMERSERVICE_EXPIRED_LIST"),
+	// or "TIMERSERVICE_INVALID_INDEX" if the timer is not scheduled
+	uint32_t List = TIMERSERVICE_INVALID_INDEX;
+};
+
+// Extra list after all wheel slots, used to store the timers that expired on the current tick
+// (so a callback can safely cancel any other timer that expires on the same tick)
+#define TIMERSERVICE_EXPIRED_LIST (TIMERSERVICE_NUMLEVELS * TIMERSERVICE_NUMSLOTS)
+
+struct STimerService
+{
+	// All timers ever created, unused timers are reused through "FreeTimers"
+	std::vector<STimer> Timers;
+	std::vector<uint32_t> FreeTimers;
+	// First timer of every wheel slot list (level * "TIMERSERVICE_NUMSLOTS" + slot), last list is the expired list
+	uint32_t ListHeads[TIMERSERVICE_EXPIRED_LIST + 1];
+	uint64_t CurrentTick = 0;
+	// Delta time not yet advanced since it is less than a tick
+	float TickTimeRemainder = 0;
+	int NumActiveTimers = 0;
+
+	STimerService()
+	{
+		for (int i = 0; i <= TIMERSERVICE_EXPIRED_LIST; ++i)
+		{
+			ListHeads[i] = TIMERSERVICE_INVALID_INDEX;
+		}
+	}
+};
+
+// Schedule a timer that sends "Callback" after "Delay" seconds,
+// if "Repeating" is true the timer is sent every "Delay" seconds until cancelled
+extern "C" VOODOOENGINE_API STimerID ScheduleTimer(
+	STimerService* TimerService, float Delay, TimerCallback Callback, void* Context, bool Repeating = false);
+// Cancel a timer before it expires, returns false if the timer has already expired or been cancelled
+extern "C" VOODOOENGINE_API bool CancelTimer(STimerService* TimerService, STimerID TimerID);
+extern "C" VOODOOENGINE_API bool IsTimerActive(STimerService* TimerService, STimerID TimerID);
+// Get the time left in seconds until a timer expires, returns 0 if the timer is not active
+extern "C" VOODOOENGINE_API float GetTimerRemainingTime(STimerService* TimerService, STimerID TimerID);
+// Cancel all timers (e.g. when a level is unloaded)
+extern "C" VOODOOENGINE_API void ClearAllTimers(STimerService* TimerService);
+
+// Called by the engine every frame while the game is running,
+// advances the wheel by the delta time and sends the callbacks of all expired timers
+extern "C" VOODOOENGINE_API void UpdateTimerService(STimerService* TimerService, float DeltaTime);
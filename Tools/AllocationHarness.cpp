@@ -0,0 +1,422 @@
+// Allocation harness
+//---------------------
+// Runs the engine headless on a sample level and counts every heap allocation made per frame,
+// so code that allocates while a level is running (e.g. copying vectors or creating resources every frame)
+// is found before it ships. Allocations are caught through the engine allocation counting
+// (global operator new is replaced, see "FrameAllocator.h") and grouped by call site (callstack).
+//
+// The first frames are warmup frames (containers growing to their steady size, frame arena growing etc.),
+// every frame after that is expected to make no heap allocation at all,
+// the harness returns a non zero exit code if one does (used as a CTest test).
+//
+// Linux only (callstacks are taken with "backtrace"), built when "VOODOOENGINE_BUILD_ALLOCATION_HARNESS" is set:
+//   cmake -S . -B Build -DVOODOOENGINE_BUILD_ALLOCATION_HARNESS=ON
+//   cmake --build Build && ctest --test-dir Build
+//   Build/AllocationHarness [NumFrames] [NumWarmupFrames]
+//---------------------
+
+#include "VoodooEngine.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <execinfo.h>
+
+#define HARNESS_DEFAULT_NUM_FRAMES 600
+#define HARNESS_DEFAULT_NUM_WARMUP_FRAMES 60
+// Max number of different call sites recorded (allocations from any other call site are only counted)
+#define HARNESS_MAXNUM_CALLSITES 256
+#define HARNESS_MAXNUM_CALLSTACK_FRAMES 16
+// Number of callstack frames printed per call site
+#define HARNESS_NUM_PRINTED_CALLSTACK_FRAMES 8
+
+// Sample level
+#define HARNESS_NUM_GROUND_TILES 64
+#define HARNESS_NUM_PROPS 256
+#define HARNESS_NUM_CHARACTERS 64
+#define HARNESS_NUM_TRIGGERS 8
+#define HARNESS_NUM_JUMPS_PER_SCREENPRINT_CLEAR 24
+
+enum EHarnessAssetID
+{
+	HarnessAsset_Ground = 1,
+	HarnessAsset_Prop = 2,
+	HarnessAsset_Character = 3,
+	HarnessAsset_Trigger = 4
+};
+
+struct SAllocationCallSite
+{
+	void* Callstack[HARNESS_MAXNUM_CALLSTACK_FRAMES];
+	int NumCallstackFrames = 0;
+	uint64_t Hash = 0;
+	int64_t NumAllocations = 0;
+	int64_t NumBytes = 0;
+	// Frame the call site first allocated in
+	int FirstFrame = -1;
+};
+
+struct SAllocationHarness
+{
+	// Call sites are only recorded while a measured frame is running
+	std::atomic<bool> Recording = { false };
+	// The hook can be called from any thread (e.g. job system workers)
+	std::atomic_flag Lock = ATOMIC_FLAG_INIT;
+	int CurrentFrame = 0;
+	SAllocationCallSite CallSites[HARNESS_MAXNUM_CALLSITES];
+	int NumCallSites = 0;
+	int64_t NumUnrecordedAllocations = 0;
+};
+static SAllocationHarness Harness;
+
+static uint64_t HashCallstack(void** Callstack, int NumFrames)
+{
+	uint64_t Hash = 1469598103934665603ull;
+	for (int i = 0; i < NumFrames; ++i)
+	{
+		Hash = (Hash ^ (uint64_t)Callstack[i]) * 1099511628211ull;
+	}
+
+	return Hash;
+}
+
+// Called for every heap allocation, must not allocate itself
+// (allocations made in here are not sent to the hook again, but would still be counted)
+static void OnHeapAllocation(size_t Size)
+{
+	if (!Harness.Recording.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	void* Callstack[HARNESS_MAXNUM_CALLSTACK_FRAMES];
+	int NumFrames = backtrace(Callstack, HARNESS_MAXNUM_CALLSTACK_FRAMES);
+	uint64_t Hash = HashCallstack(Callstack, NumFrames);
+
+	while (Harness.Lock.test_and_set(std::memory_order_acquire))
+	{
+	}
+
+	SAllocationCallSite* CallSite = nullptr;
+	for (int i = 0; i < Harness.NumCallSites; ++i)
+	{
+		if (Harness.CallSites[i].Hash == Hash)
+		{
+			CallSite = &Harness.CallSites[i];
+			break;
+		}
+	}
+
+	if (!CallSite &&
+		Harness.NumCallSites < HARNESS_MAXNUM_CALLSITES)
+	{
+		CallSite = &Harness.CallSites[Harness.NumCallSites++];
+		memcpy(CallSite->Callstack, Callstack, NumFrames * sizeof(void*));
+		CallSite->NumCallstackFrames = NumFrames;
+		CallSite->Hash = Hash;
+		CallSite->FirstFrame = Harness.CurrentFrame;
+	}
+
+	if (CallSite)
+	{
+		CallSite->NumAllocations++;
+		CallSite->NumBytes += Size;
+	}
+	else
+	{
+		Harness.NumUnrecordedAllocations++;
+	}
+
+	Harness.Lock.clear(std::memory_order_release);
+}
+
+// Symbol of a callstack frame is formatted as "module(mangled+offset) [address]"
+static bool IsOperatorNewFrame(const char* Symbol)
+{
+	return strstr(Symbol, "(_Znwm") || strstr(Symbol, "(_Znam");
+}
+
+static void PrintCallstackFrame(const char* Symbol)
+{
+	const char* NameBegin = strchr(Symbol, '(');
+	const char* NameEnd = NameBegin ? strchr(NameBegin, '+') : nullptr;
+	if (!NameBegin || !NameEnd || NameEnd == NameBegin + 1)
+	{
+		printf("        %s\n", Symbol);
+		return;
+	}
+
+	char MangledName[512];
+	size_t NameLength = NameEnd - NameBegin - 1;
+	if (NameLength >= sizeof(MangledName))
+	{
+		NameLength = sizeof(MangledName) - 1;
+	}
+	memcpy(MangledName, NameBegin + 1, NameLength);
+	MangledName[NameLength] = '\0';
+
+	int Status = 0;
+	char* DemangledName = abi::__cxa_demangle(MangledName, nullptr, nullptr, &Status);
+	printf("        %s\n", Status == 0 ? DemangledName : MangledName);
+	free(DemangledName);
+}
+
+static void PrintCallSite(SAllocationCallSite* CallSite)
+{
+	printf("  %lld allocations (%lld bytes), first in frame %d\n",
+		(long long)CallSite->NumAllocations, (long long)CallSite->NumBytes, CallSite->FirstFrame);
+
+	char** Symbols = backtrace_symbols(CallSite->Callstack, CallSite->NumCallstackFrames);
+	if (!Symbols)
+	{
+		return;
+	}
+
+	// Frames of the allocation itself (hook, allocation counting, operator new) are not printed
+	int FirstFrame = 0;
+	for (int i = 0; i < CallSite->NumCallstackFrames; ++i)
+	{
+		if (IsOperatorNewFrame(Symbols[i]))
+		{
+			FirstFrame = i + 1;
+			break;
+		}
+	}
+
+	for (int i = FirstFrame;
+		i < CallSite->NumCallstackFrames && i < FirstFrame + HARNESS_NUM_PRINTED_CALLSTACK_FRAMES; ++i)
+	{
+		PrintCallstackFrame(Symbols[i]);
+	}
+
+	free(Symbols);
+}
+
+// Sample level
+//---------------------
+// Walks back and forth on the ground, jumps when the jump timer expires
+class HarnessCharacter : public Character
+{
+public:
+	void Update(float DeltaTime)
+	{
+		if (Location.X < 0 ||
+			Location.X > HARNESS_NUM_GROUND_TILES * 64)
+		{
+			MoveComp.MovementDirection.X = Location.X < 0 ? 1.f : -1.f;
+		}
+
+		AddMovementInput(VoodooEngine::Engine, this);
+	}
+};
+
+// Static props with bitmap and blocking collision stored in the entity storage
+class HarnessProp : public GameObject
+{
+public:
+	HarnessProp()
+	{
+		StoreAsEntity = true;
+	}
+};
+
+class HarnessTrigger : public Trigger
+{
+public:
+	int NumOverlaps = 0;
+
+	void OnBeginOverlap(int SenderCollisionTag, int TargetCollisionTag, Object* Target = nullptr)
+	{
+		NumOverlaps++;
+	}
+};
+
+struct SHarnessLevel
+{
+	std::vector<HarnessCharacter*> Characters;
+	int NextCharacterToJump = 0;
+};
+static SHarnessLevel HarnessLevel;
+
+static void OnJumpTimer(void* Context)
+{
+	SHarnessLevel* Level = (SHarnessLevel*)Context;
+	if (Level->Characters.empty())
+	{
+		return;
+	}
+
+	Level->Characters[Level->NextCharacterToJump]->MoveComp.Jump();
+	Level->NextCharacterToJump = (Level->NextCharacterToJump + 1) % Level->Characters.size();
+
+	// Debug text letters are taken from the letter pool (set up without a font bitmap in headless mode),
+	// the pool runs out before the text is cleared, so printing with no letters left is tested as well
+	ScreenPrint(VoodooEngine::Engine, "character_jumped_from_the_ground");
+	if (Level->NextCharacterToJump % HARNESS_NUM_JUMPS_PER_SCREENPRINT_CLEAR == 0)
+	{
+		VoodooEngine::ClearScreenPrint(VoodooEngine::Engine);
+	}
+}
+
+static void AddHarnessAsset(VoodooEngine* Engine, int AssetID, SVector Size, int RenderLayer, bool CreateCollision)
+{
+	SAssetParameters Asset;
+	Asset.TextureAtlasWidthHeight = Size;
+	Asset.RenderLayer = RenderLayer;
+	Asset.CreateDefaultAssetCollision = CreateCollision;
+	Engine->StoredGameObjectIDs[AssetID] = Asset;
+}
+
+static void CreateHarnessLevel(VoodooEngine* Engine)
+{
+	AddHarnessAsset(Engine, HarnessAsset_Ground, { 64, 32 }, 1, true);
+	AddHarnessAsset(Engine, HarnessAsset_Prop, { 32, 32 }, 2, true);
+	AddHarnessAsset(Engine, HarnessAsset_Character, { 16, 16 }, 3, false);
+	AddHarnessAsset(Engine, HarnessAsset_Trigger, { 128, 128 }, 4, true);
+
+	for (int i = 0; i < HARNESS_NUM_GROUND_TILES; ++i)
+	{
+		Engine->CreateGameObject((GameObject*)nullptr, HarnessAsset_Ground, { (float)i * 64, 600 });
+	}
+
+	// Props are stacked on top of the ground at both ends (blocks characters walking off the ground)
+	for (int i = 0; i < HARNESS_NUM_PROPS; ++i)
+	{
+		float LocationX = (i % 2 == 0) ? -32.f : HARNESS_NUM_GROUND_TILES * 64.f;
+		Engine->CreateGameObject((HarnessProp*)nullptr, HarnessAsset_Prop, { LocationX, 568.f - (i / 2) * 32 });
+	}
+
+	SQuadCollisionParameters QuadCollision;
+	QuadCollision.RectSizeCollisionLeft = { 2, 12 };
+	QuadCollision.RectSizeCollisionRight = { 2, 12 };
+	QuadCollision.RectSizeCollisionUp = { 12, 2 };
+	QuadCollision.RectSizeCollisionDown = { 12, 2 };
+	QuadCollision.RelativeOffsetCollisionRight = { 14, 2 };
+	QuadCollision.RelativeOffsetCollisionUp = { 2, -2 };
+	QuadCollision.RelativeOffsetCollisionDown = { 2, 16 };
+
+	std::vector<CollisionComponent*> CharacterCollisions;
+	for (int i = 0; i < HARNESS_NUM_CHARACTERS; ++i)
+	{
+		HarnessCharacter* NewCharacter = Engine->CreateGameObject(
+			(HarnessCharacter*)nullptr, HarnessAsset_Character, { 32.f + i * 60, 500.f - (i % 4) * 20 });
+		NewCharacter->CreateDefaultGameObjectCollision()->CollisionRect = { 16, 16 };
+		NewCharacter->MoveComp.InitMovementComponent(NewCharacter, QuadCollision, 80.f + i % 40, true);
+		NewCharacter->MoveComp.MovementDirection.X = (i % 2 == 0) ? 1.f : -1.f;
+		HarnessLevel.Characters.push_back(NewCharacter);
+		CharacterCollisions.push_back(NewCharacter->DefaultGameObjectCollision);
+	}
+
+	for (int i = 0; i < HARNESS_NUM_TRIGGERS; ++i)
+	{
+		HarnessTrigger* NewTrigger = Engine->CreateGameObject(
+			(HarnessTrigger*)nullptr, HarnessAsset_Trigger, { (float)i * 512, 480 });
+		NewTrigger->SetTriggerParameters(HarnessAsset_Trigger, { 128, 128 });
+		NewTrigger->CollisionTargets = CharacterCollisions;
+	}
+
+	// Every character plays a walk animation
+	AddAnimationClipFromSpriteSheetRow(&Engine->SpriteAnimators, 1, AnimationPlayback_PingPong, 16, 16, 0, 4, 0.1f);
+	for (int i = 0; i < HarnessLevel.Characters.size(); ++i)
+	{
+		SAnimatorHandle Animator = CreateSpriteAnimator(
+			&Engine->SpriteAnimators, &HarnessLevel.Characters[i]->GameObjectBitmap.BitmapParams);
+		PlaySpriteAnimation(&Engine->SpriteAnimators, Animator, 1);
+	}
+
+	ScheduleTimer(&Engine->TimerService, 0.25f, OnJumpTimer, &HarnessLevel, true);
+}
+//---------------------
+
+int main(int argc, char** argv)
+{
+	int NumFrames = argc > 1 ? atoi(argv[1]) : HARNESS_DEFAULT_NUM_FRAMES;
+	int NumWarmupFrames = argc > 2 ? atoi(argv[2]) : HARNESS_DEFAULT_NUM_WARMUP_FRAMES;
+	if (NumFrames <= NumWarmupFrames)
+	{
+		printf("Number of frames (%d) must be more than the number of warmup frames (%d)\n",
+			NumFrames, NumWarmupFrames);
+		return 2;
+	}
+
+	static VoodooEngine Engine;
+	VoodooEngine::Engine = &Engine;
+	InitEngineHeadless(&Engine, SRenderLayerNames());
+	CreateHarnessLevel(&Engine);
+	Engine.StartGame();
+
+	// Character collision is not stored in the engine (only used as overlap target of the triggers)
+	for (int i = 0; i < HarnessLevel.Characters.size(); ++i)
+	{
+		HarnessLevel.Characters[i]->DefaultGameObjectCollision->NoCollision = false;
+	}
+
+	if (GetNumHeapAllocations() == 0)
+	{
+		printf("Allocation counting is not enabled (build with \"VOODOOENGINE_COUNT_ALLOCATIONS\")\n");
+		return 2;
+	}
+
+	// Per frame results are allocated up front so storing them never allocates during a frame
+	std::vector<int64_t> FrameAllocations(NumFrames, 0);
+	SetHeapAllocationHook(OnHeapAllocation);
+
+	for (int Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Harness.CurrentFrame = Frame;
+		Harness.Recording = Frame >= NumWarmupFrames;
+
+		int64_t NumAllocationsAtFrameStart = GetNumHeapAllocations();
+		RunEngine(&Engine);
+		FrameAllocations[Frame] = GetNumHeapAllocations() - NumAllocationsAtFrameStart;
+	}
+
+	Harness.Recording = false;
+	SetHeapAllocationHook(nullptr);
+
+	int64_t NumWarmupAllocations = 0;
+	int64_t NumSteadyAllocations = 0;
+	int NumAllocatingFrames = 0;
+	for (int Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		if (Frame < NumWarmupFrames)
+		{
+			NumWarmupAllocations += FrameAllocations[Frame];
+			continue;
+		}
+
+		NumSteadyAllocations += FrameAllocations[Frame];
+		if (FrameAllocations[Frame] > 0)
+		{
+			NumAllocatingFrames++;
+		}
+	}
+
+	printf("Allocation harness: %d game objects, %d entities, %d frames (%d warmup)\n",
+		(int)Engine.StoredGameObjects.size(), Engine.EntityStorage.NumEntities, NumFrames, NumWarmupFrames);
+	printf("Warmup frames: %lld allocations\n", (long long)NumWarmupAllocations);
+	printf("Steady state frames: %lld allocations in %d of %d frames (%.2f per frame)\n",
+		(long long)NumSteadyAllocations, NumAllocatingFrames, NumFrames - NumWarmupFrames,
+		(double)NumSteadyAllocations / (NumFrames - NumWarmupFrames));
+
+	if (NumSteadyAllocations == 0)
+	{
+		printf("PASSED\n");
+		return 0;
+	}
+
+	printf("Allocations by call site:\n");
+	for (int i = 0; i < Harness.NumCallSites; ++i)
+	{
+		PrintCallSite(&Harness.CallSites[i]);
+	}
+	if (Harness.NumUnrecordedAllocations > 0)
+	{
+		printf("  %lld allocations from call sites not recorded (more than %d call sites)\n",
+			(long long)Harness.NumUnrecordedAllocations, HARNESS_MAXNUM_CALLSITES);
+	}
+
+	printf("FAILED\n");
+	return 1;
+}
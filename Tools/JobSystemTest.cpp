@@ -0,0 +1,263 @@
+// Job system test
+//---------------------
+// Runs the job system with 0, 1, 3 and 7 worker threads and checks that:
+// - "ParallelFor" gives the same batches and results for every number of worker threads
+// - jobs depending on a counter only run once every job of that counter is done (a chain of dependent stages)
+// - every frame counter is done at "EndJobSystemFrame" (and frame counters are handed out again after it)
+// - a job pushed to a full queue ("JOBSYSTEM_QUEUE_CAPACITY" jobs queued) is run directly by the pushing thread
+//
+// Returns a non zero exit code if a check fails (used as a CTest test).
+// Also meant to be run with the thread sanitizer (e.g. -DCMAKE_CXX_FLAGS=-fsanitize=thread).
+//
+// Built when "VOODOOENGINE_BUILD_JOBSYSTEM_TEST" is set:
+//   cmake -S . -B Build -DVOODOOENGINE_BUILD_JOBSYSTEM_TEST=ON
+//   cmake --build Build && ctest --test-dir Build
+//---------------------
+
+#include "JobSystem.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#define TEST_NUM_DEPENDENT_STAGES 8
+#define TEST_NUM_ITEMS_PER_STAGE 1000
+// Jobs pushed to a full queue (all run directly)
+#define TEST_NUM_JOBS_OVER_CAPACITY 16
+
+static const int TestNumWorkerThreads[] = { 0, 1, 3, 7 };
+
+struct SParallelForRange
+{
+	int Count = 0;
+	int MinBatchSize = 0;
+};
+
+static const SParallelForRange TestRanges[] =
+{
+	{ 1, 1 },
+	{ 63, 1 },
+	{ 64, 16 },
+	{ 1000, 16 },
+	{ 100000, 256 }
+};
+
+// Result of every index of a "ParallelFor", written by the job running the index
+struct SParallelForResult
+{
+	std::vector<uint64_t> Values;
+	// Begin of the batch that ran the index
+	std::vector<int> BatchBegins;
+};
+
+struct SDependentStages
+{
+	std::atomic<int> NumItemsDone[TEST_NUM_DEPENDENT_STAGES];
+	// Items run before every item of the previous stage was done
+	std::atomic<int> NumItemsRunTooEarly = { 0 };
+	int CurrentStage = 0;
+};
+
+struct SStageContext
+{
+	SDependentStages* Stages = nullptr;
+	int Stage = 0;
+};
+
+struct SFullQueueTest
+{
+	std::atomic<int> NumBlockedWorkers = { 0 };
+	std::atomic<bool> ReleaseWorkers = { false };
+	std::atomic<int> NumJobsRun = { 0 };
+	std::atomic<int> NumJobsRunWhilePushing = { 0 };
+	std::atomic<bool> Pushing = { false };
+};
+
+static int NumFailedChecks = 0;
+
+static void Check(bool Condition, const char* Description, int NumWorkerThreads)
+{
+	if (!Condition)
+	{
+		printf("%d worker threads: %s\n", NumWorkerThreads, Description);
+		NumFailedChecks++;
+	}
+}
+
+static uint64_t HashIndex(int Index)
+{
+	uint64_t Hash = (uint64_t)Index * 0x9E3779B97F4A7C15ull;
+	Hash ^= Hash >> 31;
+	return Hash * 0xBF58476D1CE4E5B9ull;
+}
+
+static void ComputeParallelForBatch(void* Context, int Begin, int End)
+{
+	SParallelForResult* Result = (SParallelForResult*)Context;
+	for (int i = Begin; i < End; ++i)
+	{
+		Result->Values[i] = HashIndex(i);
+		Result->BatchBegins[i] = Begin;
+	}
+}
+
+static void RunStageBatch(void* Context, int Begin, int End)
+{
+	SStageContext* StageContext = (SStageContext*)Context;
+	SDependentStages* Stages = StageContext->Stages;
+	for (int i = Begin; i < End; ++i)
+	{
+		if (StageContext->Stage > 0 &&
+			Stages->NumItemsDone[StageContext->Stage - 1].load() != TEST_NUM_ITEMS_PER_STAGE)
+		{
+			Stages->NumItemsRunTooEarly.fetch_add(1);
+		}
+		Stages->NumItemsDone[StageContext->Stage].fetch_add(1);
+	}
+}
+
+static void BlockWorker(void* Context, int Begin, int End)
+{
+	SFullQueueTest* Test = (SFullQueueTest*)Context;
+	Test->NumBlockedWorkers.fetch_add(1);
+	while (!Test->ReleaseWorkers.load())
+	{
+		std::this_thread::yield();
+	}
+}
+
+static void CountFullQueueJob(void* Context, int Begin, int End)
+{
+	SFullQueueTest* Test = (SFullQueueTest*)Context;
+	Test->NumJobsRun.fetch_add(1);
+	if (Test->Pushing.load())
+	{
+		Test->NumJobsRunWhilePushing.fetch_add(1);
+	}
+}
+
+static void TestParallelFor(int NumWorkerThreads, std::vector<SParallelForResult>& ReferenceResults)
+{
+	for (int RangeIndex = 0; RangeIndex < sizeof(TestRanges) / sizeof(TestRanges[0]); ++RangeIndex)
+	{
+		const SParallelForRange& Range = TestRanges[RangeIndex];
+		SParallelForResult Result;
+		Result.Values.resize(Range.Count, 0);
+		Result.BatchBegins.resize(Range.Count, -1);
+		ParallelFor(Range.Count, Range.MinBatchSize, ComputeParallelForBatch, &Result);
+
+		// First run (no worker threads) is the reference every other number of worker threads is compared to
+		if (ReferenceResults.size() <= RangeIndex)
+		{
+			bool AllComputed = true;
+			for (int i = 0; i < Range.Count; ++i)
+			{
+				AllComputed &= Result.Values[i] == HashIndex(i);
+			}
+			Check(AllComputed, "ParallelFor did not compute every index", NumWorkerThreads);
+			ReferenceResults.push_back(Result);
+			continue;
+		}
+
+		Check(Result.Values == ReferenceResults[RangeIndex].Values,
+			"ParallelFor results differ from the results without worker threads", NumWorkerThreads);
+		Check(Result.BatchBegins == ReferenceResults[RangeIndex].BatchBegins,
+			"ParallelFor batches differ from the batches without worker threads", NumWorkerThreads);
+	}
+}
+
+static void TestDependentJobs(int NumWorkerThreads)
+{
+	SDependentStages Stages;
+	SStageContext StageContexts[TEST_NUM_DEPENDENT_STAGES];
+	SJobCounter* StageCounters[TEST_NUM_DEPENDENT_STAGES];
+
+	// Every stage depends on the stage before it, all stages are queued up front and only the last one is waited for
+	for (int Stage = 0; Stage < TEST_NUM_DEPENDENT_STAGES; ++Stage)
+	{
+		Stages.NumItemsDone[Stage] = 0;
+		StageContexts[Stage].Stages = &Stages;
+		StageContexts[Stage].Stage = Stage;
+		StageCounters[Stage] = AllocateFrameJobCounter();
+		ParallelForAsync(TEST_NUM_ITEMS_PER_STAGE, 16, RunStageBatch, &StageContexts[Stage],
+			StageCounters[Stage], Stage > 0 ? StageCounters[Stage - 1] : nullptr);
+	}
+	WaitForJobCounter(StageCounters[TEST_NUM_DEPENDENT_STAGES - 1]);
+
+	Check(Stages.NumItemsRunTooEarly.load() == 0,
+		"a dependent job ran before the jobs it depends on were done", NumWorkerThreads);
+	for (int Stage = 0; Stage < TEST_NUM_DEPENDENT_STAGES; ++Stage)
+	{
+		Check(Stages.NumItemsDone[Stage].load() == TEST_NUM_ITEMS_PER_STAGE,
+			"a dependent stage did not run every item", NumWorkerThreads);
+		Check(IsJobCounterDone(StageCounters[Stage]),
+			"a frame counter is not done at the end of the frame", NumWorkerThreads);
+	}
+
+	EndJobSystemFrame();
+	Check(AllocateFrameJobCounter() == StageCounters[0],
+		"frame counters are not handed out again after the end of the frame", NumWorkerThreads);
+	EndJobSystemFrame();
+}
+
+static void TestFullQueue(int NumWorkerThreads)
+{
+	SFullQueueTest Test;
+
+	// Every worker thread is kept busy so no queued job is taken while the queue is filled
+	SJobCounter BlockCounter;
+	for (int i = 0; i < NumWorkerThreads; ++i)
+	{
+		RunJob(BlockWorker, &Test, 0, 1, &BlockCounter);
+	}
+	while (Test.NumBlockedWorkers.load() < NumWorkerThreads)
+	{
+		std::this_thread::yield();
+	}
+
+	SJobCounter Counter;
+	Test.Pushing = true;
+	for (int i = 0; i < JOBSYSTEM_QUEUE_CAPACITY + TEST_NUM_JOBS_OVER_CAPACITY; ++i)
+	{
+		RunJob(CountFullQueueJob, &Test, 0, 1, &Counter);
+	}
+	Test.Pushing = false;
+
+	Check(Test.NumJobsRunWhilePushing.load() == TEST_NUM_JOBS_OVER_CAPACITY,
+		"jobs pushed to a full queue were not run directly", NumWorkerThreads);
+
+	Test.ReleaseWorkers = true;
+	WaitForJobCounter(&BlockCounter);
+	WaitForJobCounter(&Counter);
+
+	Check(Test.NumJobsRun.load() == JOBSYSTEM_QUEUE_CAPACITY + TEST_NUM_JOBS_OVER_CAPACITY,
+		"not every job of a full queue was run", NumWorkerThreads);
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<SParallelForResult> ReferenceResults;
+	for (int i = 0; i < sizeof(TestNumWorkerThreads) / sizeof(TestNumWorkerThreads[0]); ++i)
+	{
+		int NumWorkerThreads = TestNumWorkerThreads[i];
+		InitJobSystem(NumWorkerThreads);
+		Check(GetNumJobThreads() == NumWorkerThreads + 1, "wrong number of job threads", NumWorkerThreads);
+
+		TestParallelFor(NumWorkerThreads, ReferenceResults);
+		TestDependentJobs(NumWorkerThreads);
+		TestFullQueue(NumWorkerThreads);
+
+		ShutdownJobSystem();
+		printf("%d worker threads done\n", NumWorkerThreads);
+	}
+
+	if (NumFailedChecks > 0)
+	{
+		printf("FAILED (%d checks)\n", NumFailedChecks);
+		return 1;
+	}
+
+	printf("PASSED\n");
+	return 0;
+}
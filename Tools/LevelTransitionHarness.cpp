@@ -0,0 +1,251 @@
+// Level transition harness
+//---------------------
+// Runs the engine headless with a player walking through a row of levels (a load level trigger at the right edge
+// of every level activates the next one) and measures how long the frame stalls when a level is activated.
+// The run is done twice, first with every level loaded when its trigger is reached (level cache only holding
+// the active level), then with the next level preloaded in the background as the player walks towards the trigger
+// (see "LevelPreload.h"). Frames are paced to the fixed delta time (like the frame rate limit of a windowed game)
+// so the preload thread gets as much wall clock time to read a level as in a game.
+//
+// Returns a non zero exit code if a preloaded transition still had to load its level (used as a CTest test),
+// stall times are only printed (they depend on the machine).
+//
+// Built when "VOODOOENGINE_BUILD_LEVEL_TRANSITION_HARNESS" is set:
+//   cmake -S . -B Build -DVOODOOENGINE_BUILD_LEVEL_TRANSITION_HARNESS=ON
+//   cmake --build Build && ctest --test-dir Build
+//   Build/LevelTransitionHarness [NumTransitions] [NumGameObjectsPerLevel]
+//---------------------
+
+#include "VoodooEngine.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#define HARNESS_DEFAULT_NUM_TRANSITIONS 4
+#define HARNESS_DEFAULT_NUM_GAMEOBJECTS_PER_LEVEL 20000
+#define HARNESS_NUM_LEVELS 4
+// Pixels per second the player walks to the right
+#define HARNESS_PLAYER_SPEED 900.f
+#define HARNESS_PLAYER_START_LOCATION_X 100.f
+#define HARNESS_PLAYER_LOCATION_Y 500.f
+// Frames a transition may take before the run is stopped (player stuck)
+#define HARNESS_MAXNUM_FRAMES_PER_TRANSITION 1000
+
+enum EHarnessAssetID
+{
+	HarnessAsset_Tile = 1,
+	HarnessAsset_Player = 2
+};
+
+#define HARNESS_TAG_RIGHT_TRIGGER 10
+
+struct SHarnessRun
+{
+	bool PreloadNeighbourLevels = false;
+	std::vector<std::wstring> LevelFileNames;
+	int ActiveLevelIndex = 0;
+	GameObject* Player = nullptr;
+	LoadLevelTrigger* RightTrigger = nullptr;
+
+	int NumTransitions = 0;
+	// Transitions where the level was not in the level cache when its trigger was reached
+	int NumLoadedTransitions = 0;
+	double TotalStallMilliseconds = 0;
+	double MaxStallMilliseconds = 0;
+	double MaxFrameMilliseconds = 0;
+};
+static SHarnessRun* CurrentRun = nullptr;
+
+static double GetMillisecondsSince(int64_t StartTicks)
+{
+	return (double)(GetPlatformTicks() - StartTicks) * 1000.0 / GetPlatformTicksPerSecond();
+}
+
+static void LoadHarnessGameObject(int GameObjectID, SVector Location, std::vector<GameObject*>& Level)
+{
+	GameObject* CreatedObject = VoodooEngine::Engine->CreateGameObject((GameObject*)nullptr, GameObjectID, Location);
+	if (CreatedObject)
+	{
+		Level.push_back(CreatedObject);
+	}
+}
+
+static void SetNextNeighbourLevel(SHarnessRun* Run)
+{
+	int NextLevelIndex = (Run->ActiveLevelIndex + 1) % Run->LevelFileNames.size();
+	Run->RightTrigger->SetNeighbourLevel(
+		Run->PreloadNeighbourLevels ? Run->Player : nullptr, Run->LevelFileNames[NextLevelIndex].c_str());
+}
+
+static void OnHarnessLoadLevelTriggerOverlap(ELoadLevelTriggerType TriggerType)
+{
+	SHarnessRun* Run = CurrentRun;
+	if (TriggerType != LevelTriggerType_Right)
+	{
+		return;
+	}
+
+	int NextLevelIndex = (Run->ActiveLevelIndex + 1) % Run->LevelFileNames.size();
+	const wchar_t* NextLevelFileName = Run->LevelFileNames[NextLevelIndex].c_str();
+	SLevelManager* LevelManager = &VoodooEngine::Engine->LevelManager;
+	if (LevelManager->CachedLevels.find(NextLevelFileName) == LevelManager->CachedLevels.end())
+	{
+		Run->NumLoadedTransitions++;
+	}
+
+	int64_t StartTicks = GetPlatformTicks();
+	ActivateCachedLevel(VoodooEngine::Engine, NextLevelFileName, HarnessAsset_Player);
+	double StallMilliseconds = GetMillisecondsSince(StartTicks);
+
+	Run->NumTransitions++;
+	Run->TotalStallMilliseconds += StallMilliseconds;
+	Run->MaxStallMilliseconds = std::max(Run->MaxStallMilliseconds, StallMilliseconds);
+
+	Run->ActiveLevelIndex = NextLevelIndex;
+	SetNextNeighbourLevel(Run);
+	SetGameObjectLocation(Run->Player, { HARNESS_PLAYER_START_LOCATION_X, HARNESS_PLAYER_LOCATION_Y });
+}
+
+static void WriteHarnessLevels(SHarnessRun* Run, int NumGameObjectsPerLevel)
+{
+	std::filesystem::path LevelDirectory = std::filesystem::temp_directory_path();
+	for (int LevelIndex = 0; LevelIndex < HARNESS_NUM_LEVELS; ++LevelIndex)
+	{
+		std::filesystem::path LevelPath =
+			LevelDirectory / ("VoodooLevelTransitionHarness" + std::to_string(LevelIndex) + ".txt");
+		Run->LevelFileNames.push_back(LevelPath.wstring());
+
+		std::ofstream File;
+		OpenPlatformFile(File, Run->LevelFileNames.back().c_str(), std::ios_base::out | std::ios_base::trunc);
+		for (int i = 0; i < NumGameObjectsPerLevel; ++i)
+		{
+			// Grid of tiles covering the screen
+			File << HarnessAsset_Tile << " " << (i % 120) * 16 << " " << (i / 120 % 68) * 16 << " " << i + 1 << '\n';
+		}
+	}
+}
+
+static void RemoveHarnessLevels(SHarnessRun* Run)
+{
+	for (int i = 0; i < Run->LevelFileNames.size(); ++i)
+	{
+		std::error_code Error;
+		std::filesystem::remove(std::filesystem::path(Run->LevelFileNames[i]), Error);
+	}
+}
+
+static bool RunHarness(VoodooEngine* Engine, SHarnessRun* Run, int NumTransitions, size_t LevelCacheMemoryBudget)
+{
+	CurrentRun = Run;
+
+	Engine->DeleteAllGameObjects();
+	SetLevelCacheMemoryBudget(Engine, LevelCacheMemoryBudget);
+
+	Run->Player = Engine->CreateGameObject(
+		(GameObject*)nullptr, HarnessAsset_Player, { HARNESS_PLAYER_START_LOCATION_X, HARNESS_PLAYER_LOCATION_Y });
+
+	// Created after all game objects are deleted (deleting them also clears the stored collision components),
+	// removed from the engine before the next run deletes them again
+	LoadLevelTrigger RightTrigger(LevelTriggerType_Right, HARNESS_TAG_RIGHT_TRIGGER);
+	RightTrigger.OnLoadLevelTriggerOverlap = OnHarnessLoadLevelTriggerOverlap;
+	RightTrigger.CollisionTargets = { Run->Player->DefaultGameObjectCollision };
+	Run->RightTrigger = &RightTrigger;
+
+	Run->ActiveLevelIndex = 0;
+	if (!ActivateCachedLevel(Engine, Run->LevelFileNames[0].c_str(), HarnessAsset_Player))
+	{
+		printf("Level file could not be read\n");
+		return false;
+	}
+	SetNextNeighbourLevel(Run);
+
+	// First activation is not a transition
+	Run->NumTransitions = 0;
+	Run->NumLoadedTransitions = 0;
+
+	int MaxNumFrames = NumTransitions * HARNESS_MAXNUM_FRAMES_PER_TRANSITION;
+	for (int Frame = 0; Frame < MaxNumFrames && Run->NumTransitions < NumTransitions; ++Frame)
+	{
+		SVector PlayerLocation = Run->Player->Location;
+		PlayerLocation.X += HARNESS_PLAYER_SPEED * Engine->DeltaTime;
+		SetGameObjectLocation(Run->Player, PlayerLocation);
+
+		int64_t StartTicks = GetPlatformTicks();
+		RunEngine(Engine);
+		double FrameMilliseconds = GetMillisecondsSince(StartTicks);
+		Run->MaxFrameMilliseconds = std::max(Run->MaxFrameMilliseconds, FrameMilliseconds);
+
+		double FrameBudgetMilliseconds = Engine->DeltaTime * 1000.0;
+		if (FrameMilliseconds < FrameBudgetMilliseconds)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(FrameBudgetMilliseconds - FrameMilliseconds));
+		}
+	}
+
+	if (Run->NumTransitions < NumTransitions)
+	{
+		printf("Player did not reach the level trigger (%d of %d transitions)\n", Run->NumTransitions, NumTransitions);
+		return false;
+	}
+
+	printf("%s: %d transitions, %d loaded at the trigger, stall %.2f ms average %.2f ms max, frame %.2f ms max\n",
+		Run->PreloadNeighbourLevels ? "Preloaded" : "Loaded at trigger",
+		Run->NumTransitions, Run->NumLoadedTransitions,
+		Run->TotalStallMilliseconds / Run->NumTransitions, Run->MaxStallMilliseconds, Run->MaxFrameMilliseconds);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	int NumTransitions = argc > 1 ? atoi(argv[1]) : HARNESS_DEFAULT_NUM_TRANSITIONS;
+	int NumGameObjectsPerLevel = argc > 2 ? atoi(argv[2]) : HARNESS_DEFAULT_NUM_GAMEOBJECTS_PER_LEVEL;
+
+	static VoodooEngine Engine;
+	VoodooEngine::Engine = &Engine;
+	InitEngineHeadless(&Engine, SRenderLayerNames());
+	Engine.FunctionPointer_LoadGameObjects = LoadHarnessGameObject;
+
+	SAssetParameters TileAsset;
+	TileAsset.TextureAtlasWidthHeight = { 16, 16 };
+	TileAsset.CreateDefaultAssetCollision = true;
+	Engine.StoredGameObjectIDs[HarnessAsset_Tile] = TileAsset;
+	SAssetParameters PlayerAsset;
+	PlayerAsset.TextureAtlasWidthHeight = { 16, 16 };
+	PlayerAsset.CreateDefaultAssetCollision = true;
+	PlayerAsset.RenderLayer = 1;
+	Engine.StoredGameObjectIDs[HarnessAsset_Player] = PlayerAsset;
+
+	SHarnessRun LoadedRun;
+	SHarnessRun PreloadedRun;
+	PreloadedRun.PreloadNeighbourLevels = true;
+	WriteHarnessLevels(&LoadedRun, NumGameObjectsPerLevel);
+	PreloadedRun.LevelFileNames = LoadedRun.LevelFileNames;
+
+	Engine.StartGame();
+	printf("Level transition harness: %d game objects per level\n", NumGameObjectsPerLevel);
+
+	// Only the active level is cached, so every level is loaded when its trigger is reached
+	bool Succeeded = RunHarness(&Engine, &LoadedRun, NumTransitions, 0);
+	if (Succeeded)
+	{
+		// Room for the previous, the active and the preloaded level
+		// (game object lists of loaded levels can have more capacity than game objects)
+		size_t LevelMemoryUsage = (size_t)NumGameObjectsPerLevel * (LEVELMANAGER_ESTIMATED_GAMEOBJECT_SIZE + 2 * sizeof(GameObject*));
+		Succeeded = RunHarness(&Engine, &PreloadedRun, NumTransitions, 3 * LevelMemoryUsage);
+	}
+
+	Engine.DeleteAllGameObjects();
+	RemoveHarnessLevels(&LoadedRun);
+
+	if (!Succeeded ||
+		PreloadedRun.NumLoadedTransitions > 0)
+	{
+		printf("FAILED\n");
+		return 1;
+	}
+
+	printf("PASSED\n");
+	return 0;
+}
@@ -0,0 +1,249 @@
+#include "TransformComponent.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include <vector>
+
+// Used until the engine binds the dirty list it owns
+static STransformDirtyList DefaultDirtyTransforms;
+// All transforms marked as dirty since the last "UpdateTransforms"
+static STransformDirtyList* DirtyTransforms = &DefaultDirtyTransforms;
+
+static void AddDirtyTransform(TransformComponent* Transform)
+{
+	if (Transform->DirtyIndex >= 0)
+	{
+		return;
+	}
+
+	std::vector<TransformComponent*>& ThreadTransforms = DirtyTransforms->ThreadTransforms[GetJobThreadIndex()];
+	Transform->DirtyThreadIndex = GetJobThreadIndex();
+	Transform->DirtyIndex = (int)ThreadTransforms.size();
+	ThreadTransforms.push_back(Transform);
+}
+
+static void RemoveDirtyTransform(TransformComponent* Transform)
+{
+	if (Transform->DirtyIndex < 0)
+	{
+		return;
+	}
+
+	std::vector<TransformComponent*>& ThreadTransforms = DirtyTransforms->ThreadTransforms[Transform->DirtyThreadIndex];
+	TransformComponent* LastTransform = ThreadTransforms.back();
+	ThreadTransforms[Transform->DirtyIndex] = LastTransform;
+	LastTransform->DirtyIndex = Transform->DirtyIndex;
+	ThreadTransforms.pop_back();
+	Transform->DirtyIndex = -1;
+}
+
+static void UnlinkTransform(TransformComponent* Child)
+{
+	if (!Child->Parent)
+	{
+		return;
+	}
+
+	if (Child->PreviousSibling)
+	{
+		Child->PreviousSibling->NextSibling = Child->NextSibling;
+	}
+	else
+	{
+		Child->Parent->FirstChild = Child->NextSibling;
+	}
+	if (Child->NextSibling)
+	{
+		Child->NextSibling->PreviousSibling = Child->PreviousSibling;
+	}
+
+	Child->Parent = nullptr;
+	Child->PreviousSibling = nullptr;
+	Child->NextSibling = nullptr;
+}
+
+// Recompute the world location of a transform (parent must be up to date) and everything attached below it
+static int UpdateTransformTree(TransformComponent* Transform)
+{
+	if (Transform->Parent)
+	{
+		Transform->ComponentLocation =
+			{ Transform->Parent->ComponentLocation.X + Transform->LocalLocation.X,
+			Transform->Parent->ComponentLocation.Y + Transform->LocalLocation.Y };
+	}
+	else
+	{
+		Transform->ComponentLocation = Transform->LocalLocation;
+	}
+	RemoveDirtyTransform(Transform);
+
+	int NumTransformsUpdated = 1;
+	for (TransformComponent* Child = Transform->FirstChild; Child; Child = Child->NextSibling)
+	{
+		NumTransformsUpdated += UpdateTransformTree(Child);
+	}
+
+	return NumTransformsUpdated;
+}
+
+TransformComponent::~TransformComponent()
+{
+	// Attached transforms stay where they are
+	while (FirstChild)
+	{
+		DetachTransform(FirstChild);
+	}
+
+	RemoveDirtyTransform(this);
+	UnlinkTransform(this);
+}
+
+void AttachTransform(TransformComponent* Parent, TransformComponent* Child, SVector LocalLocation)
+{
+	if (!Parent || !Child || Parent == Child)
+	{
+		return;
+	}
+
+	UnlinkTransform(Child);
+	Child->Parent = Parent;
+	Child->NextSibling = Parent->FirstChild;
+	if (Parent->FirstChild)
+	{
+		Parent->FirstChild->PreviousSibling = Child;
+	}
+	Parent->FirstChild = Child;
+
+	Child->LocalLocation = LocalLocation;
+	SVector ParentLocation = GetTransformWorldLocation(Parent);
+	Child->ComponentLocation = { ParentLocation.X + LocalLocation.X, ParentLocation.Y + LocalLocation.Y };
+}
+
+void DetachTransform(TransformComponent* Child)
+{
+	if (!Child || !Child->Parent)
+	{
+		return;
+	}
+
+	SVector WorldLocation = GetTransformWorldLocation(Child);
+	UnlinkTransform(Child);
+	Child->LocalLocation = WorldLocation;
+	Child->ComponentLocation = WorldLocation;
+}
+
+void SetTransformLocation(TransformComponent* Transform, SVector NewLocation)
+{
+	if (!Transform)
+	{
+		return;
+	}
+
+	Transform->LocalLocation = NewLocation;
+	AddDirtyTransform(Transform);
+}
+
+SVector GetTransformWorldLocation(TransformComponent* Transform)
+{
+	// Up to date if neither the transform nor any parent is dirty
+	TransformComponent* TopDirtyTransform = nullptr;
+	for (TransformComponent* Current = Transform; Current; Current = Current->Parent)
+	{
+		if (Current->DirtyIndex >= 0)
+		{
+			TopDirtyTransform = Current;
+		}
+	}
+	if (!TopDirtyTransform)
+	{
+		return Transform->ComponentLocation;
+	}
+
+	// Everything above the top most dirty transform is up to date
+	SVector WorldLocation = {};
+	if (TopDirtyTransform->Parent)
+	{
+		WorldLocation = TopDirtyTransform->Parent->ComponentLocation;
+	}
+	for (TransformComponent* Current = Transform; Current != TopDirtyTransform->Parent; Current = Current->Parent)
+	{
+		WorldLocation.X += Current->LocalLocation.X;
+		WorldLocation.Y += Current->LocalLocation.Y;
+	}
+
+	return WorldLocation;
+}
+
+STransformDirtyList::~STransformDirtyList()
+{
+	for (int Thread = 0; Thread <= JOBSYSTEM_MAXNUM_WORKERS; ++Thread)
+	{
+		for (int i = 0; i < ThreadTransforms[Thread].size(); ++i)
+		{
+			ThreadTransforms[Thread][i]->DirtyIndex = -1;
+		}
+	}
+
+	if (DirtyTransforms == this)
+	{
+		DirtyTransforms = &DefaultDirtyTransforms;
+	}
+}
+
+static bool HasDirtyTransforms()
+{
+	for (int Thread = 0; Thread <= JOBSYSTEM_MAXNUM_WORKERS; ++Thread)
+	{
+		if (!DirtyTransforms->ThreadTransforms[Thread].empty())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UpdateTransforms()
+{
+	if (!HasDirtyTransforms())
+	{
+		return;
+	}
+
+	VOODOO_PROFILE_SCOPE("UpdateTransforms");
+
+	int NumTransformsUpdated = 0;
+	// Lists of all threads are merged here, a tree can have dirty transforms in several lists
+	// (updating a tree removes all of them from their lists)
+	for (int Thread = 0; Thread <= JOBSYSTEM_MAXNUM_WORKERS; ++Thread)
+	{
+		std::vector<TransformComponent*>& ThreadTransforms = DirtyTransforms->ThreadTransforms[Thread];
+		while (!ThreadTransforms.empty())
+		{
+			// Update from the top most dirty parent, so a tree is only updated once
+			// even if several transforms within it are dirty
+			TransformComponent* TopDirtyTransform = ThreadTransforms.back();
+			for (TransformComponent* Current = TopDirtyTransform->Parent; Current; Current = Current->Parent)
+			{
+				if (Current->DirtyIndex >= 0)
+				{
+					TopDirtyTransform = Current;
+				}
+			}
+
+			NumTransformsUpdated += UpdateTransformTree(TopDirtyTransform);
+		}
+	}
+
+	AddMetricCounter(GetEngineMetrics()->TransformsUpdated, NumTransformsUpdated);
+}
+
+void SetTransformDirtyList(STransformDirtyList* DirtyList)
+{
+	if (!DirtyList)
+	{
+		DirtyList = &DefaultDirtyTransforms;
+	}
+
+	UpdateTransforms();
+	DirtyTransforms = DirtyList;
+}
@@ -1,9 +1,91 @@
 #pragma once
 
+#include "VoodooEngineDLLExport.h"
 #include "SVector.h"
+#include "JobSystem.h"
+#include <vector>
+
+// Transform
+//---------------------
+// Transforms can be attached to a parent transform (e.g. the bitmap/collision of a game object,
+// or a weapon attached to a player), an attached transform stores its location relative to the parent
+// and its world location ("ComponentLocation") is recomputed when the parent moves.
+//
+// Setting a location only marks the transform as dirty, world locations of dirty transforms and all
+// transforms attached below them are recomputed once in "UpdateTransforms"
+// (called by the engine at the end of every update phase and before rendering),
+// so moving an object several times in a frame only updates its attached transforms once.
+// Dirty transforms are added to a list owned by the engine ("STransformDirtyList"), every job thread
+// has its own list so locations can be set from jobs (e.g. "ParallelFor"), the lists are merged when updated.
+//
+// NOTE: "ComponentLocation" of a moved transform and of everything attached below it is stale until the next
+// "UpdateTransforms" (e.g. the collision of a character moved earlier in the same update phase is still
+// at its previous location), use "GetTransformWorldLocation" to get the up to date location.
+// "ComponentLocation" of an attached transform is overwritten when its parent moves,
+// set the location through "SetTransformLocation" instead of writing it directly.
+// A transform must only be set from one thread at a time, and only be destroyed outside of jobs.
+//---------------------
 
 class TransformComponent
 {
 public:
+	// World location
 	SVector ComponentLocation;
+	// Location relative to the parent (same as world location if not attached)
+	SVector LocalLocation;
+
+	TransformComponent* Parent = nullptr;
+	TransformComponent* FirstChild = nullptr;
+	TransformComponent* PreviousSibling = nullptr;
+	TransformComponent* NextSibling = nullptr;
+	// Index in the dirty transform list of the thread that set the transform (-1 if not dirty)
+	int DirtyIndex = -1;
+	int DirtyThreadIndex = 0;
+
+	TransformComponent(){};
+
+	// Only the locations are copied, the copy is not attached to anything
+	TransformComponent(const TransformComponent& Other)
+	{
+		ComponentLocation = Other.ComponentLocation;
+		LocalLocation = Other.LocalLocation;
+	}
+	TransformComponent& operator=(const TransformComponent& Other)
+	{
+		ComponentLocation = Other.ComponentLocation;
+		LocalLocation = Other.LocalLocation;
+		return *this;
+	}
+
+	~TransformComponent();
+};
+
+struct STransformDirtyList
+{
+	// One list per thread that can set transforms (see "GetJobThreadIndex"),
+	// a thread only adds to its own list so no lock is needed
+	std::vector<TransformComponent*> ThreadTransforms[JOBSYSTEM_MAXNUM_WORKERS + 1];
+
+	// Transforms still in the lists are no longer dirty
+	~STransformDirtyList();
 };
+
+// Attach a transform to a parent (detached from any previous parent first),
+// the world location is updated directly from the parent world location
+extern "C" VOODOOENGINE_API void AttachTransform(
+	TransformComponent* Parent, TransformComponent* Child, SVector LocalLocation = {});
+// Detach a transform from its parent, the transform keeps its current world location
+extern "C" VOODOOENGINE_API void DetachTransform(TransformComponent* Child);
+
+// Set the location relative to the parent (or world location if not attached), marks the transform as dirty
+extern "C" VOODOOENGINE_API void SetTransformLocation(TransformComponent* Transform, SVector NewLocation);
+// Get the up to date world location, computed from the parents if the transform or any parent is dirty
+extern "C" VOODOOENGINE_API SVector GetTransformWorldLocation(TransformComponent* Transform);
+
+// Recompute the world location of all dirty transforms and the transforms attached below them
+// (only called outside of jobs)
+extern "C" VOODOOENGINE_API void UpdateTransforms();
+// Set the dirty list used by all transforms (called by the engine when initialized with the list it owns),
+// transforms dirty in the previous list are updated first.
+// Transforms set before any list is bound use a default list (e.g. tools that run without an engine)
+extern "C" VOODOOENGINE_API void SetTransformDirtyList(STransformDirtyList* DirtyList);
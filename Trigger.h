@@ -9,13 +9,13 @@ public:
 
 	void OnGameObjectCreated(SVector SpawnLocation)
 	{
-		VoodooEngine::Engine->StoredUpdateComponents.push_back(this);
+		// Updated after physics so overlaps are broadcast for the new locations of this frame
+		AddUpdateComponent(&VoodooEngine::Engine->UpdateScheduler, this, UpdatePhase_PostPhysics);
 		VoodooEngine::Engine->InterfaceObjects_GameState.push_back(this);
 	}
 	void OnGameObjectDeleted()
 	{
-		VoodooEngine::Engine->RemoveComponent(
-			(UpdateComponent*)this, &VoodooEngine::Engine->StoredUpdateComponents);
+		RemoveUpdateComponent(&VoodooEngine::Engine->UpdateScheduler, this);
 		VoodooEngine::Engine->RemoveComponent(
 			(IGameState*)this, &VoodooEngine::Engine->InterfaceObjects_GameState);
 	}
@@ -36,7 +36,7 @@ public:
 	{
 		for (int i = 0; i < CollisionTargets.size(); ++i)
 		{
-			BroadcastCollision(this, &DefaultGameObjectCollision, CollisionTargets[i]);
+			BroadcastCollision(this, DefaultGameObjectCollision, CollisionTargets[i]);
 		}
 	}
 
@@ -44,23 +44,22 @@ public:
 	// (by default the collision rect is the same size as the "GameObjectBitmap" for the trigger)
 	void SetTriggerParameters(int CollisionTag, SVector TriggerBoxSize)
 	{
-		DefaultGameObjectCollision.CollisionType = ECollisionType::Collision_Overlap;
-		DefaultGameObjectCollision.CollisionRect = TriggerBoxSize;
-		DefaultGameObjectCollision.CollisionRectColor = VoodooEngine::Engine->ColorYellow;
-		DefaultGameObjectCollision.CollisionTag = CollisionTag;
-		DefaultGameObjectCollision.Owner = this;
+		CollisionComponent* Collision = CreateDefaultGameObjectCollision();
+		Collision->CollisionType = ECollisionType::Collision_Overlap;
+		Collision->CollisionRect = TriggerBoxSize;
+		Collision->CollisionRectColor = VoodooEngine::Engine->ColorYellow;
+		Collision->CollisionTag = CollisionTag;
 
 		if (VoodooEngine::Engine->DebugMode)
 		{
-			DefaultGameObjectCollision.RenderCollisionRect = true;
+			Collision->RenderCollisionRect = true;
 		}
 	}
 
 	void SetTriggerLocation(SVector NewLocation)
 	{
-		Location = NewLocation;
-		GameObjectBitmap.ComponentLocation = NewLocation;
-		DefaultGameObjectCollision.ComponentLocation = NewLocation;
+		// Bitmap and collision are attached to the object transform
+		SetObjectLocation(this, NewLocation);
 	}
 
 	// These are called by the "BroadcastCollision" function
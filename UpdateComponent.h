@@ -1,9 +1,34 @@
 #pragma once
 
+#include "VoodooEngineDLLExport.h"
+
+class UpdateComponent;
+struct SUpdateScheduler;
+// Declared here to be friends of the update component (see "UpdateScheduler.h")
+extern "C" VOODOOENGINE_API void SetUpdateComponentPaused(
+	SUpdateScheduler* Scheduler, UpdateComponent* Component, bool SetPaused);
+extern "C" VOODOOENGINE_API void SetAllUpdateComponentsPaused(SUpdateScheduler* Scheduler, bool SetPaused);
+
 // Update component inherited by all objects that needs to update each frame
+// (added to the engine update scheduler, see "UpdateScheduler.h")
 class UpdateComponent
 {
 public:
-	bool Paused = false;
 	virtual void Update(float DeltaTime) = 0;
+
+	// Use "SetUpdateComponentPaused" to pause/unpause
+	// (the scheduler finds the component in the paused components or in its batch by the paused state)
+	bool IsPaused() const { return Paused; }
+
+	// Location in the update scheduler (-1 if not added),
+	// "UpdateSlot" is the index in the batch (or in the paused components if paused)
+	int UpdatePhase = -1;
+	int UpdateBatch = -1;
+	int UpdateSlot = -1;
+
+private:
+	bool Paused = false;
+
+	friend void SetUpdateComponentPaused(SUpdateScheduler* Scheduler, UpdateComponent* Component, bool SetPaused);
+	friend void SetAllUpdateComponentsPaused(SUpdateScheduler* Scheduler, bool SetPaused);
 };
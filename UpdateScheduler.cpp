@@ -0,0 +1,176 @@
+#include "UpdateScheduler.h"
+#include "Profiler.h"
+#include <cassert>
+
+// Remove by moving the last component into the removed slot (order within a batch is not kept)
+static void RemoveUpdateSlot(std::vector<UpdateComponent*>* Components, UpdateComponent* Component)
+{
+	int Slot = Component->UpdateSlot;
+	bool IsInSlot = Slot >= 0 && Slot < Components->size() && (*Components)[Slot] == Component;
+	// The component must be in the list its paused state says it is in,
+	// otherwise it would stay in the scheduler after being removed
+	assert(IsInSlot && "Update component is not in the slot it was added to");
+	if (!IsInSlot)
+	{
+		return;
+	}
+
+	UpdateComponent* LastComponent = Components->back();
+	(*Components)[Slot] = LastComponent;
+	LastComponent->UpdateSlot = Slot;
+	Components->pop_back();
+	Component->UpdateSlot = -1;
+}
+
+static void AddUpdateSlot(std::vector<UpdateComponent*>* Components, UpdateComponent* Component)
+{
+	Component->UpdateSlot = (int)Components->size();
+	Components->push_back(Component);
+}
+
+void AddUpdateComponentToBatch(
+	SUpdateScheduler* Scheduler,
+	UpdateComponent* Component,
+	EUpdatePhase Phase,
+	const std::type_info* Type,
+	UpdateBatchFunction UpdateFunction)
+{
+	// Already added
+	if (Component->UpdateBatch >= 0)
+	{
+		return;
+	}
+
+	std::vector<SUpdateBatch*>& Batches = Scheduler->Batches[Phase];
+	int BatchIndex = -1;
+	for (int i = 0; i < Batches.size(); ++i)
+	{
+		if (*Batches[i]->Type == *Type && 
+			Batches[i]->UpdateFunction == UpdateFunction)
+		{
+			BatchIndex = i;
+			break;
+		}
+	}
+
+	if (BatchIndex < 0)
+	{
+		SUpdateBatch* NewBatch = new SUpdateBatch;
+		NewBatch->Type = Type;
+		NewBatch->UpdateFunction = UpdateFunction;
+		Batches.push_back(NewBatch);
+		BatchIndex = (int)Batches.size() - 1;
+	}
+
+	Component->UpdatePhase = Phase;
+	Component->UpdateBatch = BatchIndex;
+	if (Component->IsPaused())
+	{
+		AddUpdateSlot(&Scheduler->PausedComponents, Component);
+	}
+	else
+	{
+		AddUpdateSlot(&Batches[BatchIndex]->Components, Component);
+	}
+}
+
+void RemoveUpdateComponent(SUpdateScheduler* Scheduler, UpdateComponent* Component)
+{
+	if (Component->UpdateBatch < 0)
+	{
+		return;
+	}
+
+	if (Component->IsPaused())
+	{
+		RemoveUpdateSlot(&Scheduler->PausedComponents, Component);
+	}
+	else
+	{
+		SUpdateBatch* Batch = Scheduler->Batches[Component->UpdatePhase][Component->UpdateBatch];
+		RemoveUpdateSlot(&Batch->Components, Component);
+	}
+
+	Component->UpdatePhase = -1;
+	Component->UpdateBatch = -1;
+}
+
+void SetUpdateComponentPaused(SUpdateScheduler* Scheduler, UpdateComponent* Component, bool SetPaused)
+{
+	if (Component->IsPaused() == SetPaused)
+	{
+		return;
+	}
+
+	// Not added to the scheduler, paused state is used when added
+	if (Component->UpdateBatch < 0)
+	{
+		Component->Paused = SetPaused;
+		return;
+	}
+
+	SUpdateBatch* Batch = Scheduler->Batches[Component->UpdatePhase][Component->UpdateBatch];
+	if (SetPaused)
+	{
+		RemoveUpdateSlot(&Batch->Components, Component);
+		AddUpdateSlot(&Scheduler->PausedComponents, Component);
+	}
+	else
+	{
+		RemoveUpdateSlot(&Scheduler->PausedComponents, Component);
+		AddUpdateSlot(&Batch->Components, Component);
+	}
+	Component->Paused = SetPaused;
+}
+
+void SetAllUpdateComponentsPaused(SUpdateScheduler* Scheduler, bool SetPaused)
+{
+	if (SetPaused)
+	{
+		for (int Phase = 0; Phase < UpdatePhase_Max; ++Phase)
+		{
+			for (int i = 0; i < Scheduler->Batches[Phase].size(); ++i)
+			{
+				std::vector<UpdateComponent*>& Components = Scheduler->Batches[Phase][i]->Components;
+				for (int j = 0; j < Components.size(); ++j)
+				{
+					Components[j]->Paused = true;
+					AddUpdateSlot(&Scheduler->PausedComponents, Components[j]);
+				}
+				Components.clear();
+			}
+		}
+	}
+	else
+	{
+		for (int i = 0; i < Scheduler->PausedComponents.size(); ++i)
+		{
+			UpdateComponent* Component = Scheduler->PausedComponents[i];
+			Component->Paused = false;
+			AddUpdateSlot(&Scheduler->Batches[Component->UpdatePhase][Component->UpdateBatch]->Components, Component);
+		}
+		Scheduler->PausedComponents.clear();
+	}
+}
+
+void UpdateSchedulerPhase(SUpdateScheduler* Scheduler, EUpdatePhase Phase, float DeltaTime)
+{
+	// Zone names must outlive the profiler ring buffer
+	static const char* PhaseZoneNames[UpdatePhase_Max] =
+	{
+		"UpdatePhase_PrePhysics",
+		"UpdatePhase_Physics",
+		"UpdatePhase_PostPhysics",
+		"UpdatePhase_Late"
+	};
+	VOODOO_PROFILE_SCOPE(PhaseZoneNames[Phase]);
+
+	std::vector<SUpdateBatch*>& Batches = Scheduler->Batches[Phase];
+	for (int i = 0; i < Batches.size(); ++i)
+	{
+		if (!Batches[i]->Components.empty())
+		{
+			Batches[i]->UpdateFunction(Batches[i]->Components, DeltaTime);
+		}
+	}
+}
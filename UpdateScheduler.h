@@ -0,0 +1,125 @@
+#pragma once
+
+#include "VoodooEngineDLLExport.h"
+#include "UpdateComponent.h"
+#include <typeinfo>
+#include <type_traits>
+#include <vector>
+
+// Update scheduler
+//---------------------
+// Update components are stored in batches by update phase and concrete type,
+// every batch is updated in a tight loop so the same update function runs back to back
+// (instead of bouncing between vtables of a mixed list of components).
+// If the type a component is added as is its concrete type, the batch calls "Update" directly (no virtual call).
+// Paused components are moved out of their batch so a batch never checks if a component is paused.
+//
+// NOTE: When adding a component from a constructor the concrete type is not known yet,
+// so add it as "(UpdateComponent*)this" (will still be batched, but "Update" is called as a virtual function)
+//---------------------
+
+// Phases are updated in this order every frame while the game is running
+enum EUpdatePhase
+{
+	UpdatePhase_PrePhysics = 0,
+	UpdatePhase_Physics = 1,
+	UpdatePhase_PostPhysics = 2,
+	UpdatePhase_Late = 3,
+	UpdatePhase_Max = 4
+};
+
+typedef void(*UpdateBatchFunction)(std::vector<UpdateComponent*>& Components, float DeltaTime);
+
+struct SUpdateBatch
+{
+	const std::type_info* Type = nullptr;
+	UpdateBatchFunction UpdateFunction = nullptr;
+	std::vector<UpdateComponent*> Components;
+};
+
+struct SUpdateScheduler
+{
+	// Batches are allocated separately so a batch stays valid if a new batch is added during update
+	std::vector<SUpdateBatch*> Batches[UpdatePhase_Max];
+	std::vector<UpdateComponent*> PausedComponents;
+
+	~SUpdateScheduler()
+	{
+		for (int Phase = 0; Phase < UpdatePhase_Max; ++Phase)
+		{
+			for (int i = 0; i < Batches[Phase].size(); ++i)
+			{
+				delete Batches[Phase][i];
+			}
+		}
+	}
+};
+
+// Update all components of a batch, the size is checked every iteration
+// since components can be added/removed during update (a component moved into a removed slot waits a frame)
+template<class T, bool IsAbstract = std::is_abstract<T>::value>
+struct SUpdateBatchDispatch
+{
+	static bool IsConcreteType(UpdateComponent* Component)
+	{
+		return typeid(*Component) == typeid(T);
+	}
+
+	static void Update(std::vector<UpdateComponent*>& Components, float DeltaTime)
+	{
+		for (int i = 0; i < Components.size(); ++i)
+		{
+			static_cast<T*>(Components[i])->T::Update(DeltaTime);
+		}
+	}
+};
+
+template<class T>
+struct SUpdateBatchDispatch<T, true>
+{
+	static bool IsConcreteType(UpdateComponent* Component)
+	{
+		return false;
+	}
+
+	static void Update(std::vector<UpdateComponent*>& Components, float DeltaTime)
+	{
+		for (int i = 0; i < Components.size(); ++i)
+		{
+			Components[i]->Update(DeltaTime);
+		}
+	}
+};
+
+// Add a component to the batch of its concrete type, "UpdateFunction" is only used when a new batch is created
+extern "C" VOODOOENGINE_API void AddUpdateComponentToBatch(
+	SUpdateScheduler* Scheduler,
+	UpdateComponent* Component,
+	EUpdatePhase Phase,
+	const std::type_info* Type,
+	UpdateBatchFunction UpdateFunction);
+
+template<class T>
+inline void AddUpdateComponent(
+	SUpdateScheduler* Scheduler, T* Component, EUpdatePhase Phase = UpdatePhase_PrePhysics)
+{
+	UpdateComponent* BaseComponent = Component;
+	UpdateBatchFunction UpdateFunction = &SUpdateBatchDispatch<UpdateComponent>::Update;
+	if (SUpdateBatchDispatch<T>::IsConcreteType(BaseComponent))
+	{
+		UpdateFunction = &SUpdateBatchDispatch<T>::Update;
+	}
+
+	AddUpdateComponentToBatch(Scheduler, BaseComponent, Phase, &typeid(*BaseComponent), UpdateFunction);
+}
+
+// Remove a component from its batch (or from the paused components), does nothing if not added
+extern "C" VOODOOENGINE_API void RemoveUpdateComponent(SUpdateScheduler* Scheduler, UpdateComponent* Component);
+
+// Paused components stay in the scheduler but are not updated until unpaused
+extern "C" VOODOOENGINE_API void SetUpdateComponentPaused(
+	SUpdateScheduler* Scheduler, UpdateComponent* Component, bool SetPaused);
+extern "C" VOODOOENGINE_API void SetAllUpdateComponentsPaused(SUpdateScheduler* Scheduler, bool SetPaused);
+
+// Called by the engine every frame while the game is running, updates all batches of a phase
+extern "C" VOODOOENGINE_API void UpdateSchedulerPhase(SUpdateScheduler* Scheduler, EUpdatePhase Phase, float DeltaTime);
@@ -1,56 +1,5 @@
 #include "VoodooEngine.h"
 
-// Create and register app window
-static void CreateAppWindow(SWindowParameters& WindowParams, WNDPROC InputCallbackFunction)
-{
-	WindowParams.WindowClass.cbSize = sizeof(WNDCLASSEX);
-	WindowParams.WindowClass.lpfnWndProc = InputCallbackFunction;
-	WindowParams.WindowClass.cbClsExtra = 0;
-	WindowParams.WindowClass.cbWndExtra = 0;
-	WindowParams.WindowClass.hInstance = nullptr;
-	WindowParams.WindowClass.lpszClassName = L"Window";
-	WindowParams.WindowClass.lpszMenuName = nullptr;
-	WindowParams.WindowClass.hbrBackground = nullptr;
-	WindowParams.WindowClass.hIcon = nullptr;
-	WindowParams.WindowClass.hIconSm = nullptr;
-	WindowParams.WindowClass.hCursor = nullptr;
-
-	RegisterClassEx(&WindowParams.WindowClass);
-
-	int WindowFullscreen = 0;
-	if (WindowParams.Fullscreen)
-	{
-		WindowFullscreen = WS_POPUP;
-	}
-	else
-	{
-		WindowFullscreen = WS_OVERLAPPEDWINDOW;
-	}
-
-	WindowParams.HWind = CreateWindow(
-		WindowParams.WindowClass.lpszClassName,
-		WindowParams.WindowTitle,
-		WindowFullscreen,
-		0, 0,
-		WindowParams.ScreenResolutionWidth,
-		WindowParams.ScreenResolutionHeight,
-		nullptr,
-		nullptr,
-		WindowParams.WindowClass.hInstance,
-		nullptr);
-}
-
-// Updates any changes made to the app window (e.g. dragging the window)
-static void UpdateAppWindow()
-{
-	MSG MSGMessage;
-	MSGMessage.message = WM_NULL;
-	while (PeekMessage(&MSGMessage, nullptr, 0, 0, PM_REMOVE))
-	{
-		DispatchMessage(&MSGMessage);
-	}
-}
-
 // This will set a custom assigned icon of the app window title/task bar
 // (will default to windows default app icon if no valid custom icon is found)
 static void SetCustomAppIcon(VoodooEngine* Engine)
@@ -66,44 +15,13 @@ static void SetCustomAppIcon(VoodooEngine* Engine)
 		IconPath = L"GameIcon.ico";
 	}
 
-	// Load custom app icon from file (ico file format)
-	HANDLE CustomAppIcon = LoadImage(
-		0, IconPath,
-		IMAGE_ICON, 0, 0,
-		LR_DEFAULTSIZE | LR_LOADFROMFILE);
-
-	// Assign the custom icon as the official icon of the app 
-	// (if no icon is found, then the engine will use default desktop icon)
-	if (CustomAppIcon)
-	{
-		SendMessage(Engine->Window.HWind, WM_SETICON, ICON_SMALL, (LPARAM)CustomAppIcon);
-		SendMessage(Engine->Window.HWind, WM_SETICON, ICON_BIG, (LPARAM)CustomAppIcon);
-		
-		SendMessage(GetWindow(
-			Engine->Window.HWind, GW_OWNER), WM_SETICON, ICON_SMALL, (LPARAM)CustomAppIcon);
-		SendMessage(GetWindow(
-			Engine->Window.HWind, GW_OWNER), WM_SETICON, ICON_BIG, (LPARAM)CustomAppIcon);
-	}
-}
-
-// Setup default brushes used by various objects that needs a brush 
-// (so we don't create new brushes for every object)
-static void SetupDefaultBrushes(VoodooEngine* Engine)
-{
-	Engine->Renderer->CreateSolidColorBrush(
-		D2D1::ColorF(D2D1::ColorF::Black),
-		&Engine->BlackBrush);
-
-	Engine->Renderer->CreateSolidColorBrush(
-		D2D1::ColorF(D2D1::ColorF::White),
-		&Engine->WhiteBrush);
+	SetPlatformWindowIcon(Engine->Window.HWind, IconPath);
 }
 
-static UINT64 VoodooEngineGetTicks(VoodooEngine* Engine)
+static int64_t VoodooEngineGetTicks(VoodooEngine* Engine)
 {
-	QueryPerformanceCounter(&Engine->CurrentTicks);
-	return (UINT64)(((Engine->CurrentTicks.QuadPart - 
-		Engine->StartTicks.QuadPart) * 1000) / Engine->TicksPerSecond.QuadPart);
+	Engine->CurrentTicks = GetPlatformTicks();
+	return ((Engine->CurrentTicks - Engine->StartTicks) * 1000) / Engine->TicksPerSecond;
 }
 
 static void UpdateFrameRate(VoodooEngine* Engine)
@@ -112,7 +30,7 @@ static void UpdateFrameRate(VoodooEngine* Engine)
 	if (Engine->TimeToWait > 0 &&
 		Engine->TimeToWait <= Engine->FrameTargetTime)
 	{
-		Sleep(Engine->TimeToWait);
+		PlatformSleep(Engine->TimeToWait);
 	}
 	Engine->DeltaTime = (VoodooEngineGetTicks(Engine) - Engine->PreviousFrameTime) / 1000.0;
 	Engine->PreviousFrameTime = VoodooEngineGetTicks(Engine);
@@ -132,69 +50,41 @@ void ShiftBitmapToLetter(int LetterID, BitmapComponent* LetterBitmap, VoodooEngi
 	LetterBitmap->BitmapParams.BitmapOffsetRight.X = Engine->LetterSpace;
 }
 
+// Location of a letter in the font bitmap (0 if the font has no such letter)
+static int GetLetterID(char Letter)
+{
+	if (Letter >= 'a' && Letter <= 'z')
+	{
+		return Letter - 'a' + 1;
+	}
+
+	switch (Letter)
+	{
+	case '.':
+		return 27;
+	case ',':
+		return 28;
+	case '?':
+		return 29;
+	case '!':
+		return 30;
+	}
+
+	return 0;
+}
+
 void AssignLetterShiftByID(std::string Letter, BitmapComponent* LetterBitmap, VoodooEngine* Engine)
 {
-	// The numbers represent a location in the font bitmap
-	if (Letter == "a")
-		ShiftBitmapToLetter(1, LetterBitmap, Engine);
-	if (Letter == "b")
-		ShiftBitmapToLetter(2, LetterBitmap, Engine);
-	if (Letter == "c")
-		ShiftBitmapToLetter(3, LetterBitmap, Engine);
-	if (Letter == "d")
-		ShiftBitmapToLetter(4, LetterBitmap, Engine);
-	if (Letter == "e")
-		ShiftBitmapToLetter(5, LetterBitmap, Engine);
-	if (Letter == "f")
-		ShiftBitmapToLetter(6, LetterBitmap, Engine);
-	if (Letter == "g")
-		ShiftBitmapToLetter(7, LetterBitmap, Engine);
-	if (Letter == "h")
-		ShiftBitmapToLetter(8, LetterBitmap, Engine);
-	if (Letter == "i")
-		ShiftBitmapToLetter(9, LetterBitmap, Engine);
-	if (Letter == "j")
-		ShiftBitmapToLetter(10, LetterBitmap, Engine);
-	if (Letter == "k")
-		ShiftBitmapToLetter(11, LetterBitmap, Engine);
-	if (Letter == "l")
-		ShiftBitmapToLetter(12, LetterBitmap, Engine);
-	if (Letter == "m")
-		ShiftBitmapToLetter(13, LetterBitmap, Engine);
-	if (Letter == "n")
-		ShiftBitmapToLetter(14, LetterBitmap, Engine);
-	if (Letter == "o")
-		ShiftBitmapToLetter(15, LetterBitmap, Engine);
-	if (Letter == "p")
-		ShiftBitmapToLetter(16, LetterBitmap, Engine);
-	if (Letter == "q")
-		ShiftBitmapToLetter(17, LetterBitmap, Engine);
-	if (Letter == "r")
-		ShiftBitmapToLetter(18, LetterBitmap, Engine);
-	if (Letter == "s")
-		ShiftBitmapToLetter(19, LetterBitmap, Engine);
-	if (Letter == "t")
-		ShiftBitmapToLetter(20, LetterBitmap, Engine);
-	if (Letter == "u")
-		ShiftBitmapToLetter(21, LetterBitmap, Engine);
-	if (Letter == "v")
-		ShiftBitmapToLetter(22, LetterBitmap, Engine);
-	if (Letter == "w")
-		ShiftBitmapToLetter(23, LetterBitmap, Engine);
-	if (Letter == "x")
-		ShiftBitmapToLetter(24, LetterBitmap, Engine);
-	if (Letter == "y")
-		ShiftBitmapToLetter(25, LetterBitmap, Engine);
-	if (Letter == "z")
-		ShiftBitmapToLetter(26, LetterBitmap, Engine);
-	if (Letter == ".")
-		ShiftBitmapToLetter(27, LetterBitmap, Engine);
-	if (Letter == ",")
-		ShiftBitmapToLetter(28, LetterBitmap, Engine);
-	if (Letter == "?")
-		ShiftBitmapToLetter(29, LetterBitmap, Engine);
-	if (Letter == "!")
-		ShiftBitmapToLetter(30, LetterBitmap, Engine);
+	if (Letter.length() != 1)
+	{
+		return;
+	}
+
+	int LetterID = GetLetterID(Letter[0]);
+	if (LetterID > 0)
+	{
+		ShiftBitmapToLetter(LetterID, LetterBitmap, Engine);
+	}
 }
 
 BitmapComponent* CreateLetter(
@@ -238,14 +128,21 @@ void CreateText(VoodooEngine* Engine, Button* ButtonReference, SButtonParameters
 	}
 }
 
-void ScreenPrint(VoodooEngine* Engine, std::string DebugText)
+void ScreenPrint(VoodooEngine* Engine, const char* DebugText)
 {
-	if (!Engine)
+	if (!Engine ||
+		!DebugText)
 	{
 		return;
 	}
 
-	SEditorAssetPathList FontAssetPath;
+	// Font is loaded once and shared by all printed letters (no font without a renderer)
+	if (!Engine->ScreenPrintFont &&
+		!Engine->Headless)
+	{
+		SEditorAssetPathList FontAssetPath;
+		Engine->ScreenPrintFont = SetupBitmap(nullptr, FontAssetPath.DebugFont, Engine->Renderer);
+	}
 
 	float OriginPositionY = 100;
 	SVector LetterLocation = { 0, OriginPositionY };
@@ -253,22 +150,57 @@ void ScreenPrint(VoodooEngine* Engine, std::string DebugText)
 	Engine->ScreenPrintTextColumnsPrinted += 1;
 	float OffsetAmount = 30;
 	float LetterOffsetY = LetterLocation.Y += (OffsetAmount * Engine->ScreenPrintTextColumnsPrinted);
-	for (int i = 0; i < DebugText.length(); ++i)
+	for (int i = 0; DebugText[i] != '\0'; ++i)
 	{
 		// Makes room for the next letter in the text
 		LetterOffsetX += Engine->LetterSpace;
 		LetterLocation.X = LetterOffsetX;
 
 		// Create the next letter in the button text string 
-		// (dont create and leave white space if "_" symbol is found, 
+		// (don't create and leave white space if "_" symbol is found, 
 		// but still offset the location for the next letter)
-		if (DebugText.substr(i, 1) != "_")
+		if (DebugText[i] == '_')
 		{
-			BitmapComponent* NewLetter = CreateLetter(Engine, DebugText.substr(i, 1),
-				LetterLocation, FontAssetPath.DebugFont);
+			continue;
+		}
 
-			Engine->StoredScreenPrintTexts.push_back(NewLetter);
+		// Letters are only taken from the pool, all letters are on screen until the next "ClearScreenPrint"
+		if (Engine->ScreenPrintLetterPool.empty())
+		{
+			return;
 		}
+
+		BitmapComponent* NewLetter = Engine->ScreenPrintLetterPool.back();
+		Engine->ScreenPrintLetterPool.pop_back();
+		*NewLetter = BitmapComponent();
+
+		NewLetter->Bitmap = Engine->ScreenPrintFont;
+		SetupBitmapComponent(NewLetter, NewLetter->Bitmap);
+		NewLetter->ComponentLocation = LetterLocation;
+		int LetterID = GetLetterID(DebugText[i]);
+		if (LetterID > 0)
+		{
+			ShiftBitmapToLetter(LetterID, NewLetter, Engine);
+		}
+
+		Engine->StoredScreenPrintTexts.push_back(NewLetter);
+	}
+}
+
+// All letters used by "ScreenPrint" are created once, so printing never allocates
+static void CreateScreenPrintLetterPool(VoodooEngine* Engine)
+{
+	if (!Engine->ScreenPrintLetterPool.empty() ||
+		!Engine->StoredScreenPrintTexts.empty())
+	{
+		return;
+	}
+
+	Engine->ScreenPrintLetterPool.reserve(SCREENPRINT_MAXNUM_LETTERS);
+	Engine->StoredScreenPrintTexts.reserve(SCREENPRINT_MAXNUM_LETTERS);
+	for (int i = 0; i < SCREENPRINT_MAXNUM_LETTERS; ++i)
+	{
+		Engine->ScreenPrintLetterPool.push_back(new BitmapComponent());
 	}
 }
  
@@ -315,13 +247,12 @@ Button* CreateButton(
 	switch (ButtonType)
 	{
 	case OneSided:
-		BitmapVector2D.X = ButtonToCreate->ButtonBitmap.Bitmap->GetSize().width;
-		BitmapVector2D.Y = ButtonToCreate->ButtonBitmap.Bitmap->GetSize().height;
+		BitmapVector2D = GetPlatformTextureSize(ButtonToCreate->ButtonBitmap.Bitmap);
 		SetBitmapSourceLocationX(&ButtonToCreate->ButtonBitmap, BitmapVector2D.X);
 		break;
 	case TwoSided:
-		BitmapVector2D.X = ButtonToCreate->ButtonBitmap.Bitmap->GetSize().width / 2;
-		BitmapVector2D.Y = ButtonToCreate->ButtonBitmap.Bitmap->GetSize().height;
+		BitmapVector2D = GetPlatformTextureSize(ButtonToCreate->ButtonBitmap.Bitmap);
+		BitmapVector2D.X /= 2;
 		SetBitmapSourceLocationX(&ButtonToCreate->ButtonBitmap, BitmapVector2D.X);
 		break;
 	case AssetButtonThumbnail:
@@ -462,7 +393,7 @@ void SetButtonState(
 		{
 			SetBitmapSourceLocationX(
 				&ButtonToUpdate->ButtonBitmap,
-				ButtonToUpdate->ButtonBitmap.Bitmap->GetSize().width / 2,
+				GetPlatformTextureSize(ButtonToUpdate->ButtonBitmap.Bitmap).X / 2,
 				1);
 		}
 		break;
@@ -476,7 +407,7 @@ void SetButtonState(
 		{
 			SetBitmapSourceLocationX(
 				&ButtonToUpdate->ButtonBitmap,
-				ButtonToUpdate->ButtonBitmap.Bitmap->GetSize().width / 2,
+				GetPlatformTextureSize(ButtonToUpdate->ButtonBitmap.Bitmap).X / 2,
 				2);
 		}
 		break;
@@ -531,6 +462,7 @@ void SetCustomMouseCursorLocation(VoodooEngine* Engine, SVector NewLocation)
 		return;
 	}
 
+	RecordCursorLocation(Engine, NewLocation);
 	Engine->Mouse.Location = NewLocation;
 
 	Engine->Mouse.MouseBitmap.ComponentLocation = NewLocation;
@@ -542,23 +474,44 @@ void SetCustomMouseCursorLocation(VoodooEngine* Engine, SVector NewLocation)
 
 void UpdateCustomMouseCursorLocation(VoodooEngine* Engine)
 {
-	POINT MousePositionPoint;
-	GetCursorPos(&MousePositionPoint);
-	SVector MousePosition = { 0, 0 };
-	MousePosition.X = MousePositionPoint.x;
-	MousePosition.Y = MousePositionPoint.y;
-	
-	SetCustomMouseCursorLocation(Engine, MousePosition);
+	SetCustomMouseCursorLocation(Engine, GetPlatformCursorLocation());
 }
 
 void Update(VoodooEngine* Engine)
 {
-	UpdateFrameRate(Engine);
-	UpdateAppWindow();
-	UpdateCustomMouseCursorLocation(Engine);
+	VOODOO_PROFILE_SCOPE("Update");
+
+	if (Engine->Headless)
+	{
+		// Fixed clock with no frame rate limit, there is no window to update 
+		// and mouse location is only set through "SetCustomMouseCursorLocation"
+		Engine->DeltaTime = Engine->HeadlessFixedDeltaTime;
+		UpdateInputRecording(Engine);
+	}
+	else
+	{
+		{
+			VOODOO_PROFILE_SCOPE("UpdateFrameRate");
+			UpdateFrameRate(Engine);
+		}
+		UpdateInputRecording(Engine);
+		{
+			VOODOO_PROFILE_SCOPE("UpdateAppWindow");
+			UpdatePlatformWindow();
+		}
+		// Cursor location comes from the recording while replaying
+		if (!Engine->InputReplay.Replaying)
+		{
+			UpdateCustomMouseCursorLocation(Engine);
+		}
+	}
+
+	// Finish the level save once written, before the level editor shows its result
+	UpdateLevelSave(Engine);
 
 	if (Engine->EditorMode)
 	{
+		VOODOO_PROFILE_SCOPE("UpdateEditorComponents");
 		for (int i = 0; i < Engine->StoredEditorUpdateComponents.size(); ++i)
 		{
 			Engine->StoredEditorUpdateComponents[i]->Update(Engine->DeltaTime);
@@ -567,23 +520,28 @@ void Update(VoodooEngine* Engine)
 
 	if (Engine->GameRunning)
 	{
-		for (int i = 0; i < Engine->StoredUpdateComponents.size(); ++i)
 		{
-			if (!Engine->StoredUpdateComponents[i]->Paused)
+			VOODOO_PROFILE_SCOPE("UpdateComponents");
+			for (int Phase = 0; Phase < UpdatePhase_Max; ++Phase)
 			{
-				Engine->StoredUpdateComponents[i]->Update(Engine->DeltaTime);
-			}
-		}
+				UpdateSchedulerPhase(&Engine->UpdateScheduler, (EUpdatePhase)Phase, Engine->DeltaTime);
 
-		// Only used for timers
-		for (int i = 0; i < Engine->StoredTimerUpdateComponents.size(); ++i)
-		{
-			if (!Engine->StoredTimerUpdateComponents[i]->Paused)
-			{
-				Engine->StoredTimerUpdateComponents[i]->Update(Engine->DeltaTime);
+				// Everything moved within a phase is at its new location for the next phase
+				UpdateTransforms();
 			}
 		}
+
+		UpdateSpriteAnimators(&Engine->SpriteAnimators, Engine->DeltaTime);
+
+		VOODOO_PROFILE_SCOPE("UpdateTimers");
+		UpdateTimerService(&Engine->TimerService, Engine->DeltaTime);
 	}
+
+	// Continue the background level load requested this frame (e.g. by a load level trigger)
+	UpdateLevelPreload(Engine);
+
+	// Anything moved outside of the update phases (timers, level editor etc.) before rendering
+	UpdateTransforms();
 }
 
 SVector GetObjectLocation(Object* Object)
@@ -594,14 +552,29 @@ SVector GetObjectLocation(Object* Object)
 void SetObjectLocation(Object* Object, SVector NewLocation)
 {
 	Object->Location = NewLocation;
+	SetTransformLocation(&Object->ObjectTransform, NewLocation);
 }
 
 void SetComponentRelativeLocation(
 	Object* ComponentOwner, TransformComponent* Component, SVector NewLocation)
 {
-	Component->ComponentLocation = 
-		{ComponentOwner->Location.X + NewLocation.X,
-		ComponentOwner->Location.Y + NewLocation.Y};
+	// Owner location may have been set directly
+	SVector OwnerTransformLocation = GetTransformWorldLocation(&ComponentOwner->ObjectTransform);
+	if (OwnerTransformLocation.X != ComponentOwner->Location.X ||
+		OwnerTransformLocation.Y != ComponentOwner->Location.Y)
+	{
+		SetTransformLocation(&ComponentOwner->ObjectTransform, ComponentOwner->Location);
+	}
+
+	if (Component->Parent == &ComponentOwner->ObjectTransform)
+	{
+		SetTransformLocation(Component, NewLocation);
+		Component->ComponentLocation = GetTransformWorldLocation(Component);
+	}
+	else
+	{
+		AttachTransform(&ComponentOwner->ObjectTransform, Component, NewLocation);
+	}
 }
 
 SVector GetComponentRelativeLocation(
@@ -616,10 +589,7 @@ SVector GetComponentRelativeLocation(
 
 void PauseGame(VoodooEngine* Engine, bool SetGamePaused)
 {
-	for (int i = 0; i < Engine->StoredUpdateComponents.size(); ++i)
-	{
-		Engine->StoredUpdateComponents[i]->Paused = SetGamePaused;
-	}
+	SetAllUpdateComponentsPaused(&Engine->UpdateScheduler, SetGamePaused);
 }
 
 bool SetDebugMode()
@@ -677,7 +647,8 @@ void StoreTextureAtlasesFromFile(VoodooEngine* Engine)
 	int TextureAtlasID = -1;
 
 	const wchar_t* FileName = L"GameContent/Data/TextureAtlasID.txt";
-	std::fstream File(FileName);
+	std::fstream File;
+	OpenPlatformFile(File, FileName, std::ios_base::in | std::ios_base::out);
 	if (File.is_open())
 	{
 		std::string VerticalLine;
@@ -725,7 +696,8 @@ void StoreGameObjectIDsFromFile(VoodooEngine* Engine)
 	int GameObjectID = -1;
 	
 	const wchar_t* FileName = L"GameContent/Data/GameObjectID.txt";
-	std::fstream File(FileName);
+	std::fstream File;
+	OpenPlatformFile(File, FileName, std::ios_base::in | std::ios_base::out);
 	if (File.is_open())
 	{
 		std::string VerticalLine;
@@ -796,9 +768,10 @@ void ActivateLevel(
 		Engine->StoredGameObjects[i]->SetGameObjectState(false);
 
 		// If in debug mode stop rendering the debug asset collision rect
-		if (Engine->DebugMode)
+		if (Engine->DebugMode &&
+			Engine->StoredGameObjects[i]->DefaultGameObjectCollision)
 		{
-			Engine->StoredGameObjects[i]->DefaultGameObjectCollision.RenderCollisionRect = false;
+			Engine->StoredGameObjects[i]->DefaultGameObjectCollision->RenderCollisionRect = false;
 		}
 	}
 	
@@ -815,9 +788,10 @@ void ActivateLevel(
 		Level[i]->SetGameObjectState(true);
 
 		// If in debug mode, render asset collision that is part of the current active level
-		if (Engine->DebugMode)
+		if (Engine->DebugMode &&
+			Level[i]->DefaultGameObjectCollision)
 		{
-			Level[i]->DefaultGameObjectCollision.RenderCollisionRect = true;
+			Level[i]->DefaultGameObjectCollision->RenderCollisionRect = true;
 		}
 
 		if (Level[i]->GameObjectID == PlayerStartLeftID)
@@ -850,8 +824,8 @@ void ActivateLevel(
 
 void InitWindowAndRenderer(
 	VoodooEngine* Engine,
-	LPCWSTR WindowTitle, 
-	WNDPROC WindowsProcedure,
+	const wchar_t* WindowTitle, 
+	PlatformWindowProcedure WindowsProcedure,
 	int WindowResolutionWidth, 
 	int WindowResolutionHeight, 
 	bool WindowFullScreen)
@@ -861,10 +835,11 @@ void InitWindowAndRenderer(
 	Engine->Window.ScreenResolutionWidth = WindowResolutionWidth;
 	Engine->Window.ScreenResolutionHeight = WindowResolutionHeight;
 	Engine->Window.Fullscreen = WindowFullScreen;
-	CreateAppWindow(Engine->Window, WindowsProcedure);
+	Engine->Window.HWind = CreatePlatformWindow(
+		WindowTitle, WindowResolutionWidth, WindowResolutionHeight, WindowFullScreen, WindowsProcedure);
 
 	// Setup the renderer
-	Engine->Renderer = SetupRenderer(Engine->Renderer, Engine->Window.HWind);
+	Engine->Renderer = CreatePlatformRenderer(Engine->Window.HWind);
 }
 
 // Store the player start game objects in the asset content browser in the level editor (left, right, up, down). 
@@ -940,6 +915,8 @@ void AssignLevelEditorRenderLayerNames(VoodooEngine* Engine, SRenderLayerNames R
 
 void InitEngine(VoodooEngine* Engine, SRenderLayerNames RenderLayerNames)
 {
+	VOODOO_PROFILE_SCOPE("InitEngine");
+
 	// Assign the render layer names and ID's
 	AssignLevelEditorRenderLayerNames(Engine, RenderLayerNames);
 
@@ -953,29 +930,69 @@ void InitEngine(VoodooEngine* Engine, SRenderLayerNames RenderLayerNames)
 	// Assign based on configuration file if debug mode is true/false
 	Engine->DebugMode = SetDebugMode();
 	// Assign based on configuration file if editor mode is true/false
-	Engine->EditorMode = SetEditorMode();
-
-	// Set the app icon that is visible in task bar and window title bar
-	SetCustomAppIcon(Engine);
+	// (level editor needs a window and renderer, so it is never used in headless mode)
+	Engine->EditorMode = Engine->Headless ? false : SetEditorMode();
 
 	// Create engine mouse cursor
 	CreateMouse(Engine, { 6, 6 });
 
-	// Setup default brushes used by various objects that needs a brush 
-	// (so we don't create new brushes for every object)
-	SetupDefaultBrushes(Engine);
+	// Letters of debug text printed to screen
+	CreateScreenPrintLetterPool(Engine);
+
+	if (!Engine->Headless)
+	{
+		// Set the app icon that is visible in task bar and window title bar
+		SetCustomAppIcon(Engine);
 
-	// Create the text format for the engine UI texts
-	CreateUITextFormat(Engine);
+		// Setup default brushes used by various objects that needs a brush 
+		// (so we don't create new brushes for every object)
+		SetupDefaultBrushes(Engine);
+
+		// Create the text format for the engine UI texts
+		CreateUITextFormat(Engine);
 	
-	// Set up the frequency (only need to do once)
-	QueryPerformanceFrequency(&Engine->TicksPerSecond);
-	// Set the start ticks for calculating frame rate
-	QueryPerformanceCounter(&Engine->StartTicks);
+		// Set up the frequency (only need to do once)
+		Engine->TicksPerSecond = GetPlatformTicksPerSecond();
+		// Set the start ticks for calculating frame rate
+		Engine->StartTicks = GetPlatformTicks();
+	}
+
+	InitJobSystem(Engine->NumJobWorkerThreads);
+	ResetFrameArena();
+	SetTransformDirtyList(&Engine->DirtyTransforms);
 
 	Engine->EngineRunning = true;
 }
 
+void InitEngineHeadless(VoodooEngine* Engine, SRenderLayerNames RenderLayerNames, float FixedDeltaTime)
+{
+	// No renderer means no bitmaps are created, 
+	// all bitmap components are still set up (with a nullptr bitmap) so game objects can be created as usual
+	Engine->Headless = true;
+	Engine->Renderer = nullptr;
+	Engine->HeadlessFixedDeltaTime = FixedDeltaTime;
+
+	InitEngine(Engine, RenderLayerNames);
+}
+
+// Write a snapshot of all metrics to file every "MetricsDumpInterval" seconds (if set)
+static void UpdateMetricsDump(VoodooEngine* Engine)
+{
+	if (Engine->MetricsDumpInterval <= 0)
+	{
+		return;
+	}
+
+	Engine->MetricsDumpTimer += Engine->DeltaTime;
+	if (Engine->MetricsDumpTimer >= Engine->MetricsDumpInterval)
+	{
+		Engine->MetricsDumpTimer = 0;
+		DumpMetricsToFile(Engine->MetricsDumpFileName);
+		// Frame time percentiles are reported per dump interval
+		ResetMetricHistogram(GetEngineMetrics()->FrameTime);
+	}
+}
+
 void RunEngine(VoodooEngine* Engine)
 {
 	if (!Engine)
@@ -983,48 +1000,52 @@ void RunEngine(VoodooEngine* Engine)
 		return;
 	}
 
+	VOODOO_PROFILE_BEGIN_FRAME();
+
 	Update(Engine);
 	
-	Engine->Renderer->BeginDraw();
-	Engine->Renderer->Clear(Engine->ClearScreenColor);
-	Render(Engine);
-	Engine->Renderer->EndDraw();
+	// Nothing is rendered in headless mode
+	if (!Engine->Headless)
+	{
+		Render(Engine);
+	}
+
+	AddMetricCounter(GetEngineMetrics()->FramesRendered);
+	AddMetricHistogramValue(GetEngineMetrics()->FrameTime, Engine->DeltaTime * 1000);
+	AddMetricCounter(GetEngineMetrics()->HeapAllocations, GetNumFrameHeapAllocations());
+	EndMetricsFrame();
+	UpdateMetricsDump(Engine);
+	EndJobSystemFrame();
+	ResetFrameArena();
+
+	// Close the recording and finish the level save when engine stops running so the files are complete
+	// (a running level preload is stopped)
+	if (!Engine->EngineRunning)
+	{
+		StopInputRecording(Engine);
+		WaitForLevelSave(Engine);
+		ResetLevelPreload(Engine);
+	}
+
+	Engine->FrameNumber++;
+
+	VOODOO_PROFILE_END_FRAME();
 }
 
 void OpenLevelFile(VoodooEngine* Engine)
 {
-	// Common dialog box structure
-	OPENFILENAME OFN;
 	// Buffer for file name
 	wchar_t FileNameBuffer[260];
 
-	// Initialize OPENFILENAME
-	ZeroMemory(&OFN, sizeof(OFN));
-	OFN.lStructSize = sizeof(OFN);
-	OFN.hwndOwner = Engine->Window.HWind;
-	OFN.lpstrFile = FileNameBuffer;
-
-	// Set lpstrFile[0] to '\0', 
-	// so that GetOpenFileName does not use the contents of FileNameBuffer to initialize itself
-	OFN.lpstrFile[0] = '\0';
-
-	OFN.nMaxFile = sizeof(FileNameBuffer);
-	OFN.lpstrFilter = L"Lev File\0*.LEV\0";
-	OFN.nFilterIndex = 1;
-	OFN.lpstrFileTitle = NULL;
-	OFN.nMaxFileTitle = 0;
-	OFN.lpstrInitialDir = NULL;
-	OFN.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST;
-
 	// Display the Open dialog box if valid
-	if (GetOpenFileName(&OFN) == TRUE)
+	if (OpenPlatformFileDialog(Engine->Window.HWind, L"Lev File\0*.LEV\0", FileNameBuffer, 260))
 	{
 		// Called once the "open" button has been clicked
 		// NOTE: Pass empty vector since it is only used for caching gameobjects from level file
 		// In this case we don't want to cache any game objects, just load the level for level editing
 		std::vector<GameObject*> EmptyVector;
-		Engine->LoadGameObjectsFromFile(Engine, OFN.lpstrFile, EmptyVector);
-		Engine->OpenedLevelFileString = OFN.lpstrFile;
+		Engine->LoadGameObjectsFromFile(Engine, FileNameBuffer, EmptyVector);
+		Engine->OpenedLevelFileString = FileNameBuffer;
 	}
 }
 
@@ -1035,9 +1056,16 @@ void SetGameObjectLocation(GameObject* GameObjectToSet, SVector NewLocation)
 		return;
 	}
 
+	// Bitmap, default collision and anything else attached to the object transform
+	// are moved in the next "UpdateTransforms"
 	GameObjectToSet->Location = NewLocation;
-	GameObjectToSet->GameObjectBitmap.ComponentLocation = NewLocation;
-	GameObjectToSet->DefaultGameObjectCollision.ComponentLocation = NewLocation;
+	SetTransformLocation(&GameObjectToSet->ObjectTransform, NewLocation);
+
+	// Bitmap and default collision of an entity follow the entity transform
+	if (GameObjectToSet->IsStoredAsEntity())
+	{
+		SetEntityLocation(GameObjectToSet->ColdData->EntityStorage, GameObjectToSet->ColdData->EntityHandle, NewLocation);
+	}
 }
 
 void SetCharacterLocation(Character* CharacterToSet, SVector NewLocation)
@@ -1055,13 +1083,7 @@ void SetCharacterLocation(Character* CharacterToSet, SVector NewLocation)
 	CharacterToSet->MoveComp.Velocity = 0;
 
 	// Teleport player to new location
-	CharacterToSet->Location = NewLocation;
-	CharacterToSet->GameObjectBitmap.ComponentLocation = NewLocation;
-	CharacterToSet->DefaultGameObjectCollision.ComponentLocation = NewLocation;
-	CharacterToSet->MoveComp.QuadCollisionParams.CollisionLeft.ComponentLocation = NewLocation;
-	CharacterToSet->MoveComp.QuadCollisionParams.CollisionRight.ComponentLocation = NewLocation;
-	CharacterToSet->MoveComp.QuadCollisionParams.CollisionUp.ComponentLocation = NewLocation;
-	CharacterToSet->MoveComp.QuadCollisionParams.CollisionDown.ComponentLocation = NewLocation;
+	SetGameObjectLocation(CharacterToSet, NewLocation);
 
 	// Only set gravity back if it was set to be activated for this character
 	if (WasGravityEnabled)
@@ -1070,8 +1092,211 @@ void SetCharacterLocation(Character* CharacterToSet, SVector NewLocation)
 	}
 }
 
-SVector AddMovementInput(VoodooEngine* Engine, Character* CharacterToAddMovement)
-{	
+// Result of testing the quad collision of a character against all stored colliders,
+// a range of colliders can be tested on any thread (results are merged so they never depend on the order).
+// Colliders are indexed as all stored collision components followed by the entity colliders
+// of every archetype with a collider (in archetype order)
+struct SMovementCollisionQuery
+{
+	VoodooEngine* Engine = nullptr;
+	Character* CharacterToTest = nullptr;
+	int NumCollisionComponents = 0;
+	int NumColliders = 0;
+	// First collider index of the entity colliders of every archetype (only used if the archetype has colliders)
+	int EntityColliderStart[EntityComponent_NumArchetypes] = {};
+	std::atomic<bool> HitLeft = { false };
+	std::atomic<bool> HitRight = { false };
+	std::atomic<bool> HitUp = { false };
+	// Index of the last collider hit by the "down" collision (same as testing all colliders in order)
+	std::atomic<int> LastHitDownIndex = { -1 };
+	std::atomic<int> NumCollidersTested = { 0 };
+};
+
+static void SetupMovementCollisionQuery(SMovementCollisionQuery* Query)
+{
+	Query->NumCollisionComponents = (int)Query->Engine->StoredCollisionComponents.size();
+	Query->NumColliders = Query->NumCollisionComponents;
+	for (int i = 0; i < EntityComponent_NumArchetypes; ++i)
+	{
+		SEntityArchetype& Archetype = Query->Engine->EntityStorage.Archetypes[i];
+		if (Archetype.ComponentMask & EntityComponent_Collider)
+		{
+			Query->EntityColliderStart[i] = Query->NumColliders;
+			Query->NumColliders += (int)Archetype.Colliders.size();
+		}
+	}
+}
+
+// Test the quad collision against the entity colliders within the collider index range [Begin, End)
+static void QueryMovementEntityCollision(
+	SMovementCollisionQuery* Query, int Begin, int End,
+	bool& HitLeft, bool& HitRight, bool& HitUp, int& LastHitDownIndex, int& NumCollidersTested)
+{
+	SQuadCollisionProbes* Probes = Query->CharacterToTest->MoveComp.QuadCollisionProbes;
+	bool RequestingJump = Query->CharacterToTest->MoveComp.IsRequestingJump();
+
+	for (int ArchetypeIndex = 0; ArchetypeIndex < EntityComponent_NumArchetypes; ++ArchetypeIndex)
+	{
+		SEntityArchetype& Archetype = Query->Engine->EntityStorage.Archetypes[ArchetypeIndex];
+		if (!(Archetype.ComponentMask & EntityComponent_Collider))
+		{
+			continue;
+		}
+
+		int Start = Query->EntityColliderStart[ArchetypeIndex];
+		int RowBegin = (Begin > Start) ? Begin - Start : 0;
+		int RowEnd = End - Start;
+		if (RowEnd > (int)Archetype.Colliders.size())
+		{
+			RowEnd = (int)Archetype.Colliders.size();
+		}
+
+		for (int Row = RowBegin; Row < RowEnd; ++Row)
+		{
+			SEntityTransform* Transform = &Archetype.Transforms[Row];
+			SEntityCollider* Collider = &Archetype.Colliders[Row];
+			if (Collider->CollisionType == ECollisionType::Collision_Overlap)
+			{
+				continue;
+			}
+			NumCollidersTested++;
+
+			if (IsEntityCollisionDetected(&Probes->CollisionLeft, Transform, Collider))
+			{
+				HitLeft = true;
+			}
+			if (IsEntityCollisionDetected(&Probes->CollisionRight, Transform, Collider))
+			{
+				HitRight = true;
+			}
+			if (IsEntityCollisionDetected(&Probes->CollisionUp, Transform, Collider))
+			{
+				HitUp = true;
+			}
+			if (IsEntityCollisionDetected(&Probes->CollisionDown, Transform, Collider) &&
+				!RequestingJump)
+			{
+				LastHitDownIndex = Start + Row;
+			}
+		}
+	}
+}
+
+// Get the location of a collider by its index within the query
+static SVector GetMovementQueryColliderLocation(SMovementCollisionQuery* Query, int ColliderIndex)
+{
+	if (ColliderIndex < Query->NumCollisionComponents)
+	{
+		return Query->Engine->StoredCollisionComponents[ColliderIndex]->ComponentLocation;
+	}
+
+	for (int ArchetypeIndex = EntityComponent_NumArchetypes - 1; ArchetypeIndex >= 0; --ArchetypeIndex)
+	{
+		SEntityArchetype& Archetype = Query->Engine->EntityStorage.Archetypes[ArchetypeIndex];
+		if ((Archetype.ComponentMask & EntityComponent_Collider) &&
+			ColliderIndex >= Query->EntityColliderStart[ArchetypeIndex])
+		{
+			int Row = ColliderIndex - Query->EntityColliderStart[ArchetypeIndex];
+			return 
+				{ Archetype.Transforms[Row].Location.X + Archetype.Colliders[Row].Offset.X,
+				Archetype.Transforms[Row].Location.Y + Archetype.Colliders[Row].Offset.Y };
+		}
+	}
+
+	return {};
+}
+
+static void QueryMovementCollision(void* Context, int Begin, int End)
+{
+	SMovementCollisionQuery* Query = (SMovementCollisionQuery*)Context;
+	std::vector<CollisionComponent*>& StoredCollisionComponents = Query->Engine->StoredCollisionComponents;
+	SQuadCollisionProbes* Probes = Query->CharacterToTest->MoveComp.QuadCollisionProbes;
+	bool RequestingJump = Query->CharacterToTest->MoveComp.IsRequestingJump();
+
+	bool HitLeft = false;
+	bool HitRight = false;
+	bool HitUp = false;
+	int LastHitDownIndex = -1;
+	int NumCollidersTested = 0;
+	int ComponentsEnd = (End < Query->NumCollisionComponents) ? End : Query->NumCollisionComponents;
+	for (int i = Begin; i < ComponentsEnd; ++i)
+	{
+		// Don't block character if found collision type is overlap
+		if (StoredCollisionComponents[i]->CollisionType == ECollisionType::Collision_Overlap)
+		{
+			continue;
+		}
+		NumCollidersTested++;
+
+		// Collision detected left
+		if (IsCollisionDetected(&Probes->CollisionLeft, StoredCollisionComponents[i]) &&
+			StoredCollisionComponents[i] != &Probes->CollisionRight &&
+			StoredCollisionComponents[i] != &Probes->CollisionUp &&
+			StoredCollisionComponents[i] != &Probes->CollisionDown)
+		{
+			HitLeft = true;
+		}
+		// Collision detected right
+		if (IsCollisionDetected(&Probes->CollisionRight, StoredCollisionComponents[i]) &&
+			StoredCollisionComponents[i] != &Probes->CollisionLeft &&
+			StoredCollisionComponents[i] != &Probes->CollisionUp &&
+			StoredCollisionComponents[i] != &Probes->CollisionDown)
+		{
+			HitRight = true;
+		}
+		// Collision detected up
+		if (IsCollisionDetected(&Probes->CollisionUp, StoredCollisionComponents[i]) &&
+			StoredCollisionComponents[i] != &Probes->CollisionDown &&
+			StoredCollisionComponents[i] != &Probes->CollisionLeft &&
+			StoredCollisionComponents[i] != &Probes->CollisionRight)
+		{
+			HitUp = true;
+		}
+		// Collision detected down
+		if (IsCollisionDetected(&Probes->CollisionDown, StoredCollisionComponents[i]) &&
+			StoredCollisionComponents[i] != &Probes->CollisionUp &&
+			StoredCollisionComponents[i] != &Probes->CollisionLeft &&
+			StoredCollisionComponents[i] != &Probes->CollisionRight)
+		{
+			if (!RequestingJump)
+			{
+				LastHitDownIndex = i;
+			}
+		}
+	}
+	if (End > Query->NumCollisionComponents)
+	{
+		QueryMovementEntityCollision(
+			Query, Begin, End, HitLeft, HitRight, HitUp, LastHitDownIndex, NumCollidersTested);
+	}
+
+	// Merge the result of this range
+	if (HitLeft)
+	{
+		Query->HitLeft = true;
+	}
+	if (HitRight)
+	{
+		Query->HitRight = true;
+	}
+	if (HitUp)
+	{
+		Query->HitUp = true;
+	}
+	int CurrentLastHitDownIndex = Query->LastHitDownIndex.load();
+	while (LastHitDownIndex > CurrentLastHitDownIndex &&
+		!Query->LastHitDownIndex.compare_exchange_weak(CurrentLastHitDownIndex, LastHitDownIndex))
+	{
+	}
+	Query->NumCollidersTested.fetch_add(NumCollidersTested);
+}
+
+// Movement phase 1 - compute the new location of a character from the current collider locations,
+// only the movement state of the character itself is written (collision hit flags, velocity etc.),
+// so any number of characters can be computed in parallel against the same collider locations
+static SVector ComputeMovementLocation(
+	VoodooEngine* Engine, Character* CharacterToAddMovement, bool ParallelCollisionQuery)
+{
 	// Default new location as the location of the component owner
 	SVector NewLocation = CharacterToAddMovement->Location;
 
@@ -1112,85 +1337,77 @@ SVector AddMovementInput(VoodooEngine* Engine, Character* CharacterToAddMovement
 	CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionHitUp = false;
 	CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionHitDown = false;
 
-	// Check for collision
-	for (int i = 0; i < Engine->StoredCollisionComponents.size(); ++i)
+	// Check for collision (nothing blocks the movement of a character without quad collision)
+	SQuadCollisionProbes* Probes = CharacterToAddMovement->MoveComp.QuadCollisionProbes;
+	if (Probes)
 	{
-		// Don't block character if found collision type is overlap
-		if (Engine->StoredCollisionComponents[i]->CollisionType == ECollisionType::Collision_Overlap)
+		SMovementCollisionQuery Query;
+		Query.Engine = Engine;
+		Query.CharacterToTest = CharacterToAddMovement;
+		SetupMovementCollisionQuery(&Query);
+		if (ParallelCollisionQuery)
 		{
-			continue;
+			ParallelFor(Query.NumColliders, MOVEMENT_COLLISION_BATCHSIZE, QueryMovementCollision, &Query);
+		}
+		else
+		{
+			QueryMovementCollision(&Query, 0, Query.NumColliders);
 		}
 
-		// Collision detected left
-		if (IsCollisionDetected(
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionLeft, 
-			Engine->StoredCollisionComponents[i]) &&
-			
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionRight &&
-			Engine->StoredCollisionComponents[i] != 
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionUp &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionDown)
+		SQuadCollisionParameters& QuadCollisionParams = CharacterToAddMovement->MoveComp.QuadCollisionParams;
+
+		// Tiles are a grid lookup of the cells under every quad collision rect (see "Tilemap.h")
+		float TileGroundLocation = 0;
+		bool TileHitDown = false;
+		if (!Engine->StoredTilemaps.empty())
 		{
-			CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionHitLeft = true;
-			CharacterToAddMovement->MoveComp.WallLeftHitCollisionLocation =
-				CharacterToAddMovement->Location.X;
+			Query.HitLeft = Query.HitLeft || IsTilemapCollisionDetected(Engine, &Probes->CollisionLeft);
+			Query.HitRight = Query.HitRight || IsTilemapCollisionDetected(Engine, &Probes->CollisionRight);
+			Query.HitUp = Query.HitUp || IsTilemapCollisionDetected(Engine, &Probes->CollisionUp);
+			TileHitDown = !CharacterToAddMovement->MoveComp.IsRequestingJump() &&
+				IsTilemapCollisionDetected(Engine, &Probes->CollisionDown, &TileGroundLocation);
 		}
-		// Collision detected right
-		if (IsCollisionDetected(
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionRight,
-			Engine->StoredCollisionComponents[i]) &&
-
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionLeft &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionUp &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionDown)
+
+		if (Query.HitLeft)
 		{
-			CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionHitRight = true;
-			CharacterToAddMovement->MoveComp.WallRightHitCollisionLocation =
-				CharacterToAddMovement->Location.X;
+			QuadCollisionParams.CollisionHitLeft = true;
+			CharacterToAddMovement->MoveComp.WallLeftHitCollisionLocation = CharacterToAddMovement->Location.X;
 		}
-		// Collision detected up
-		if (IsCollisionDetected(
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionUp, 
-			Engine->StoredCollisionComponents[i]) &&
-
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionDown &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionLeft &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionRight)
+		if (Query.HitRight)
 		{
-			CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionHitUp = true;
-			CharacterToAddMovement->MoveComp.RoofHitCollisionLocation =
-				CharacterToAddMovement->Location.Y;
+			QuadCollisionParams.CollisionHitRight = true;
+			CharacterToAddMovement->MoveComp.WallRightHitCollisionLocation = CharacterToAddMovement->Location.X;
 		}
-		// Collision detected down
-		if (IsCollisionDetected(
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionDown, 
-			Engine->StoredCollisionComponents[i]) &&
-
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionUp &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionLeft &&
-			Engine->StoredCollisionComponents[i] !=
-			&CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionRight)
+		if (Query.HitUp)
 		{
-			if (!CharacterToAddMovement->MoveComp.IsRequestingJump())
-			{
-				CharacterToAddMovement->MoveComp.QuadCollisionParams.CollisionHitDown = true;
+			QuadCollisionParams.CollisionHitUp = true;
+			CharacterToAddMovement->MoveComp.RoofHitCollisionLocation = CharacterToAddMovement->Location.Y;
+		}
+		if (Query.LastHitDownIndex >= 0)
+		{
+			QuadCollisionParams.CollisionHitDown = true;
 
-				// Cache the collision location of the collided object,
-				// this will be used later to determine the "snap" location of the character
-				CharacterToAddMovement->MoveComp.GroundHitCollisionLocation =
-					Engine->StoredCollisionComponents[i]->ComponentLocation.Y;
-			}
+			// Cache the collision location of the collided object,
+			// this will be used later to determine the "snap" location of the character
+			CharacterToAddMovement->MoveComp.GroundHitCollisionLocation =
+				GetMovementQueryColliderLocation(&Query, Query.LastHitDownIndex).Y;
 		}
+		else if (TileHitDown)
+		{
+			QuadCollisionParams.CollisionHitDown = true;
+			CharacterToAddMovement->MoveComp.GroundHitCollisionLocation = TileGroundLocation;
+		}
+
+		// Metrics are added once after the query to keep the collider loop itself free from atomics
+		// (each collider is tested against all four quad collision sides)
+		SEngineMetrics* Metrics = GetEngineMetrics();
+		AddMetricCounter(Metrics->CollidersTested, Query.NumCollidersTested);
+		AddMetricCounter(Metrics->AABBTests, Query.NumCollidersTested * 4);
+		AddMetricCounter(Metrics->AABBHits,
+			QuadCollisionParams.CollisionHitLeft +
+			QuadCollisionParams.CollisionHitRight +
+			QuadCollisionParams.CollisionHitUp +
+			QuadCollisionParams.CollisionHitDown);
 	}
 	
 	// Update gravity if enabled, used for e.g. sidescroller platformer, 
@@ -1235,23 +1452,80 @@ SVector AddMovementInput(VoodooEngine* Engine, Character* CharacterToAddMovement
 		}
 	}
 
-	// Update the new location of the quad collision rects 
-	// that check for character collision with the environment
-	CharacterToAddMovement->MoveComp.UpdateQuadCollisionLocation(NewLocation);
+	return NewLocation;
+}
+
+// Movement phase 2 - write the new location to the character, 
+// the quad collision rects, bitmaps and default collision (attached to the character transform) 
+// are moved in the next "UpdateTransforms"
+static void CommitMovementLocation(Character* CharacterToAddMovement, SVector NewLocation)
+{
+	SetGameObjectLocation(CharacterToAddMovement, NewLocation);
+}
+
+SVector AddMovementInput(VoodooEngine* Engine, Character* CharacterToAddMovement)
+{
+	VOODOO_PROFILE_SCOPE("AddMovementInput");
 
-	// Set character bitmap and asset collision location the same as the new location
-	CharacterToAddMovement->Location.X = NewLocation.X;
-	CharacterToAddMovement->Location.Y = NewLocation.Y;
-	CharacterToAddMovement->GameObjectBitmap.ComponentLocation.X = NewLocation.X;
-	CharacterToAddMovement->GameObjectBitmap.ComponentLocation.Y = NewLocation.Y;
-	CharacterToAddMovement->GameObjectFlippedBitmap.ComponentLocation.X = NewLocation.X;
-	CharacterToAddMovement->GameObjectFlippedBitmap.ComponentLocation.Y = NewLocation.Y;
-	CharacterToAddMovement->DefaultGameObjectCollision.ComponentLocation.X = NewLocation.X;
-	CharacterToAddMovement->DefaultGameObjectCollision.ComponentLocation.Y = NewLocation.Y;
+	// Collision is tested against the locations of the last "UpdateTransforms"
+	// (anything moved earlier in the same update phase is tested at its previous location)
+	SVector NewLocation = ComputeMovementLocation(Engine, CharacterToAddMovement, true);
+	CommitMovementLocation(CharacterToAddMovement, NewLocation);
 
 	return NewLocation;
 }
 
+struct SMovementBatch
+{
+	VoodooEngine* Engine = nullptr;
+	Character** Characters = nullptr;
+	SVector* NewLocations = nullptr;
+};
+
+static void ComputeMovementBatch(void* Context, int Begin, int End)
+{
+	SMovementBatch* Batch = (SMovementBatch*)Context;
+	for (int i = Begin; i < End; ++i)
+	{
+		// Colliders are tested on this thread, the characters are already split over all threads
+		Batch->NewLocations[i] = ComputeMovementLocation(Batch->Engine, Batch->Characters[i], false);
+	}
+}
+
+void AddMovementInputToCharacters(
+	VoodooEngine* Engine, Character** Characters, int NumCharacters, SVector* NewLocations)
+{
+	VOODOO_PROFILE_SCOPE("AddMovementInputToCharacters");
+
+	// Frame memory, only used when the caller does not keep the computed locations
+	FrameVector<SVector> ComputedLocations;
+	if (!NewLocations)
+	{
+		ComputedLocations.resize(NumCharacters);
+		NewLocations = ComputedLocations.data();
+	}
+
+	// Transforms are only read while computing, every character is tested against the locations of
+	// the last "UpdateTransforms" (same as "AddMovementInput")
+	SMovementBatch Batch;
+	Batch.Engine = Engine;
+	Batch.Characters = Characters;
+	Batch.NewLocations = NewLocations;
+	{
+		VOODOO_PROFILE_SCOPE("ComputeMovement");
+		ParallelFor(NumCharacters, MOVEMENT_CHARACTER_BATCHSIZE, ComputeMovementBatch, &Batch);
+	}
+
+	// Nothing has been moved until now, so every character was computed against the same collider locations
+	{
+		VOODOO_PROFILE_SCOPE("CommitMovement");
+		for (int i = 0; i < NumCharacters; ++i)
+		{
+			CommitMovementLocation(Characters[i], NewLocations[i]);
+		}
+	}
+}
+
 SVector AddMovementAI(AIComponent& AIComp)
 {
 	SVector NewLocation;
@@ -1,31 +1,47 @@
 #pragma once
 
-// Win32 API
+// Platform layer (Win32 API/Direct2D or null platform for headless builds)
 //---------------------
-#include <Windows.h>
-
-// Exclude rarely used stuff from Windows headers
-//#define WIN32_LEAN_AND_MEAN
+#include "Platform.h"
 //---------------------
 
-#include <commdlg.h>
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <unordered_set>
+#include <algorithm>
 
 // Disable warning of using "wcstombs"
+#ifdef _MSC_VER
 #pragma warning(disable:4996)
+#endif
 
 // includes engine class is dependent of 
 //---------------------
 #include "CollisionComponent.h"
 #include "UpdateComponent.h"
+#include "UpdateScheduler.h"
 #include "BitmapComponent.h"
+#include "EntityStorage.h"
+#include "EditorPicking.h"
+#include "LevelEditJournal.h"
+#include "LevelSave.h"
+#include "LevelHotReload.h"
+#include "LevelManager.h"
+#include "LevelPreload.h"
+#include "GameObjectMemory.h"
+#include "Tilemap.h"
 #include "Interface.h"
 #include "Renderer.h"
 #include "Button.h"
 #include "SAsset.h"
 #include "Text.h"
+#include "Profiler.h"
+#include "Metrics.h"
+#include "InputRecorder.h"
+#include "TimerService.h"
+#include "JobSystem.h"
+#include "FrameAllocator.h"
 //---------------------
 
 // includes indepentent from engine class
@@ -35,6 +51,7 @@
 #include "Interpolate.h"
 #include "PlayerStart.h"
 #include "Animation.h"
+#include "SpriteAnimator.h"
 //---------------------
 
 // VoodooEngine is a complete engine framework for making a 2D game
@@ -63,12 +80,17 @@
 //
 // UPDATE 
 // - Update function with deltatime
+// - Update components batched by type and phase (pre-physics, physics, post-physics, late)
+// - Job system with work stealing worker threads, parallel for, job counters and dependencies
 // 
 // TIMER
 // - Timer countdown with function pointer callback when finished
+// - Timer service using a hierarchical timing wheel (O(1) schedule/cancel, repeating timers, callbacks with context)
 // 
 // SPAWN/DELETE GAMEOBJECTS 
 // - Creating gameobjects dynamically during gameplay using base gameobject class
+// - Transform hierarchy, attached components follow their parent (world locations updated once per phase for dirty transforms only)
+// - Optional archetype entity storage (contiguous transform/sprite/collider arrays indexed by entity handle)
 // 
 // INTERFACES
 // - IRender
@@ -79,12 +101,25 @@
 // LEVEL
 // - Level editor 
 // - Level loading/unloading
+// - Tilemap layers for grid aligned static geometry (chunked rendering, collision by grid lookup, painted in the level editor)
 // 
 // TRIGGER
 // - Triggers with begin/end overlapping events
 // 
 // SAVE/LOAD
 // - Saving/loading from files
+// 
+// PROFILING
+// - Frame profiler with scoped zones, rolling frame graph in debug mode and chrome trace export
+// - Metrics registry with counters, gauges and histograms (always on), dumped to file on demand or periodically
+// 
+// HEADLESS
+// - Running the engine without window and renderer using a fixed clock and injected input
+// - Input recording to binary file and replay (deterministic benchmark runs)
+// 
+// PLATFORM
+// - Platform layer for window, renderer, textures, clock and file I/O (Win32/Direct2D or null platform)
+// - Headless core library builds on Linux with CMake
 // --------------------
 
 // Naming conventions
@@ -151,25 +186,41 @@
 #define INPUT_KEY_SHIFT_RIGHT 0xA1
 #define INPUT_KEY_CTRL_LEFT 0xA2
 #define INPUT_KEY_CTRL_RIGHT 0xA3
+#define INPUT_KEY_ESCAPE 0x1B
+#define INPUT_KEY_DELETE 0x2E
+#define INPUT_KEY_F9 0x78
+#define INPUT_KEY_F10 0x79
+
+// All input message ID's (same values as the Win32 window messages on every platform)
+#define INPUT_MESSAGE_DESTROY 0x0002
+#define INPUT_MESSAGE_SETCURSOR 0x0020
+#define INPUT_MESSAGE_KEYDOWN 0x0100
+#define INPUT_MESSAGE_KEYUP 0x0101
+#define INPUT_MESSAGE_LBUTTONDOWN 0x0201
+#define INPUT_MESSAGE_LBUTTONUP 0x0202
+#define INPUT_MESSAGE_RBUTTONDOWN 0x0204
+#define INPUT_MESSAGE_RBUTTONUP 0x0205
+
+// Max number of letters on screen printed by "ScreenPrint" (created once, letters beyond it are not printed)
+#define SCREENPRINT_MAXNUM_LETTERS 512
 
 // Window parameters information i.e. title name of application, screen size, fullscreen/border windowed etc.  
 struct SWindowParameters
 {
-	HWND HWind = nullptr;
-	WNDCLASSEX WindowClass;
-	LPCWSTR WindowTitle;
-	int ScreenResolutionWidth;
-	int ScreenResolutionHeight;
+	PlatformWindowHandle HWind = nullptr;
+	const wchar_t* WindowTitle = nullptr;
+	int ScreenResolutionWidth = 0;
+	int ScreenResolutionHeight = 0;
 	bool Fullscreen = true;
 };
 
 // Windows procedure parameters information used for input check from windows operating system
 struct SWindowsProcedureParameters
 {
-	HWND HWind;
-	UINT Message;
-	WPARAM WParam;
-	LPARAM LParam;
+	PlatformWindowHandle HWind = nullptr;
+	unsigned int Message = 0;
+	uintptr_t WParam = 0;
+	intptr_t LParam = 0;
 };
 
 // Mouse class contains all that is needed for custom mouse cursor support in the engine
@@ -194,8 +245,8 @@ public:
 	bool EngineRunning = false;
 	bool GameRunning = false;
 	SWindowParameters Window;
-	ID2D1HwndRenderTarget* Renderer = nullptr;
-	D2D1_COLOR_F ClearScreenColor = { 0, 0, 0 };
+	PlatformRenderTarget* Renderer = nullptr;
+	PlatformColor ClearScreenColor = { 0, 0, 0 };
 
 	// Level editor gizmo
 	int LevelEditorGizmoSnapSize = 10;
@@ -205,15 +256,38 @@ public:
 	int ScreenHeightDefault = 1080;
 
 	// Frame rate related
-	LARGE_INTEGER StartTicks;
-	LARGE_INTEGER TicksPerSecond;
-	LARGE_INTEGER CurrentTicks;
+	int64_t StartTicks = 0;
+	int64_t TicksPerSecond = 1;
+	int64_t CurrentTicks = 0;
 	int FPS = 100;
 	int FrameTargetTime = (1000 / FPS);
 	int PreviousFrameTime = 0;
 	int TimeToWait = 0;
 	float DeltaTime = 0;
 
+	// Metrics related,
+	// if dump interval (in seconds) is above 0, a snapshot of all metrics is written to file periodically
+	float MetricsDumpInterval = 0;
+	float MetricsDumpTimer = 0;
+	const char* MetricsDumpFileName = "Metrics.txt";
+
+	// Headless mode runs the engine without a window and renderer (e.g. simulation on build servers),
+	// the game is updated with a fixed delta time (as fast as possible) 
+	// and input is injected with "InjectInput" instead of coming from the window
+	bool Headless = false;
+	float HeadlessFixedDeltaTime = 1.f / 60;
+
+	// Number of frames run since the engine started
+	uint64_t FrameNumber = 0;
+
+	// Number of job system worker threads started in "InitEngine" (see "JobSystem.h"),
+	// -1 uses one thread less than the number of cores, 0 runs all jobs on the main thread
+	int NumJobWorkerThreads = -1;
+
+	// Input recording/replay (see "StartInputRecording" and "StartInputReplay")
+	SInputRecorder InputRecorder;
+	SInputReplay InputReplay;
+
 	SWindowsProcedureParameters WinProcParams;
 
 	// Open file dialog box related, 
@@ -244,7 +318,7 @@ public:
 	std::map<int, SAssetTextureAtlas> StoredAssetTextureAtlases;
 
 	// The asset parameter struct contains variables in this order:
-	// ID2D1Bitmap* TextureAtlasComponent
+	// PlatformTexture* TextureAtlasComponent
 	// SVector TextureAtlasWidthHeight
 	// int TextureAtlasOffsetMultiplierHeight
 	// int RenderLayer
@@ -258,13 +332,44 @@ public:
 	std::vector<BitmapComponent*> StoredBitmapComponents;
 	std::vector<CollisionComponent*> StoredCollisionComponents;
 	std::vector<GameObject*> StoredGameObjects;
-	std::vector<UpdateComponent*> StoredUpdateComponents;
-
-	// Stored timer update components (exlusive for timers)
-	std::vector<UpdateComponent*> StoredTimerUpdateComponents;
+	// Transform/bitmap/collision of game objects set to be stored as entities (see "EntityStorage.h"),
+	// rendered and tested for movement collision together with the stored components above
+	SEntityStorage EntityStorage;
+	// Tilemaps of the loaded levels (also stored as game objects), rendered and tested for movement collision
+	// with the stored components above, tile types are shared by every tilemap (see "Tilemap.h")
+	std::vector<TilemapGameObject*> StoredTilemaps;
+	std::vector<STileType> TileTypes;
+	// Spatial index of stored game objects used by the level editor to pick objects (see "EditorPicking.h")
+	SEditorPicking EditorPicking;
+	// Undo/redo and journaled saves of the level opened in the level editor (see "LevelEditJournal.h")
+	SLevelEditJournal LevelEditJournal;
+	// Background save of the level opened in the level editor (see "LevelSave.h")
+	SLevelSave LevelSave;
+	// Shown in the level editor while the level is saved (empty if nothing to show)
+	wchar_t LevelSaveStatusText[LEVELSAVE_STATUS_TEXT_LENGTH] = L"";
+	// Reloads the level opened in the level editor when its file is changed (see "LevelHotReload.h")
+	SLevelHotReload LevelHotReload;
+	// Cache of loaded levels activated without touching other levels (see "LevelManager.h")
+	SLevelManager LevelManager;
+	// Background loading of the level the player is about to reach (see "LevelPreload.h")
+	SLevelPreload LevelPreload;
+	// All game update components batched by update phase and type (see "UpdateScheduler.h")
+	SUpdateScheduler UpdateScheduler;
+	// Transforms moved since the end of the last update phase, one list per job thread (see "TransformComponent.h")
+	STransformDirtyList DirtyTransforms;
+
+	// All timers (see "TimerService.h"), advanced by delta time every frame while the game is running
+	STimerService TimerService;
+
+	// Animation clips and all sprite animators (see "SpriteAnimator.h"), updated every frame while the game is running
+	SSpriteAnimatorRegistry SpriteAnimators;
 
 	// Used only for screen debug print
 	std::vector<BitmapComponent*> StoredScreenPrintTexts;
+	// Letters not printed, all "SCREENPRINT_MAXNUM_LETTERS" letters are created in "InitEngine"
+	// and returned here by "ClearScreenPrint" (all letters share the same font bitmap)
+	std::vector<BitmapComponent*> ScreenPrintLetterPool;
+	PlatformTexture* ScreenPrintFont = nullptr;
 	
 	// This keeps track of the number of console text prints have been printed
 	// (Offsets a newly printed text down a column if text in column already has been printed)
@@ -298,9 +403,13 @@ public:
 	// Variables used by direct write to display UI text, 
 	// the brushes will be created on init and be available for the remainder of the program 
 	// to any text instances
-	IDWriteTextFormat* TextFormat = nullptr;
-	ID2D1SolidColorBrush* BlackBrush = nullptr;
-	ID2D1SolidColorBrush* WhiteBrush = nullptr;
+	PlatformTextFormat* TextFormat = nullptr;
+	PlatformBrush* BlackBrush = nullptr;
+	PlatformBrush* WhiteBrush = nullptr;
+	// Used by the frame profiler graph (only rendered in debug mode)
+	PlatformBrush* ProfilerGraphBrush = nullptr;
+	// Used by all collision rects (color is set for every rect)
+	PlatformBrush* CollisionRectBrush = nullptr;
 	// Used to store all UI text for render layers using directwrite
 	std::map<int, STextParameters> StoredLevelEditorRenderLayers;
 
@@ -312,19 +421,10 @@ public:
 			return;
 		}
 
-		while (!Engine->StoredScreenPrintTexts.empty())
-		{
-			for (int i = 0; i < Engine->StoredScreenPrintTexts.size(); ++i)
-			{
-				BitmapComponent* BitmapPointer = Engine->StoredScreenPrintTexts[i];
-				Engine->StoredScreenPrintTexts.erase(std::remove(
-					Engine->StoredScreenPrintTexts.begin(),
-					Engine->StoredScreenPrintTexts.end(), BitmapPointer));
-				BitmapPointer->Bitmap->Release();
-				BitmapPointer->Bitmap = nullptr;
-				delete BitmapPointer;
-			}
-		}
+		// Letters are kept for the next print (font bitmap is kept as well)
+		Engine->ScreenPrintLetterPool.insert(Engine->ScreenPrintLetterPool.end(),
+			Engine->StoredScreenPrintTexts.begin(), Engine->StoredScreenPrintTexts.end());
+		Engine->StoredScreenPrintTexts.clear();
 
 		Engine->ScreenPrintTextColumnsPrinted = 0;
 	}
@@ -367,69 +467,109 @@ public:
 		}
 	}
 
-	static void UpdateMouseInput(VoodooEngine* Engine, UINT Message)
+	static void UpdateMouseInput(VoodooEngine* Engine, unsigned int Message)
 	{
 		switch (Message)
 		{
 		// Primary mouse button
-		case WM_LBUTTONDOWN:
+		case INPUT_MESSAGE_LBUTTONDOWN:
 			Engine->Mouse.PrimaryMousePressed = true;
-			SendInterface_Input(Engine, WM_LBUTTONDOWN, true);
+			SendInterface_Input(Engine, INPUT_MESSAGE_LBUTTONDOWN, true);
 			break;
-		case WM_LBUTTONUP:
+		case INPUT_MESSAGE_LBUTTONUP:
 			Engine->Mouse.PrimaryMousePressed = false;
-			SendInterface_Input(Engine, WM_LBUTTONUP, false);
+			SendInterface_Input(Engine, INPUT_MESSAGE_LBUTTONUP, false);
 			break;
 		// Secondary mouse button
-		case WM_RBUTTONDOWN:
+		case INPUT_MESSAGE_RBUTTONDOWN:
 			Engine->Mouse.SecondaryMousePressed = true;
-			SendInterface_Input(Engine, WM_RBUTTONDOWN, true);
+			SendInterface_Input(Engine, INPUT_MESSAGE_RBUTTONDOWN, true);
 			break;
-		case WM_RBUTTONUP:
+		case INPUT_MESSAGE_RBUTTONUP:
 			Engine->Mouse.SecondaryMousePressed = false;
-			SendInterface_Input(Engine, WM_RBUTTONUP, false);
+			SendInterface_Input(Engine, INPUT_MESSAGE_RBUTTONUP, false);
 			break;
 		}
 	};
 
-	static void UpdateKeyboardInput(VoodooEngine* Engine, UINT Message, WPARAM WParam)
+	static void UpdateKeyboardInput(VoodooEngine* Engine, unsigned int Message, uintptr_t WParam)
 	{
 		switch (Message)
 		{
-		case WM_KEYDOWN:
-			SendInterface_Input(Engine, WParam, true);
+		case INPUT_MESSAGE_KEYDOWN:
+			SendInterface_Input(Engine, (int)WParam, true);
 			break;
-		case WM_KEYUP:
-			SendInterface_Input(Engine, WParam, false);
+		case INPUT_MESSAGE_KEYUP:
+			SendInterface_Input(Engine, (int)WParam, false);
 			break;
 		default:
 			break;
 		}
 	}
 
-	inline static LRESULT CALLBACK WindowsProcedure(
-		HWND HWind, UINT Message, WPARAM WParam, LPARAM LParam)
+	// Handles an input message from the platform window (or injected input),
+	// engine keys are handled first and then the input is sent to all input interface listeners
+	static void HandleInputMessage(VoodooEngine* Engine, unsigned int Message, uintptr_t WParam)
 	{
-		// Don't use engine if not running 
-		if (!VoodooEngine::Engine->EngineRunning)
-		{
-			return DefWindowProc(HWind, Message, WParam, LParam);
-		}
+		RecordInputMessage(Engine, Message, WParam);
 
 		// Stop running engine if pressed "X" icon in top right corner or escape key
-		if (Message == WM_DESTROY || 
-			Message == WM_KEYDOWN &&
-			WParam == VK_ESCAPE)
+		if (Message == INPUT_MESSAGE_DESTROY || 
+			(Message == INPUT_MESSAGE_KEYDOWN &&
+			WParam == INPUT_KEY_ESCAPE))
 		{
-			VoodooEngine::Engine->EngineRunning = false;
+			Engine->EngineRunning = false;
 		}
 
 		// Clear screen print if visible (used for debugging)
-		if (VoodooEngine::Engine->DebugMode &&
-			Message == WM_KEYDOWN &&
-			WParam == VK_DELETE)
+		if (Engine->DebugMode &&
+			Message == INPUT_MESSAGE_KEYDOWN &&
+			WParam == INPUT_KEY_DELETE)
+		{
+			ClearScreenPrint(Engine);
+		}
+
+		// Export the frames recorded by the frame profiler (used for debugging)
+		if (Engine->DebugMode &&
+			Message == INPUT_MESSAGE_KEYDOWN &&
+			WParam == INPUT_KEY_F9)
+		{
+			ExportProfilerTraceToFile("ProfilerTrace.json");
+		}
+
+		// Write a snapshot of all metrics to file
+		if (Engine->DebugMode &&
+			Message == INPUT_MESSAGE_KEYDOWN &&
+			WParam == INPUT_KEY_F10)
 		{
-			ClearScreenPrint(VoodooEngine::Engine);
+			DumpMetricsToFile(Engine->MetricsDumpFileName);
+		}
+
+		UpdateMouseInput(Engine, Message);
+		UpdateKeyboardInput(Engine, Message, WParam);
+	}
+
+	// Inject an input as if it was sent from the window (used in headless mode, e.g. for bots and soak tests),
+	// "Message" is an input message e.g. "INPUT_MESSAGE_KEYDOWN" and "WParam" the key ID e.g. "INPUT_KEY_A"
+	static void InjectInput(VoodooEngine* Engine, unsigned int Message, uintptr_t WParam = 0)
+	{
+		if (!Engine ||
+			!Engine->EngineRunning)
+		{
+			return;
+		}
+
+		HandleInputMessage(Engine, Message, WParam);
+	}
+
+#ifdef VOODOOENGINE_PLATFORM_WIN32
+	inline static LRESULT CALLBACK WindowsProcedure(
+		HWND HWind, UINT Message, WPARAM WParam, LPARAM LParam)
+	{
+		// Don't use engine if not running 
+		if (!VoodooEngine::Engine->EngineRunning)
+		{
+			return DefWindowProc(HWind, Message, WParam, LParam);
 		}
 
 		VoodooEngine::Engine->WinProcParams.HWind = HWind;
@@ -437,11 +577,10 @@ public:
 		VoodooEngine::Engine->WinProcParams.WParam = WParam;
 		VoodooEngine::Engine->WinProcParams.LParam = LParam;
 
-		UpdateMouseInput(VoodooEngine::Engine, Message);
-		UpdateKeyboardInput(VoodooEngine::Engine, Message, WParam);
+		HandleInputMessage(VoodooEngine::Engine, Message, WParam);
 
 		// Hides system mouse cursor since engine is using custom icon for cursor
-		if (Message == WM_SETCURSOR &&
+		if (Message == INPUT_MESSAGE_SETCURSOR &&
 			LOWORD(LParam) == HTCLIENT)
 		{
 			SetCursor(NULL);
@@ -450,6 +589,7 @@ public:
 
 		return DefWindowProc(HWind, Message, WParam, LParam);
 	};
+#endif
 
 	void SetPlayerStartObjectsVisibility(bool Show)
 	{
@@ -490,15 +630,8 @@ public:
 	void StartGame()
 	{
 		GameRunning = true;
-		for (int i = 0; i < StoredGameObjects.size(); ++i)
-		{
-			// If no default asset collision is assigned, 
-			// then disable collision when game starts
-			if (!StoredGameObjects[i]->CreateDefaultGameObjectCollisionInGame)
-			{
-				StoredGameObjects[i]->DefaultGameObjectCollision.NoCollision = true;
-			}
-		}
+		// Game objects without default asset collision have no collision while the game is running
+		SetEditorOnlyEnabled(false);
 		for (int i = 0; i < InterfaceObjects_GameState.size(); ++i)
 		{
 			InterfaceObjects_GameState[i]->InterfaceEvent_GameStart();
@@ -509,16 +642,10 @@ public:
 	void EndGame()
 	{
 		GameRunning = false;
-		for (int i = 0; i < StoredGameObjects.size(); ++i)
-		{
-			// If no default asset collision is assigned, 
-			// then enable collision when game ends 
-			// (so the asset is clickable in the editor during level edit)
-			if (!StoredGameObjects[i]->CreateDefaultGameObjectCollisionInGame)
-			{
-				StoredGameObjects[i]->DefaultGameObjectCollision.NoCollision = false;
-			}
-		}
+		// Game objects may have moved while the game was running
+		MarkEditorPickingDirty(&EditorPicking);
+		// Game objects without default asset collision are clickable again in the level editor
+		SetEditorOnlyEnabled(true);
 		for (int i = 0; i < InterfaceObjects_GameState.size(); ++i)
 		{
 			InterfaceObjects_GameState[i]->InterfaceEvent_GameEnd();
@@ -530,11 +657,40 @@ public:
 	template<class T>
 	void RemoveComponent(T* ObjectToRemove, std::vector<T*> *VectorToRemoveFrom)
 	{
+		// Nothing is removed if not found
 		VectorToRemoveFrom->erase(std::remove(
 			VectorToRemoveFrom->begin(),
-			VectorToRemoveFrom->end(), ObjectToRemove));
+			VectorToRemoveFrom->end(), ObjectToRemove), VectorToRemoveFrom->end());
 	};
 
+	// Store the transform/bitmap/default collision of a game object in the entity storage,
+	// the bitmap is copied from the already setup "GameObjectBitmap"
+	void CreateGameObjectEntity(GameObject* GameObjectToStore)
+	{
+		int ComponentMask = EntityComponent_Sprite;
+		if (GameObjectToStore->CreateDefaultGameObjectCollisionInGame)
+		{
+			ComponentMask |= EntityComponent_Collider;
+		}
+
+		SGameObjectColdData* ColdData = GameObjectToStore->GetColdData();
+		ColdData->EntityStorage = &EntityStorage;
+		ColdData->EntityHandle = CreateEntity(&EntityStorage, ComponentMask, GameObjectToStore->Location);
+
+		SEntitySprite* Sprite = GameObjectToStore->GetEntitySprite();
+		Sprite->Bitmap = GameObjectToStore->GameObjectBitmap.Bitmap;
+		Sprite->BitmapParams = GameObjectToStore->GameObjectBitmap.BitmapParams;
+
+		SEntityCollider* Collider = GameObjectToStore->GetEntityCollider();
+		if (Collider)
+		{
+			Collider->CollisionRect = GameObjectToStore->GameObjectDimensions;
+			Collider->EnableGroup = GameObjectToStore->GameObjectBitmap.BitmapParams.EnableGroup;
+			Collider->CollisionTag = GameObjectToStore->GameObjectID;
+			Collider->Owner = GameObjectToStore;
+		}
+	}
+
 	// Creates an instance game object based on class to spawn/asset ID
 	// if no valid ID is found, then no object will be created and nullptr is returned
 	// if valid ID the created object is returned
@@ -551,7 +707,9 @@ public:
 		}
 
 		StoredGameObjects.push_back(new T);
+		MarkEditorPickingDirty(&EditorPicking);
 		StoredGameObjects.back()->Location = SpawnLocation;
+		SetTransformLocation(&StoredGameObjects.back()->ObjectTransform, SpawnLocation);
 		StoredGameObjects.back()->GameObjectID = GameObjectID;
 		StoredGameObjects.back()->CreateDefaultGameObjectCollisionInGame = 
 			Iterator->second.CreateDefaultAssetCollision;
@@ -563,6 +721,22 @@ public:
 		StoredGameObjects.back()->GameObjectDimensions.Y = Iterator->second.TextureAtlasWidthHeight.Y;
 		StoredGameObjects.back()->GameObjectBitmap.BitmapParams.RenderLayer = Iterator->second.RenderLayer;
 		StoredGameObjects.back()->GameObjectBitmap.ComponentLocation = SpawnLocation;
+		StoredGameObjects.back()->GetColdData()->GameObjectClassSize = sizeof(T);
+		// Shown/hidden with the render layer of the asset (e.g. render layer hidden in the level editor)
+		StoredGameObjects.back()->GameObjectBitmap.BitmapParams.EnableGroup.RenderLayer =
+			Iterator->second.RenderLayer >= 0 && Iterator->second.RenderLayer < ENABLEMASKS_MAXNUM_RENDER_LAYERS ?
+			(int8_t)Iterator->second.RenderLayer : -1;
+
+		// Level editor selects/moves game objects through their components, so never stored as entities in editor mode
+		if (StoredGameObjects.back()->StoreAsEntity && 
+			!EditorMode)
+		{
+			CreateGameObjectEntity(StoredGameObjects.back());
+			AddMetricGauge(GetEngineMetrics()->ObjectsAlive, 1);
+			StoredGameObjects.back()->OnGameObjectCreated(SpawnLocation);
+			return (T*)StoredGameObjects.back();
+		}
+
 		StoredBitmapComponents.push_back(&StoredGameObjects.back()->GameObjectBitmap);
 
 		// If in editor mode, create a clickable collision rect for the spawned game object 
@@ -570,19 +744,23 @@ public:
 		if (EditorMode || 
 			Iterator->second.CreateDefaultAssetCollision)
 		{
-			StoredGameObjects.back()->DefaultGameObjectCollision.CollisionRect =
+			CollisionComponent* Collision = StoredGameObjects.back()->CreateDefaultGameObjectCollision();
+			Collision->CollisionRect =
 				{ Iterator->second.TextureAtlasWidthHeight.X, Iterator->second.TextureAtlasWidthHeight.Y };
-			StoredGameObjects.back()->DefaultGameObjectCollision.ComponentLocation = SpawnLocation;
-			StoredGameObjects.back()->DefaultGameObjectCollision.CollisionTag = GameObjectID;
-			StoredGameObjects.back()->DefaultGameObjectCollision.Owner = StoredGameObjects.back();
+			Collision->ComponentLocation = SpawnLocation;
+			Collision->CollisionTag = GameObjectID;
+			Collision->EnableGroup = StoredGameObjects.back()->GameObjectBitmap.BitmapParams.EnableGroup;
+			// Collision of an asset without collision in game is only used to click it in the level editor
+			Collision->EnableGroup.EditorOnly = !Iterator->second.CreateDefaultAssetCollision;
 			// Only set to render collision rect if in debug mode
 			if (DebugMode)
 			{
-				StoredGameObjects.back()->DefaultGameObjectCollision.RenderCollisionRect = true;
-				StoredGameObjects.back()->DefaultGameObjectCollision.CollisionRectColor = EditorCollisionRectColor;
+				Collision->RenderCollisionRect = true;
+				Collision->CollisionRectColor = EditorCollisionRectColor;
 			}
-			StoredCollisionComponents.push_back(&StoredGameObjects.back()->DefaultGameObjectCollision);
+			StoredCollisionComponents.push_back(Collision);
 		}
+		AddMetricGauge(GetEngineMetrics()->ObjectsAlive, 1);
 		StoredGameObjects.back()->OnGameObjectCreated(SpawnLocation);
 		return (T*)StoredGameObjects.back();
 	};
@@ -595,13 +773,24 @@ public:
 	template <class T> 
 	T* DeleteGameObject(T* ClassToDelete)
 	{		
-		RemoveComponent(&ClassToDelete->GameObjectBitmap, &this->StoredBitmapComponents);
 		RemoveComponent(ClassToDelete, &this->StoredGameObjects);
+		MarkEditorPickingDirty(&EditorPicking);
+		RemoveLevelObjectID(&LevelEditJournal, ClassToDelete);
+		RemoveCachedLevelObject(&LevelManager, ClassToDelete);
+		RemoveLevelPreloadObject(&LevelPreload, ClassToDelete);
 
-		if (EditorMode ||
-			ClassToDelete->CreateDefaultGameObjectCollisionInGame)
+		if (ClassToDelete->IsStoredAsEntity())
 		{
-			RemoveComponent(&ClassToDelete->DefaultGameObjectCollision, &this->StoredCollisionComponents);
+			DestroyEntity(ClassToDelete->ColdData->EntityStorage, ClassToDelete->ColdData->EntityHandle);
+		}
+		else
+		{
+			RemoveComponent(&ClassToDelete->GameObjectBitmap, &this->StoredBitmapComponents);
+
+			if (ClassToDelete->DefaultGameObjectCollision)
+			{
+				RemoveComponent(ClassToDelete->DefaultGameObjectCollision, &this->StoredCollisionComponents);
+			}
 		}
 
 		// Custom optional deconstructor called before delete
@@ -610,12 +799,66 @@ public:
 		// such as "GameObjectBitmap", "DefaultGameObjectCollision" etc.
 		ClassToDelete->OnGameObjectDeleted();
 		delete ClassToDelete;
+		AddMetricGauge(GetEngineMetrics()->ObjectsAlive, -1);
 		ClassToDelete = nullptr;
 		return nullptr;
 	};
 
+	// Delete many game objects at once, the stored vectors are walked once instead of once per game object
+	void DeleteGameObjects(const std::vector<GameObject*>& GameObjectsToDelete)
+	{
+		if (GameObjectsToDelete.empty())
+		{
+			return;
+		}
+
+		std::unordered_set<GameObject*> DeletedGameObjects(GameObjectsToDelete.begin(), GameObjectsToDelete.end());
+		std::unordered_set<BitmapComponent*> DeletedBitmaps;
+		std::unordered_set<CollisionComponent*> DeletedCollisions;
+		for (int i = 0; i < GameObjectsToDelete.size(); ++i)
+		{
+			DeletedBitmaps.insert(&GameObjectsToDelete[i]->GameObjectBitmap);
+			if (GameObjectsToDelete[i]->DefaultGameObjectCollision)
+			{
+				DeletedCollisions.insert(GameObjectsToDelete[i]->DefaultGameObjectCollision);
+			}
+		}
+
+		StoredGameObjects.erase(std::remove_if(StoredGameObjects.begin(), StoredGameObjects.end(),
+			[&DeletedGameObjects](GameObject* StoredObject) { return DeletedGameObjects.count(StoredObject) > 0; }),
+			StoredGameObjects.end());
+		StoredBitmapComponents.erase(std::remove_if(StoredBitmapComponents.begin(), StoredBitmapComponents.end(),
+			[&DeletedBitmaps](BitmapComponent* StoredBitmap) { return DeletedBitmaps.count(StoredBitmap) > 0; }),
+			StoredBitmapComponents.end());
+		StoredCollisionComponents.erase(std::remove_if(StoredCollisionComponents.begin(), StoredCollisionComponents.end(),
+			[&DeletedCollisions](CollisionComponent* StoredCollision) { return DeletedCollisions.count(StoredCollision) > 0; }),
+			StoredCollisionComponents.end());
+		MarkEditorPickingDirty(&EditorPicking);
+		RemoveCachedLevelObjects(&LevelManager, DeletedGameObjects);
+		RemoveLevelPreloadObjects(&LevelPreload, DeletedGameObjects);
+
+		for (int i = 0; i < GameObjectsToDelete.size(); ++i)
+		{
+			GameObject* ObjectToDelete = GameObjectsToDelete[i];
+			RemoveLevelObjectID(&LevelEditJournal, ObjectToDelete);
+
+			if (ObjectToDelete->IsStoredAsEntity())
+			{
+				DestroyEntity(ObjectToDelete->ColdData->EntityStorage, ObjectToDelete->ColdData->EntityHandle);
+			}
+
+			ObjectToDelete->OnGameObjectDeleted();
+			delete ObjectToDelete;
+			AddMetricGauge(GetEngineMetrics()->ObjectsAlive, -1);
+		}
+	};
+
 	void DeleteAllGameObjects()
 	{
+		// Cached levels are emptied at once instead of for every deleted game object
+		ResetLevelCache(&LevelManager);
+		ResetLevelPreload(this);
+
 		while (!StoredGameObjects.empty())
 		{
 			for (int i = 0; i < StoredGameObjects.size(); ++i)
@@ -630,80 +873,94 @@ public:
 		std::vector<BitmapComponent*>().swap(StoredBitmapComponents);
 		std::vector<CollisionComponent*>().swap(StoredCollisionComponents);
 		std::vector<GameObject*>().swap(StoredGameObjects);
+		DestroyAllEntities(&EntityStorage);
 	};
 
-	void SaveGameObjectsToFile(const wchar_t* FileName)
+	// Rewrite the whole level file and block until it has been written (the level editor saves through "SaveLevelFile"),
+	// returns false if the file could not be written
+	bool SaveGameObjectsToFile(const wchar_t* FileName)
 	{
-		std::ofstream File(FileName);
-		if (File.is_open())
-		{
-			for (int i = 0; i < Engine->StoredGameObjects.size(); ++i)
-			{
-				File << StoredGameObjects[i]->GameObjectID
-					<< " " << Engine->StoredGameObjects[i]->Location.X
-					<< " " << Engine->StoredGameObjects[i]->Location.Y << '\n';
-			}
-		}
-
-		File.close();
+		WaitForLevelSave(this);
+		SaveLevelAsync(this, FileName, true);
+		return WaitForLevelSave(this) == LevelSave_Succeeded;
 	}
 
-	void LoadGameObjectsFromFile(VoodooEngine* Engine,
+	// Returns false if the level file could not be read
+	bool LoadGameObjectsFromFile(VoodooEngine* Engine,
 		const wchar_t* FileName, std::vector<GameObject*>& LevelToAddGameObject, bool DeleteExistingObjectsOnLoad = true)
 	{
+		VOODOO_PROFILE_SCOPE("LoadLevel");
+
 		if (DeleteExistingObjectsOnLoad)
 		{
 			// Delete all current game objects
 			Engine->DeleteAllGameObjects();
 		}
 
-		std::fstream File(FileName);
-		if (File.is_open())
+		// Only the level opened in the level editor is journaled
+		bool EditLevel = EditorMode && DeleteExistingObjectsOnLoad;
+
+		// Journal of the previous level is saved before it is reset
+		if (EditLevel)
 		{
-			int GameObjectID = 0;
-			SVector SpawnLocation = {};
+			WaitForLevelSave(Engine);
+		}
 
-			std::string VerticalLine;
-			while (getline(File, VerticalLine))
-			{
-				std::stringstream Stream(VerticalLine);
-				std::string HorizontalLine;
-				std::vector<std::string> HorizontalLineNum;
-				while (Stream >> HorizontalLine)
-				{
-					HorizontalLineNum.push_back(HorizontalLine);
-				}
-				if (HorizontalLineNum.empty())
-				{
-					File.close();
-					return;
-				}
+		// Level file with its journal applied
+		std::vector<SLevelFileObject> LevelObjects;
+		STilemap Tilemap;
+		if (!ReadLevelFile(FileName, LevelObjects, EditLevel ? &LevelEditJournal : nullptr, &Tilemap))
+		{
+			return false;
+		}
 
-				GameObjectID = (std::stoi(HorizontalLineNum[0]));
-				SpawnLocation.X = (std::stof(HorizontalLineNum[1]));
-				SpawnLocation.Y = (std::stof(HorizontalLineNum[2]));
+		if (EditLevel)
+		{
+			WatchLevelFile(Engine, FileName);
+		}
+		else if (DeleteExistingObjectsOnLoad)
+		{
+			StopWatchingLevelFile(Engine);
+		}
+
+		for (int i = 0; i < LevelObjects.size(); ++i)
+		{
+			size_t NumGameObjects = StoredGameObjects.size();
+			FunctionPointer_LoadGameObjects(LevelObjects[i].GameObjectID, LevelObjects[i].Location, LevelToAddGameObject);
 
-				FunctionPointer_LoadGameObjects(GameObjectID, SpawnLocation, LevelToAddGameObject);
+			if (EditLevel &&
+				StoredGameObjects.size() > NumGameObjects)
+			{
+				AssignLevelObjectID(&LevelEditJournal, StoredGameObjects.back(), LevelObjects[i].LevelObjectID);
 			}
 		}
 
-		File.close();
+		if (!IsTilemapEmpty(&Tilemap))
+		{
+			CreateTilemapGameObject(Engine, &Tilemap, &LevelToAddGameObject);
+		}
+
+		return true;
 	}
 
-	void LoadLevelFromFile(VoodooEngine* Engine, 
+	bool LoadLevelFromFile(VoodooEngine* Engine, 
 		const wchar_t* FilePath, std::vector<GameObject*>& LevelToAddGameObjects)
 	{
-		LoadGameObjectsFromFile(Engine, FilePath, LevelToAddGameObjects, false);
+		return LoadGameObjectsFromFile(Engine, FilePath, LevelToAddGameObjects, false);
 	}
 
-	void SaveLevelFile()
+	// Save the opened level in the background, returns false if a save is already running
+	bool SaveLevelFile()
 	{
-		SaveGameObjectsToFile(VoodooEngine::Engine->OpenedLevelFileString.c_str());
+		return SaveLevelAsync(VoodooEngine::Engine, VoodooEngine::Engine->OpenedLevelFileString.c_str());
 	}
 };
 
 extern "C" VOODOOENGINE_API void OpenLevelFile(VoodooEngine* Engine);
 
+// Set the location of gameobjects
+extern "C" VOODOOENGINE_API void SetGameObjectLocation(GameObject* GameObjectToSet, SVector NewLocation);
+
 #include "Gizmo.h"
 
 class VoodooLevelEditor : public Object, public UpdateComponent, public IInput, public IEventNoParameters
@@ -1028,27 +1285,11 @@ public:
 	};
 	void SetGameObjectsVisibilityBasedOnRenderLayer(bool EnableRenderLayer, int RenderLayer)
 	{
-		for (int i = 0; i < VoodooEngine::Engine->StoredGameObjects.size(); ++i)
-		{
-			if (VoodooEngine::Engine->StoredGameObjects[i]->GameObjectBitmap.BitmapParams.RenderLayer ==
-				RenderLayer)
-			{
-				if (EnableRenderLayer)
-				{
-					VoodooEngine::Engine->StoredGameObjects[i]->
-						GameObjectBitmap.BitmapParams.BitmapSetToNotRender = false;
-					VoodooEngine::Engine->StoredGameObjects[i]->
-						DefaultGameObjectCollision.NoCollision = false;
-				}
-				else
-				{
-					VoodooEngine::Engine->StoredGameObjects[i]->
-						GameObjectBitmap.BitmapParams.BitmapSetToNotRender = true;
-					VoodooEngine::Engine->StoredGameObjects[i]->
-						DefaultGameObjectCollision.NoCollision = true;
-				}
-			}
-		}
+		// Game objects of the render layer are not rendered/collidable while disabled (see "EnableMasks.h")
+		SetRenderLayerEnabled(RenderLayer, EnableRenderLayer);
+
+		// Hidden game objects can no longer be picked (picking grid itself is unchanged)
+		VoodooEngine::Engine->EditorPicking.HoverCached = false;
 	};
 	void SetRenderLayerEyeIconButtonState()
 	{
@@ -1059,8 +1300,8 @@ public:
 		}
 
 		int BitmapWidth =
-			RenderLayerVisibilityEyeIconButtons.at(
-				HoveredButtonID)->ButtonBitmap.Bitmap->GetSize().width / 2;
+			GetPlatformTextureSize(RenderLayerVisibilityEyeIconButtons.at(
+				HoveredButtonID)->ButtonBitmap.Bitmap).X / 2;
 		auto Iterator = VoodooEngine::Engine->StoredLevelEditorRenderLayers.find(HoveredButtonID);
 		if (Iterator->second.TextRenderType == ETextBrushColorType::BlackBrush)
 		{
@@ -1155,15 +1396,21 @@ public:
 		switch (HoveredButtonID)
 		{
 		case TAG_LEVEL_EDITOR_BUTTON_SAVELEVEL:
-			VoodooEngine::Engine->SaveLevelFile();
-			SetButtonBitmapSourceClicked(SaveLevelButton);
-			SaveStateChanged(true);
+			if (VoodooEngine::Engine->SaveLevelFile())
+			{
+				SetButtonBitmapSourceClicked(SaveLevelButton);
+				SaveStateChanged(true);
+				LevelSaveStarted = true;
+			}
 			break;
 		case TAG_LEVEL_EDITOR_BUTTON_OPENLEVEL:
+			// Selected game objects are deleted when the level is opened
+			TransformGizmo.FullGizmoReset();
 			OpenLevelFile(VoodooEngine::Engine);
 			SaveStateChanged(false);
 			break;
 		case TAG_LEVEL_EDITOR_BUTTON_PLAYLEVEL:
+			SetTilePaintMode(false);
 			VoodooEngine::Engine->StartGame();
 			TransformGizmo.SetGizmoState(true);
 			MenuSelectedBeforeHidden = CurrentMenuTypeActivated;
@@ -1204,17 +1451,31 @@ public:
 				break;
 				// In asset browser mode, 
 				// when asset button is clicked a game object based on ID is spawned
+				// (in tile paint mode the asset is picked as the tile to paint instead)
 			case VoodooLevelEditor::AssetBrowser:
-				if (VoodooEngine::Engine->FunctionPointer_LoadGameObjects)
+				if (TilePaintMode)
+				{
+					if (VoodooEngine::Engine->StoredGameObjectIDs.count(HoveredButtonID) > 0)
+					{
+						TilePaintAssetID = HoveredButtonID;
+					}
+				}
+				else if (VoodooEngine::Engine->FunctionPointer_LoadGameObjects)
 				{
 					// When a game object is selected to spawn from asset menu,
 					// pass an empty vector since it is only used for storing gameobjects to levels, 
 					// when a level is loaded
 					std::vector<GameObject*> EmptyVector;
+					size_t NumGameObjects = VoodooEngine::Engine->StoredGameObjects.size();
 					VoodooEngine::Engine->FunctionPointer_LoadGameObjects(
 						HoveredButtonID,
 						{ ASSET_SELECTION_SPAWN_LOCATION_X, ASSET_SELECTION_SPAWN_LOCATION_Y },
 						EmptyVector);
+					if (VoodooEngine::Engine->StoredGameObjects.size() > NumGameObjects)
+					{
+						RecordLevelObjectCreated(
+							&VoodooEngine::Engine->LevelEditJournal, VoodooEngine::Engine->StoredGameObjects.back());
+					}
 					SaveStateChanged(false);
 				}
 				break;
@@ -1234,7 +1495,7 @@ public:
 	};
 	void InterfaceEvent_Input(int Input, bool Pressed)
 	{
-		if (Input == VK_TAB)
+		if (Input == INPUT_KEY_TAB)
 		{
 			if (Pressed)
 			{
@@ -1249,17 +1510,61 @@ public:
 			}
 		}
 
-		// Delete selected game object
+		// Delete all selected game objects
 		if (VoodooEngine::Engine->GameRunning == false &&
-			Input == VK_DELETE &&
-			TransformGizmo.SelectedGameObject != nullptr)
-		{
-			VoodooEngine::Engine->DeleteGameObject(TransformGizmo.SelectedGameObject);
-			TransformGizmo.SelectedGameObject = nullptr;
+			Input == INPUT_KEY_DELETE &&
+			Pressed &&
+			!TransformGizmo.SelectedGameObjects.empty())
+		{
+			// A running drag is recorded before its game objects are deleted
+			TransformGizmo.EndGizmoDrag();
+			// All deleted game objects are restored by a single undo
+			BeginLevelEdit(&VoodooEngine::Engine->LevelEditJournal);
+			for (int i = 0; i < TransformGizmo.SelectedGameObjects.size(); ++i)
+			{
+				RecordLevelObjectDeleted(&VoodooEngine::Engine->LevelEditJournal, TransformGizmo.SelectedGameObjects[i]);
+			}
+			EndLevelEdit(&VoodooEngine::Engine->LevelEditJournal);
+			// Deleted in one batch (a box selection can hold a large tile region)
+			VoodooEngine::Engine->DeleteGameObjects(TransformGizmo.SelectedGameObjects);
+			TransformGizmo.ClearSelection();
 			TransformGizmo.SetGizmoState(true);
 			SaveStateChanged(false);
 		}
 
+		if (Input == INPUT_KEY_CTRL_LEFT ||
+			Input == INPUT_KEY_CTRL_RIGHT)
+		{
+			UndoModifierHeld = Pressed;
+		}
+
+		// Undo/redo the last level edit (ctrl + z/y)
+		if (VoodooEngine::Engine->GameRunning == false &&
+			UndoModifierHeld &&
+			Pressed &&
+			(Input == INPUT_KEY_Z || Input == INPUT_KEY_Y))
+		{
+			// Selected game objects may be deleted by undo/redo
+			TransformGizmo.FullGizmoReset();
+
+			bool LevelChanged = Input == INPUT_KEY_Z ?
+				UndoLevelEdit(VoodooEngine::Engine) : RedoLevelEdit(VoodooEngine::Engine);
+			if (LevelChanged)
+			{
+				SaveStateChanged(false);
+			}
+		}
+
+		// Toggle tile paint mode (t)
+		if (VoodooEngine::Engine->GameRunning == false &&
+			Input == INPUT_KEY_T &&
+			Pressed)
+		{
+			SetTilePaintMode(!TilePaintMode);
+		}
+
+		UpdateTilePaintStroke(Input);
+
 		if (!LevelEditorVisible)
 		{
 			return;
@@ -1306,6 +1611,9 @@ public:
 		UpdateButtonCollisionCheck(RenderLayerSelectionButton);
 		UpdateButtonCollisionCheck(ViewModeSelectionButton);
 		UpdateRenderLayerEyeIconButtonsCollisionCheck();
+		UpdateLevelSaveStatus();
+		UpdateLevelHotReload(DeltaTime);
+		UpdateTilePainting();
 
 		for (int i = 0; i < CurrentStoredButtonAssets.size(); ++i)
 		{
@@ -1339,10 +1647,19 @@ private:
 	};
 
 	int HoveredButtonID = TAG_LEVEL_EDITOR_BUTTON_ID_NONE;
+	// Tile paint mode (see "Tilemap.h"), a stroke paints (left mouse button) or erases (right mouse button)
+	// every cell the mouse moves over until the button is released, undone as a single edit
+	bool TilePaintMode = false;
+	int TilePaintAssetID = -1;
+	bool TilePaintStrokeActive = false;
+	bool TileEraseStroke = false;
 	SEditorAssetPathList Asset;
 	SAssetIndex AssetIndexDisplayed;
 	std::vector<SAssetButton> CurrentStoredButtonAssets;
 	bool ChangesMadeSinceLastSave = false;
+	bool UndoModifierHeld = false;
+	// Set while the level save started by the save button has not been shown as done
+	bool LevelSaveStarted = false;
 	EMenuType MenuSelectedBeforeHidden = EMenuType::ViewMode;
 	BitmapComponent LevelEditorUITop;
 	BitmapComponent LevelEditorUIOverlay;
@@ -1368,7 +1685,7 @@ private:
 			Asset.LevelEditorButtonActivateDeactivateW140);
 		SetBitmapSourceLocationX(
 			&StopPlayButton->ButtonBitmap,
-			StopPlayButton->ButtonBitmap.Bitmap->GetSize().width / 2, 2);
+			GetPlatformTextureSize(StopPlayButton->ButtonBitmap.Bitmap).X / 2, 2);
 		SetStopPlayButtonState(EButtonState::Hidden);
 		OpenLevelButton = CreateButton(
 			VoodooEngine::Engine, OpenLevelButton, TAG_LEVEL_EDITOR_BUTTON_OPENLEVEL,
@@ -1399,6 +1716,110 @@ private:
 			TwoSided, "viewmode", { BUTTON_LOC_X_VIEWMODE, BUTTON_LOC_Y_VIEWMODE },
 			Asset.LevelEditorButtonW140);
 	}
+	// Game objects can't be selected while painting tiles
+	void SetTilePaintMode(bool Enable)
+	{
+		EndTilePaintStroke();
+		TilePaintMode = Enable;
+		TransformGizmo.FullGizmoReset();
+		TransformGizmo.SelectionEnabled = !Enable;
+	}
+	// A stroke is started by a mouse button pressed over no button and ended when that mouse button is released
+	void UpdateTilePaintStroke(int Input)
+	{
+		if (!TilePaintMode)
+		{
+			return;
+		}
+
+		if (!TilePaintStrokeActive &&
+			(Input == INPUT_MESSAGE_LBUTTONDOWN || Input == INPUT_MESSAGE_RBUTTONDOWN) &&
+			HoveredButtonID == TAG_LEVEL_EDITOR_BUTTON_ID_NONE &&
+			TilePaintAssetID >= 0)
+		{
+			BeginLevelEdit(&VoodooEngine::Engine->LevelEditJournal);
+			TilePaintStrokeActive = true;
+			TileEraseStroke = Input == INPUT_MESSAGE_RBUTTONDOWN;
+			UpdateTilePainting();
+		}
+		else if ((Input == INPUT_MESSAGE_LBUTTONUP && !TileEraseStroke) ||
+			(Input == INPUT_MESSAGE_RBUTTONUP && TileEraseStroke))
+		{
+			EndTilePaintStroke();
+		}
+	}
+	void EndTilePaintStroke()
+	{
+		if (!TilePaintStrokeActive)
+		{
+			return;
+		}
+
+		TilePaintStrokeActive = false;
+		EndLevelEdit(&VoodooEngine::Engine->LevelEditJournal);
+	}
+	// Paint/erase the cell under the mouse every frame of a stroke
+	void UpdateTilePainting()
+	{
+		if (!TilePaintStrokeActive ||
+			VoodooEngine::Engine->GameRunning)
+		{
+			return;
+		}
+
+		VoodooEngine* Engine = VoodooEngine::Engine;
+		if (PaintTile(Engine, TilePaintAssetID, Engine->Mouse.Location, TileEraseStroke))
+		{
+			SaveStateChanged(false);
+		}
+	}
+	// Reload the opened level if it has been changed outside of the level editor (not while playing the level)
+	void UpdateLevelHotReload(float DeltaTime)
+	{
+		if (VoodooEngine::Engine->GameRunning ||
+			!HasLevelFileChanged(VoodooEngine::Engine, DeltaTime))
+		{
+			return;
+		}
+
+		// Selected game objects may be deleted by the reload
+		TransformGizmo.FullGizmoReset();
+		if (HotReloadLevel(VoodooEngine::Engine))
+		{
+			// Level is now the same as its file
+			SaveStateChanged(true);
+		}
+	}
+	// Show the progress of the level save started by the save button, and its result once done
+	void UpdateLevelSaveStatus()
+	{
+		if (!LevelSaveStarted)
+		{
+			return;
+		}
+
+		VoodooEngine* Engine = VoodooEngine::Engine;
+		if (IsLevelSaving(Engine))
+		{
+			swprintf(Engine->LevelSaveStatusText, LEVELSAVE_STATUS_TEXT_LENGTH, L"saving %d%%", (int)(GetLevelSaveProgress(Engine) * 100));
+			return;
+		}
+
+		LevelSaveStarted = false;
+		if (Engine->LevelSave.State == LevelSave_Failed)
+		{
+			swprintf(Engine->LevelSaveStatusText, LEVELSAVE_STATUS_TEXT_LENGTH, L"level save failed");
+			SaveStateChanged(false);
+			return;
+		}
+
+		Engine->LevelSaveStatusText[0] = L'\0';
+		// Edits made while the level was saved are saved by the next save
+		if (!Engine->LevelEditJournal.UnsavedOperations.empty())
+		{
+			SaveStateChanged(false);
+		}
+	}
 	void SaveStateChanged(bool Saved)
 	{
 		if (Saved)
@@ -1523,8 +1944,14 @@ private:
 	};
 };
 
-// Print debug text to screen
-extern "C" VOODOOENGINE_API void ScreenPrint(VoodooEngine* Engine, std::string DebugText);
+// Set the location of the engine mouse cursor 
+// (called every frame with the system cursor location, in headless mode this is the only way to move the cursor)
+extern "C" VOODOOENGINE_API void SetCustomMouseCursorLocation(VoodooEngine* Engine, SVector NewLocation);
+
+// Print debug text to screen (never allocates, letters are taken from a pool created in "InitEngine"
+// and returned by "ClearScreenPrint", nothing is printed once all "SCREENPRINT_MAXNUM_LETTERS" are on screen),
+// in headless mode the letters are set up without a font bitmap
+extern "C" VOODOOENGINE_API void ScreenPrint(VoodooEngine* Engine, const char* DebugText);
 
 // Set the frame rate limit per second
 extern "C" VOODOOENGINE_API void SetFPSLimit(VoodooEngine* Engine, float FPSLimit);
@@ -1540,23 +1967,29 @@ extern "C" VOODOOENGINE_API void PauseGame(VoodooEngine* Engine, bool SetGamePau
 #include "Character.h"
 #include "Trigger.h"
 #include "LoadLevelTrigger.h"
+#include "TilemapGameObject.h"
 //---------------------
 
 // Setup the application window and renderer
 extern "C" VOODOOENGINE_API void InitWindowAndRenderer(
 	VoodooEngine* Engine,
-	LPCWSTR WindowTitle,
-	WNDPROC WindowsProcedure,
+	const wchar_t* WindowTitle,
+	PlatformWindowProcedure WindowsProcedure,
 	int WindowResolutionWidth,
 	int WindowResolutionHeight,
 	bool WindowFullScreen = true);
 
 // Setup the engine 
 extern "C" VOODOOENGINE_API void InitEngine(VoodooEngine* Engine, SRenderLayerNames RenderLayerNames);
+// Setup the engine in headless mode (no window and no renderer, "InitWindowAndRenderer" is not called),
+// level editor is not available in headless mode
+extern "C" VOODOOENGINE_API void InitEngineHeadless(
+	VoodooEngine* Engine, SRenderLayerNames RenderLayerNames, float FixedDeltaTime = 1.f / 60);
 // Run the engine game loop
 extern "C" VOODOOENGINE_API void RunEngine(VoodooEngine* Engine);
 
-// Activate a desired level
+// Activate a desired level, every other game object is disabled
+// (levels of the level cache are activated without touching their game objects, see "ActivateCachedLevel")
 extern "C" VOODOOENGINE_API	void ActivateLevel(
 	VoodooEngine* Engine,
 	std::vector<GameObject*>& Level,
@@ -1567,9 +2000,6 @@ extern "C" VOODOOENGINE_API	void ActivateLevel(
 	int PlayerStartDownID = -1,
 	BitmapComponent* LevelBackground = nullptr);
 
-// Set the location of gameobjects
-extern "C" VOODOOENGINE_API void SetGameObjectLocation(GameObject* GameObjectToSet, SVector NewLocation);
-
 // Set the location of gameobjects that inherit from character class
 extern "C" VOODOOENGINE_API void SetCharacterLocation(Character* CharacterToSet, SVector NewLocation);
 
@@ -1577,8 +2007,21 @@ extern "C" VOODOOENGINE_API void SetCharacterLocation(Character* CharacterToSet,
 // Built in collision detection is provided,
 // if you set up the "QuadCollisionParameters" struct within "MovementComponent".
 // Returns new movement location
+// (colliders are tested in parallel on the job system in batches of "MOVEMENT_COLLISION_BATCHSIZE")
+#define MOVEMENT_COLLISION_BATCHSIZE 1024
 extern "C" VOODOOENGINE_API SVector AddMovementInput(VoodooEngine* Engine, Character* CharacterToAddMovement);
 
+// Add movement input to many characters at once (e.g. all NPCs), same movement as "AddMovementInput"
+// but done in two phases so the characters can be moved in parallel on the job system:
+// 1. The new location of every character is computed from the collider locations at the start of the call
+// 2. All new locations are written in the order of the characters
+// (characters never collide with a location another character moves to during the same call,
+// so the result is the same regardless of the number of threads).
+// The new locations are also written to "NewLocations" if set (must have room for "NumCharacters")
+#define MOVEMENT_CHARACTER_BATCHSIZE 32
+extern "C" VOODOOENGINE_API void AddMovementInputToCharacters(
+	VoodooEngine* Engine, Character** Characters, int NumCharacters, SVector* NewLocations = nullptr);
+
 // Add AI movement to game object 
 // (will inherit from "MovementComponent" and make use of "AddMovementInput" function)
 // If using AI then this will add movement to AI character using the assigned movement direction,
@@ -1,3 +1,9 @@
 #pragma once
 
+// Functions are exported when building the engine as a DLL on Windows,
+// static/non-Windows builds (e.g. the headless core library) don't need any export attribute
+#if defined(_WIN32) && !defined(VOODOOENGINE_STATIC)
 #define VOODOOENGINE_API __declspec(dllexport)
+#else
+#define VOODOOENGINE_API
+#endif
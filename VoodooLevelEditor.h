@@ -374,15 +374,21 @@ public:
 				{
 					VoodooEngine::Engine->StoredGameObjects[i]->
 						GameObjectBitmap.BitmapParams.BitmapSetToNotRender = false;
-					VoodooEngine::Engine->StoredGameObjects[i]->
-						DefaultGameObjectCollision.NoCollision = false;
+					if (VoodooEngine::Engine->StoredGameObjects[i]->DefaultGameObjectCollision)
+					{
+						VoodooEngine::Engine->StoredGameObjects[i]->
+							DefaultGameObjectCollision->NoCollision = false;
+					}
 				}
 				else
 				{
 					VoodooEngine::Engine->StoredGameObjects[i]->
 						GameObjectBitmap.BitmapParams.BitmapSetToNotRender = true;
-					VoodooEngine::Engine->StoredGameObjects[i]->
-						DefaultGameObjectCollision.NoCollision = true;
+					if (VoodooEngine::Engine->StoredGameObjects[i]->DefaultGameObjectCollision)
+					{
+						VoodooEngine::Engine->StoredGameObjects[i]->
+							DefaultGameObjectCollision->NoCollision = true;
+					}
 				}
 			}
 		}